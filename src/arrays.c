@@ -6,7 +6,7 @@
  * E-mail: almeriopamplona@gmail.com                                          *
  ******************************************************************************
  * Creation date    : 07.02.2021                                              *
- * Modification date: 07.02.2021                                              *
+ * Modification date: 19.10.2026                                              *
  ******************************************************************************
  * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
  *                                                                            *
@@ -14,14 +14,37 @@
  *                                                                            *
  * The full license is in the file LICENSE, distributed with this software.   *
  ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
 
-#include "arrays.h" 
+#include "arrays.h"
+#include "parallel.h"
 
 #include <stdio.h>  /*input and output variable manipulation*/
 #include <stdlib.h> /*address and memory manipulation*/
 #include <string.h> /*string manipulation*/
 #include <math.h>   /*mathematical functions*/
 
+/******************************************************************************
+ * AUXILIARY FUNCTIONS                                                        *
+ ******************************************************************************/
+
+/* cache-line aligned storage, so the chunks of two threads share no line */
+static void *allocLines(const integer bytes)
+{
+    const integer size = ((bytes + CACHE_LINE - 1) / CACHE_LINE) * CACHE_LINE;
+
+    void *self = aligned_alloc(CACHE_LINE, size > 0 ? size : CACHE_LINE);
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the array\n");
+        exit (EXIT_FAILURE);
+    }
+
+    return self;
+}
+
 /******************************************************************************
  * CONSTRUCTORS AND DISTRUCTORS                                               *
  ******************************************************************************/
@@ -32,15 +55,18 @@ intArray* makeIntArray(const integer size)
 { 
     intArray *self = (intArray *) malloc(sizeof(intArray));
 
-    self->size = size;
-    self->arr  = (integer *) malloc(size * sizeof(integer));
-
     if (self == NULL) 
     {
         printf ("ERROR: no free space in RAM to allocate the object\n");
         exit (EXIT_FAILURE);
     }
 
+    self->size = size;
+    self->arr  = (integer *) allocLines(size * sizeof(integer));
+
+    /*first touch with the schedule of the kernels*/
+    zeroIntArray(self, size);
+
     return self;
 }
 
@@ -48,15 +74,17 @@ int32Array* makeInt32Array(const integer size)
 {
     int32Array *self = (int32Array *) malloc(sizeof(int32Array));
 
-    self->size = size;
-    self->arr  = (integer32 *) malloc(size * sizeof(integer32));
-
     if (self == NULL) 
     {
         printf ("ERROR: no free space in RAM to allocate the object\n");
         exit (EXIT_FAILURE);
     }
 
+    self->size = size;
+    self->arr  = (integer32 *) allocLines(size * sizeof(integer32));
+
+    zeroInt32Array(self, size);
+
     return self;
 }
 
@@ -64,15 +92,17 @@ realArray* makeRealArray(const integer size)
 {
     realArray *self = (realArray *) malloc(sizeof(realArray));
 
-    self->size = size;
-    self->arr  = (real *) malloc(size * sizeof(real));
-
     if (self == NULL) 
     {
         printf ("ERROR: no free space in RAM to allocate the object\n");
         exit (EXIT_FAILURE);
     }
 
+    self->size = size;
+    self->arr  = (real *) allocLines(size * sizeof(real));
+
+    zeroRealArray(self, size);
+
     return self;
 }
 
@@ -98,6 +128,7 @@ void zeroIntArray(intArray *a, const integer size)
 {
     register integer i;
 
+    #pragma omp parallel for PARALLEL_CHUNKS(size, sizeof(integer))
     for (i = 0; i < size; i++)
     {
         a->arr[i] = 0;
@@ -106,7 +137,9 @@ void zeroIntArray(intArray *a, const integer size)
 
 void zeroInt32Array(int32Array *a, const integer size)
 {
-    register integer32 i;
+    register integer i;
+
+    #pragma omp parallel for PARALLEL_CHUNKS(size, sizeof(integer32))
     for (i = 0; i < size; i++)
     {
         a->arr[i] = 0;
@@ -116,6 +149,8 @@ void zeroInt32Array(int32Array *a, const integer size)
 void zeroRealArray(realArray *a, const integer size)
 {
     register integer i;
+
+    #pragma omp parallel for PARALLEL_CHUNKS(size, sizeof(real))
     for (i = 0; i < size; i++)
     {
         a->arr[i] = 0.0;
@@ -130,6 +165,7 @@ void linspace (realArray *a, real start, real stop, const integer size)
 
         register integer i;
 
+        #pragma omp parallel for PARALLEL_CHUNKS(size, sizeof(real))
         for (i = 0; i < size; i++) 
         {
             a->arr[i] = start + i * da; 
@@ -150,7 +186,8 @@ void linspace2 (realArray *a, real start, real stop, real dx)
     da2  = (stop - start) / size;     
 
     register integer i;
-    
+
+    #pragma omp parallel for PARALLEL_CHUNKS(size, sizeof(real))
     for ( i = 0; i < size; i++) 
     {
         a->arr[i] = start + i * da2;
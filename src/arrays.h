@@ -6,7 +6,7 @@
  * E-mail: almeriopamplona@gmail.com                                          *
  ******************************************************************************
  * Creation date    : 29.01.2021                                              *
- * Modification date: 07.01.2021                                              *
+ * Modification date: 19.10.2026                                              *
  ******************************************************************************
  * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
  *                                                                            *
@@ -18,6 +18,7 @@
  *                                                                            *
  * In the present script, array objects are created.Furthermore, functions    *
  * for creation, destruction, operations and manipulation are defined.        *
+ * The zero and sequence loops are threaded as described in parallel.h.       *
  *                                                                            *
  ******************************************************************************/
 
@@ -65,7 +66,8 @@ typedef struct realArray
  * Function:    makeIntXXArray                                                *
  * -------------------------------------------------------------------------- *
  * description: creates an array with integer elements and allocates it in a  *
- *              memory space.                                                 *
+ *              memory space aligned to cache lines, zeroed with the static   *
+ *              schedule of the threaded kernels (first touch).               *
  * -------------------------------------------------------------------------- *
  * input:  intXXArray *a    // pointer to some integerXX array a              *
  *         integer   size   // total number of elements                       *
@@ -79,7 +81,7 @@ realArray*  makeRealArray(const integer size);
 /******************************************************************************
  * Function:    freeIntArray                                                  *
  * -------------------------------------------------------------------------- *
- * description: deallocates an array with integer elements from the memory.   *                                                 *
+ * description: deallocates an array with integer elements from the memory.   *
  * -------------------------------------------------------------------------- *
  * input:  intArray *a      // pointer to some integer array a                *
  * -------------------------------------------------------------------------- *
@@ -92,7 +94,7 @@ void freeRealArray(realArray *self);
 /******************************************************************************
  * Function:    zeroIntArray                                                  *
  * -------------------------------------------------------------------------- *
- * description: set n elements with zero value into an integer array.         *                                                 *
+ * description: set n elements with zero value into an integer array.         *
  * -------------------------------------------------------------------------- *
  * input:  intArray *a      // pointer to some integer array a                *
  *         integer   size   // total number of elements                       *
@@ -100,7 +102,7 @@ void freeRealArray(realArray *self);
  * output: a                // integer array whose elements have zero value   *
  ******************************************************************************/
 void zeroIntArray(intArray *a, const integer size);
-void zeroIn32tArray(int32Array *a, const integer size);
+void zeroInt32Array(int32Array *a, const integer size);
 void zeroRealArray(realArray *a, const integer size);
 
 /******************************************************************************
@@ -119,7 +121,7 @@ void zeroRealArray(realArray *a, const integer size);
 void linspace (realArray *a, real start, real stop, const integer size); 
 
 /******************************************************************************
- * Function:    linspace2                                                      *
+ * Function:    linspace2                                                     *
  * -------------------------------------------------------------------------- *
  * description: creates a sequence of real elements, with predefined start    *
  *              and points, and also a specific size.                         *
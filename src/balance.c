@@ -0,0 +1,626 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                               BALANCE.C                                    *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "balance.h"
+#include "particles.h"
+
+#include <stdio.h>  /*input and output variable manipulation*/
+#include <stdlib.h> /*address and memory manipulation*/
+#include <math.h>   /*minimum and maximum*/
+
+/******************************************************************************
+ * AUXILIARY FUNCTIONS                                                        *
+ ******************************************************************************/
+
+#define BALANCE_BINS 256  // cost histogram bins per rank along the cut axis
+
+typedef struct balanceTask
+{
+    rangeFunction f;       /* loop body                                       */
+    void         *arg;     /* argument of the loop body                       */
+    integer       begin;   /* first particle of the part                      */
+    integer       end;     /* one past the last particle of the part          */
+
+} balanceTask;
+
+static void *allocate(const integer size)
+{
+    void *self = malloc(size > 0 ? size : 1);
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to balance the load\n");
+        exit (EXIT_FAILURE);
+    }
+
+    return self;
+}
+
+/* spreads the 32 low bits of x to the even bits of the result */
+static inline integer spread2(integer x)
+{
+    x &= 0xFFFFFFFFUL;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFUL;
+    x = (x | (x <<  8)) & 0x00FF00FF00FF00FFUL;
+    x = (x | (x <<  4)) & 0x0F0F0F0F0F0F0F0FUL;
+    x = (x | (x <<  2)) & 0x3333333333333333UL;
+    x = (x | (x <<  1)) & 0x5555555555555555UL;
+
+    return x;
+}
+
+/* spreads the 21 low bits of x to every third bit of the result */
+static inline integer spread3(integer x)
+{
+    x &= 0x1FFFFFUL;
+    x = (x | (x << 32)) & 0x001F00000000FFFFUL;
+    x = (x | (x << 16)) & 0x001F0000FF0000FFUL;
+    x = (x | (x <<  8)) & 0x100F00F00F00F00FUL;
+    x = (x | (x <<  4)) & 0x10C30C30C30C30C3UL;
+    x = (x | (x <<  2)) & 0x1249249249249249UL;
+
+    return x;
+}
+
+/* interleaves the coordinates, the first axis being the most significant */
+static inline integer interleave(const integer q[3], const integer dim)
+{
+    return (dim == 2) ? (spread2(q[0]) << 1) | spread2(q[1])
+                      : (spread3(q[0]) << 2) | (spread3(q[1]) << 1) |
+                         spread3(q[2]);
+}
+
+/* Skilling's transform of the coordinates into the transposed Hilbert index */
+static inline void hilbertTranspose(integer q[3], const integer dim,
+    const integer bits)
+{
+    register integer i;
+
+    const integer top = 1UL << (bits - 1);
+    integer p, t, b;
+
+    for (b = top; b > 1; b >>= 1)
+    {
+        p = b - 1;
+
+        for (i = 0; i < dim; i++)
+        {
+            if (q[i] & b)
+            {
+                q[0] ^= p;
+            }
+            else
+            {
+                t = (q[0] ^ q[i]) & p;
+                q[0] ^= t;
+                q[i] ^= t;
+            }
+        }
+    }
+
+    for (i = 1; i < dim; i++)
+    {
+        q[i] ^= q[i - 1];
+    }
+
+    t = 0;
+
+    for (b = top; b > 1; b >>= 1)
+    {
+        if (q[dim - 1] & b)
+        {
+            t ^= b - 1;
+        }
+    }
+
+    for (i = 0; i < dim; i++)
+    {
+        q[i] ^= t;
+    }
+}
+
+/* stable LSD radix sort of the indices by key, 8 bits per pass */
+static void radixSort(const integer *key, integer *perm, integer *tmp,
+    const integer n)
+{
+    register integer k;
+
+    integer count[257];
+    integer shift;
+
+    for (k = 0; k < n; k++)
+    {
+        perm[k] = k;
+    }
+
+    for (shift = 0; shift < 64; shift += 8)
+    {
+        for (k = 0; k <= 256; k++)
+        {
+            count[k] = 0;
+        }
+
+        for (k = 0; k < n; k++)
+        {
+            count[((key[k] >> shift) & 0xFF) + 1]++;
+        }
+
+        /*a pass where every key has the same digit changes nothing*/
+        if (n == 0 || count[((key[0] >> shift) & 0xFF) + 1] == n)
+        {
+            continue;
+        }
+
+        for (k = 0; k < 256; k++)
+        {
+            count[k + 1] += count[k];
+        }
+
+        for (k = 0; k < n; k++)
+        {
+            const integer i = perm[k];
+
+            tmp[count[(key[i] >> shift) & 0xFF]++] = i;
+        }
+
+        for (k = 0; k < n; k++)
+        {
+            perm[k] = tmp[k];
+        }
+    }
+}
+
+/* stable counting sort of perm by material, so material ranges are kept */
+static void groupByMaterial(const integer *idMat, integer *perm, integer *tmp,
+    const integer n)
+{
+    register integer k;
+
+    integer nmat = 0;
+
+    for (k = 0; k < n; k++)
+    {
+        nmat = (idMat[k] + 1 > nmat) ? idMat[k] + 1 : nmat;
+    }
+
+    if (nmat <= 1)
+    {
+        return;
+    }
+
+    integer *count = (integer *) allocate((nmat + 1) * sizeof(integer));
+
+    for (k = 0; k <= nmat; k++)
+    {
+        count[k] = 0;
+    }
+
+    for (k = 0; k < n; k++)
+    {
+        count[idMat[k] + 1]++;
+    }
+
+    for (k = 0; k < nmat; k++)
+    {
+        count[k + 1] += count[k];
+    }
+
+    for (k = 0; k < n; k++)
+    {
+        tmp[count[idMat[perm[k]]]++] = perm[k];
+    }
+
+    for (k = 0; k < n; k++)
+    {
+        perm[k] = tmp[k];
+    }
+
+    free(count);
+}
+
+/* max part cost / mean part cost - 1 */
+static real partImbalance(const real *cost, const integer *start,
+    const integer nparts)
+{
+    register integer p, i;
+
+    real total = 0.0;
+    real peak  = 0.0;
+
+    for (p = 0; p < nparts; p++)
+    {
+        real sum = 0.0;
+
+        for (i = start[p]; i < start[p + 1]; i++)
+        {
+            sum += cost[i];
+        }
+
+        total += sum;
+        peak   = (sum > peak) ? sum : peak;
+    }
+
+    return (total > 0.0) ? peak * nparts / total - 1.0 : 0.0;
+}
+
+/* cuts [0, np) into nparts ranges of about equal cost */
+static void splitCurve(loadBalancer *lb, const real *cost, const integer np)
+{
+    register integer i, p;
+
+    real total = 0.0;
+    real sum   = 0.0;
+
+    for (i = 0; i < np; i++)
+    {
+        total += cost[i];
+    }
+
+    lb->start[0] = 0;
+    p = 1;
+
+    for (i = 0; i < np && p < lb->nparts; i++)
+    {
+        sum += cost[i];
+
+        while (p < lb->nparts && sum >= total * p / lb->nparts)
+        {
+            lb->start[p++] = i + 1;
+        }
+    }
+
+    for (; p <= lb->nparts; p++)
+    {
+        lb->start[p] = np;
+    }
+}
+
+static void runPart(void *arg)
+{
+    balanceTask *task = (balanceTask *) arg;
+
+    task->f(task->arg, task->begin, task->end);
+}
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+loadBalancer *makeLoadBalancer(const integer nparts, const curveMode curve)
+{
+    register integer p;
+
+    loadBalancer *self = (loadBalancer *) allocate(sizeof(loadBalancer));
+
+    if (nparts == 0)
+    {
+        printf ("ERROR: the load balancer needs at least one part\n");
+        exit (EXIT_FAILURE);
+    }
+
+    self->curve     = curve;
+    self->nparts    = nparts;
+    self->start     = (integer *) allocate((nparts + 1) * sizeof(integer));
+    self->threshold = 0.1;
+    self->disorder  = 0.05;
+    self->interval  = 10;
+    self->age       = 0;
+    self->imbalance = 0.0;
+    self->nsplits   = 0;
+    self->nsorts    = 0;
+
+    for (p = 0; p <= nparts; p++)
+    {
+        self->start[p] = 0;
+    }
+
+    return self;
+}
+
+void freeLoadBalancer(loadBalancer *self)
+{
+    free(self->start);
+    free(self);
+}
+
+/******************************************************************************
+ * SPACE-FILLING CURVE                                                        *
+ ******************************************************************************/
+
+void curveKeys(fluid *particles, parameters *par, const curveMode curve,
+    integer *key)
+{
+    register integer i, d;
+
+    const integer dim  = (par->dim == 3) ? 3 : 2;
+    const integer bits = (dim == 3) ? 21 : 31;
+    const real   *x[3] = {particles->r.x, particles->r.y, particles->r.z};
+
+    real min[3] = {0.0, 0.0, 0.0};
+    real max[3] = {0.0, 0.0, 0.0};
+
+    if (par->np == 0)
+    {
+        return;
+    }
+
+    for (d = 0; d < dim; d++)
+    {
+        min[d] = max[d] = x[d][0];
+
+        for (i = 1; i < par->np; i++)
+        {
+            min[d] = fmin(min[d], x[d][i]);
+            max[d] = fmax(max[d], x[d][i]);
+        }
+    }
+
+    /*one scale for every axis, so the curve cells are squares or cubes*/
+    real extent = 0.0;
+
+    for (d = 0; d < dim; d++)
+    {
+        extent = fmax(extent, max[d] - min[d]);
+    }
+
+    const real scale = (extent > 0.0) ?
+        ((real) ((1UL << bits) - 1)) / extent : 0.0;
+
+    for (i = 0; i < par->np; i++)
+    {
+        integer q[3] = {0, 0, 0};
+
+        for (d = 0; d < dim; d++)
+        {
+            q[d] = (integer) ((x[d][i] - min[d]) * scale);
+        }
+
+        if (curve == CURVE_HILBERT)
+        {
+            hilbertTranspose(q, dim, bits);
+        }
+
+        key[i] = interleave(q, dim);
+    }
+}
+
+/******************************************************************************
+ * LOAD BALANCING                                                             *
+ ******************************************************************************/
+
+void measureCost(fluid *particles, parameters *par, real *cost)
+{
+    register integer i;
+
+    for (i = 0; i < par->np; i++)
+    {
+        cost[i] = 1.0 + (real) particles->nNeighL.arr[i];
+    }
+}
+
+boolean balanceParticles(loadBalancer *lb, fluid *particles, parameters *par,
+    real *cost)
+{
+    register integer i;
+
+    const integer np    = par->np;
+    const boolean first = (lb->start[lb->nparts] != np) ? true : false;
+    boolean moved       = false;
+
+    lb->age++;
+
+    /*a change of the number of particles invalidates the parts*/
+    if (!first)
+    {
+        lb->imbalance = partImbalance(cost, lb->start, lb->nparts);
+
+        if (lb->imbalance <= lb->threshold)
+        {
+            return false;
+        }
+    }
+
+    if (first || lb->age >= lb->interval)
+    {
+        integer *key  = (integer *) allocate(np * sizeof(integer));
+        integer *perm = (integer *) allocate(np * sizeof(integer));
+        integer *tmp  = (integer *) allocate(np * sizeof(integer));
+        integer  out  = 0;
+
+        curveKeys(particles, par, lb->curve, key);
+
+        for (i = 1; i < np; i++)
+        {
+            const integer *m = particles->idMat.arr;
+
+            out += (m[i] < m[i - 1] || (m[i] == m[i - 1] &&
+                key[i] < key[i - 1])) ? 1 : 0;
+        }
+
+        if (np > 0 && out > lb->disorder * np)
+        {
+            radixSort(key, perm, tmp, np);
+            groupByMaterial(particles->idMat.arr, perm, tmp, np);
+            permuteFluid(particles, perm, np);
+
+            real *sorted = (real *) allocate(np * sizeof(real));
+
+            for (i = 0; i < np; i++)
+            {
+                sorted[i] = cost[perm[i]];
+            }
+
+            for (i = 0; i < np; i++)
+            {
+                cost[i] = sorted[i];
+            }
+
+            free(sorted);
+
+            moved   = true;
+            lb->age = 0;
+            lb->nsorts++;
+        }
+
+        free(key);
+        free(perm);
+        free(tmp);
+    }
+
+    splitCurve(lb, cost, np);
+
+    lb->imbalance = partImbalance(cost, lb->start, lb->nparts);
+    lb->nsplits++;
+
+    return moved;
+}
+
+void runBalanced(loadBalancer *lb, threadPool *pool, rangeFunction f,
+    void *arg)
+{
+    register integer p;
+
+    balanceTask *task = (balanceTask *) allocate(lb->nparts *
+        sizeof(balanceTask));
+
+    for (p = 0; p < lb->nparts; p++)
+    {
+        task[p].f     = f;
+        task[p].arg   = arg;
+        task[p].begin = lb->start[p];
+        task[p].end   = lb->start[p + 1];
+
+        spawnTask(pool, runPart, task + p);
+    }
+
+    waitTasks(pool);
+
+    free(task);
+}
+
+#if defined(CMPS_USE_MPI)
+
+boolean balanceDomain(loadBalancer *lb, domain *dom, fluid *particles,
+    parameters *par, const real *cost)
+{
+    register integer i, k;
+
+    const integer size  = (integer) dom->size;
+    const integer nbins = BALANCE_BINS * size;
+    const real   *x     = (dom->axis == 0) ? particles->r.x :
+                          (dom->axis == 1) ? particles->r.y : particles->r.z;
+    const real    lo    = dom->cuts[0];
+    const real    hi    = dom->cuts[size];
+
+    real local = 0.0;
+    real sum, peak;
+
+    if (lb->nparts != size)
+    {
+        printf ("ERROR: the load balancer needs one part per rank\n");
+        exit (EXIT_FAILURE);
+    }
+
+    for (i = 0; i < par->np; i++)
+    {
+        local += cost[i];
+    }
+
+    MPI_Allreduce(&local, &sum,  1, MPI_DOUBLE, MPI_SUM, dom->comm);
+    MPI_Allreduce(&local, &peak, 1, MPI_DOUBLE, MPI_MAX, dom->comm);
+
+    lb->imbalance = (sum > 0.0) ? peak * size / sum - 1.0 : 0.0;
+    lb->age++;
+
+    if (lb->imbalance <= lb->threshold || lb->age < lb->interval)
+    {
+        return false;
+    }
+
+    /*global histogram of the cost along the cut axis*/
+    real *hist  = (real *) allocate(2 * nbins * sizeof(real));
+    real *total = hist + nbins;
+    real *cuts  = (real *) allocate((size + 1) * sizeof(real));
+
+    const real width = (hi - lo) / nbins;
+
+    for (k = 0; k < nbins; k++)
+    {
+        hist[k] = 0.0;
+    }
+
+    for (i = 0; i < par->np; i++)
+    {
+        const real    t = (x[i] - lo) / width;
+        const integer b = (t <= 0.0) ? 0 :
+                          (t >= nbins) ? nbins - 1 : (integer) t;
+
+        hist[b] += cost[i];
+    }
+
+    MPI_Allreduce(hist, total, (int) nbins, MPI_DOUBLE, MPI_SUM, dom->comm);
+
+    /*inner faces at the cost quantiles, interpolated inside the bins*/
+    real acc = 0.0;
+
+    cuts[0]    = lo;
+    cuts[size] = hi;
+    k          = 1;
+
+    for (i = 0; i < nbins && k < size; i++)
+    {
+        while (k < size && acc + total[i] >= sum * k / size)
+        {
+            const real f = (total[i] > 0.0) ?
+                (sum * k / size - acc) / total[i] : 0.0;
+
+            cuts[k++] = lo + (i + f) * width;
+        }
+
+        acc += total[i];
+    }
+
+    for (; k < size; k++)
+    {
+        cuts[k] = hi;
+    }
+
+    /*every slab must hold the halo: push the faces up, then down*/
+    for (k = 1; k < size; k++)
+    {
+        cuts[k] = fmax(cuts[k], cuts[k - 1] + dom->halo);
+    }
+
+    for (k = size - 1; k > 0; k--)
+    {
+        cuts[k] = fmin(cuts[k], cuts[k + 1] - dom->halo);
+    }
+
+    setDomainCuts(dom, cuts);
+
+    free(hist);
+    free(cuts);
+
+    lb->age = 0;
+    lb->nsplits++;
+
+    return true;
+}
+
+#endif
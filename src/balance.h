@@ -0,0 +1,209 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                               BALANCE.H                                    *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Dynamic load balancing on a space-filling curve. The particles are kept in *
+ * the order of a Morton or Hilbert curve through the bounding box, and the   *
+ * curve is cut into parts of equal cost, one per thread, where the cost of a *
+ * particle is measured, e.g. by its number of neighbours. Parts along the    *
+ * curve are compact in space, so the neighbours of a part stay mostly in     *
+ * the same part and in the same cache lines.                                 *
+ *                                                                            *
+ * Moving the fluid fields is the expensive part, so it is amortised:         *
+ *   - nothing is done while the imbalance, max part cost / mean part cost    *
+ *     - 1, stays below the threshold;                                        *
+ *   - above it, the cuts are first moved on the current order, which only    *
+ *     needs a prefix sum of the costs;                                       *
+ *   - the particles are sorted again along the curve only when a large       *
+ *     enough fraction of them is out of curve order and at least interval    *
+ *     calls have passed since the last sort.                                 *
+ *                                                                            *
+ * With MPI the ranks own slabs of the domain, so the curve between ranks is  *
+ * the cut axis itself: balanceDomain moves the slab faces to the quantiles   *
+ * of the cost along that axis and the particles follow on the next           *
+ * migrateParticles.                                                          *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __BALANCE_H__
+#define __BALANCE_H__
+
+#include "structures.h"
+#include "threadpool.h"
+
+#if defined(CMPS_USE_MPI)
+#include "domain.h"
+#endif
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+typedef enum curveMode
+{
+    CURVE_MORTON  = 0,   /* bit interleaving: cheap keys, jumps between quads */
+    CURVE_HILBERT = 1    /* no jumps: more compact parts, costlier keys       */
+
+} curveMode;
+
+typedef struct loadBalancer
+{
+    curveMode  curve;       /* space-filling curve                            */
+    integer    nparts;      /* number of parts, threads or ranks              */
+    integer   *start;       /* particle range of each part, nparts + 1 values */
+    real       threshold;   /* repartition above this imbalance               */
+    real       disorder;    /* sort above this fraction of particles out of   */
+                            /* curve order                                    */
+    integer    interval;    /* minimum number of calls between two sorts      */
+    integer    age;         /* calls since the last sort or slab move         */
+    real       imbalance;   /* imbalance measured by the last call            */
+    integer    nsplits;     /* number of repartitions done                    */
+    integer    nsorts;      /* number of sorts of the fluid done              */
+
+} loadBalancer;
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    makeLoadBalancer                                              *
+ * -------------------------------------------------------------------------- *
+ * description: creates a balancer of nparts parts with the default values:   *
+ *              threshold 0.1, disorder 0.05 and interval 10. The parts are   *
+ *              empty until the first balanceParticles.                       *
+ * -------------------------------------------------------------------------- *
+ * input:  const integer   nparts   // number of parts, threads or ranks      *
+ *         const curveMode curve    // space-filling curve                    *
+ * -------------------------------------------------------------------------- *
+ * output: loadBalancer *self                                                 *
+ ******************************************************************************/
+loadBalancer *makeLoadBalancer(const integer nparts, const curveMode curve);
+
+/******************************************************************************
+ * Function:    freeLoadBalancer                                              *
+ * -------------------------------------------------------------------------- *
+ * description: deallocates the balancer.                                     *
+ * -------------------------------------------------------------------------- *
+ * input:  loadBalancer *self   // load balancer                              *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void freeLoadBalancer(loadBalancer *self);
+
+/******************************************************************************
+ * SPACE-FILLING CURVE                                                        *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    curveKeys                                                     *
+ * -------------------------------------------------------------------------- *
+ * description: computes the position of every particle on the curve through  *
+ *              the bounding box of the particles, with 31 bits per axis in   *
+ *              2D and 21 bits per axis in 3D.                                *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid          *particles   // fluid particles                     *
+ *         parameters     *par         // simulation parameters               *
+ *         const curveMode curve       // space-filling curve                 *
+ *         integer        *key         // np keys, on output                  *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void curveKeys(fluid *particles, parameters *par, const curveMode curve,
+    integer *key);
+
+/******************************************************************************
+ * LOAD BALANCING                                                             *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    measureCost                                                   *
+ * -------------------------------------------------------------------------- *
+ * description: estimates the cost of every particle as one plus its number   *
+ *              of neighbours with the large radius, which most stages loop   *
+ *              over. Measured times may be used instead.                     *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ *         real       *cost        // np costs, on output                     *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void measureCost(fluid *particles, parameters *par, real *cost);
+
+/******************************************************************************
+ * Function:    balanceParticles                                              *
+ * -------------------------------------------------------------------------- *
+ * description: measures the imbalance of the parts and, above the            *
+ *              threshold, cuts the curve again into parts of equal cost.     *
+ *              The fluid is sorted along the curve only when it is too far   *
+ *              out of curve order and the interval has passed; the cost      *
+ *              array is then reordered with it and the neighbour lists must  *
+ *              be searched again.                                            *
+ * -------------------------------------------------------------------------- *
+ * input:  loadBalancer *lb          // load balancer                         *
+ *         fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // simulation parameters                 *
+ *         real         *cost        // np particle costs                     *
+ * -------------------------------------------------------------------------- *
+ * output: boolean                   // true if the particles were moved      *
+ ******************************************************************************/
+boolean balanceParticles(loadBalancer *lb, fluid *particles, parameters *par,
+    real *cost);
+
+/******************************************************************************
+ * Function:    runBalanced                                                   *
+ * -------------------------------------------------------------------------- *
+ * description: calls f(arg, begin, end) once per part, as tasks of the pool, *
+ *              and returns when all parts are done.                          *
+ * -------------------------------------------------------------------------- *
+ * input:  loadBalancer *lb     // load balancer                              *
+ *         threadPool   *pool   // thread pool                                *
+ *         rangeFunction f      // loop body over a range                     *
+ *         void         *arg    // argument of the loop body                  *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void runBalanced(loadBalancer *lb, threadPool *pool, rangeFunction f,
+    void *arg);
+
+#if defined(CMPS_USE_MPI)
+
+/******************************************************************************
+ * Function:    balanceDomain                                                 *
+ * -------------------------------------------------------------------------- *
+ * description: measures the imbalance of the costs of the ranks and, above   *
+ *              the threshold and after the interval, moves the inner slab    *
+ *              faces to the quantiles of the cost along the cut axis,        *
+ *              keeping every slab at least the halo thick. The particles     *
+ *              move on the next migrateParticles. lb->nparts must be the     *
+ *              number of ranks.                                              *
+ * -------------------------------------------------------------------------- *
+ * input:  loadBalancer *lb          // load balancer                         *
+ *         domain       *dom         // domain decomposition                  *
+ *         fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // simulation parameters                 *
+ *         const real   *cost        // costs of the owned particles          *
+ * -------------------------------------------------------------------------- *
+ * output: boolean                   // true if the slab faces were moved     *
+ ******************************************************************************/
+boolean balanceDomain(loadBalancer *lb, domain *dom, fluid *particles,
+    parameters *par, const real *cost);
+
+#endif
+
+#endif
@@ -0,0 +1,297 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                              COLLISION.C                                   *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "collision.h"
+#include "cmps_include.h"
+
+#include <stdio.h>  /*input and output variable manipulation*/
+#include <stdlib.h> /*address and memory manipulation*/
+
+#define COLLISION_BLOCK 64  // neighbours per batch of pair coefficients
+
+/******************************************************************************
+ * AUXILIARY FUNCTIONS                                                        *
+ ******************************************************************************/
+
+typedef struct collisionArgs
+{
+    fluid               *particles;   /* fluid particles                      */
+    const unsigned char *candidate;   /* particles with a close neighbour     */
+    integer              np;          /* particles with a slot in du          */
+    real                 dist2;       /* squared collision distance           */
+    real                 coef;        /* (1 + e) / 2                          */
+
+} collisionArgs;
+
+/* s[k] = (1 + e)/2 (uj - ui).(rj - ri) / |rj - ri|^2 for the approaching    */
+/* pairs (i, i < j < np) closer than the collision distance, 0 otherwise     */
+static inline void pairCoefficients(collisionArgs *a, const integer i,
+    const integer *nb, const integer n, real *s, const integer dim)
+{
+    register integer k = 0;
+
+    const fluid *f  = a->particles;
+    const real   xi = f->r.x[i], yi = f->r.y[i];
+    const real   zi = (dim == 3) ? f->r.z[i] : 0.0;
+    const real   ui = f->u.x[i], vi = f->u.y[i];
+    const real   wi = (dim == 3) ? f->u.z[i] : 0.0;
+
+#if CMPS_X86_INSTR_SET >= CMPS_X86_AVX2_VERSION
+    const __m256d vxi   = _mm256_set1_pd(xi);
+    const __m256d vyi   = _mm256_set1_pd(yi);
+    const __m256d vzi   = _mm256_set1_pd(zi);
+    const __m256d vui   = _mm256_set1_pd(ui);
+    const __m256d vvi   = _mm256_set1_pd(vi);
+    const __m256d vwi   = _mm256_set1_pd(wi);
+    const __m256d vd2   = _mm256_set1_pd(a->dist2);
+    const __m256d vcoef = _mm256_set1_pd(a->coef);
+    const __m256d zero  = _mm256_setzero_pd();
+    const __m256i vi64  = _mm256_set1_epi64x((long long) i);
+    const __m256i vnp   = _mm256_set1_epi64x((long long) a->np);
+
+    for (; k + 4 <= n; k += 4)
+    {
+        const __m256i idx = _mm256_loadu_si256((const __m256i *) (nb + k));
+
+        const __m256d dx = _mm256_sub_pd(
+            _mm256_i64gather_pd(f->r.x, idx, 8), vxi);
+        const __m256d dy = _mm256_sub_pd(
+            _mm256_i64gather_pd(f->r.y, idx, 8), vyi);
+        const __m256d du = _mm256_sub_pd(
+            _mm256_i64gather_pd(f->u.x, idx, 8), vui);
+        const __m256d dv = _mm256_sub_pd(
+            _mm256_i64gather_pd(f->u.y, idx, 8), vvi);
+
+        __m256d d2  = _mm256_add_pd(_mm256_mul_pd(dx, dx),
+            _mm256_mul_pd(dy, dy));
+        __m256d dot = _mm256_add_pd(_mm256_mul_pd(du, dx),
+            _mm256_mul_pd(dv, dy));
+
+        if (dim == 3)
+        {
+            const __m256d dz = _mm256_sub_pd(
+                _mm256_i64gather_pd(f->r.z, idx, 8), vzi);
+            const __m256d dw = _mm256_sub_pd(
+                _mm256_i64gather_pd(f->u.z, idx, 8), vwi);
+
+            d2  = _mm256_add_pd(d2,  _mm256_mul_pd(dz, dz));
+            dot = _mm256_add_pd(dot, _mm256_mul_pd(dw, dz));
+        }
+
+        /*the masked lanes drop the division by a zero distance*/
+        const __m256d mask = _mm256_and_pd(
+            _mm256_and_pd(_mm256_cmp_pd(d2, vd2, _CMP_LT_OQ),
+                          _mm256_cmp_pd(dot, zero, _CMP_LT_OQ)),
+            _mm256_castsi256_pd(_mm256_and_si256(
+                _mm256_cmpgt_epi64(idx, vi64),
+                _mm256_cmpgt_epi64(vnp, idx))));
+
+        _mm256_storeu_pd(s + k, _mm256_and_pd(mask,
+            _mm256_div_pd(_mm256_mul_pd(vcoef, dot), d2)));
+    }
+#endif
+
+    #pragma omp simd
+    for (integer m = k; m < n; m++)
+    {
+        const integer j  = nb[m];
+        const real    dx = f->r.x[j] - xi;
+        const real    dy = f->r.y[j] - yi;
+        const real    dz = (dim == 3) ? f->r.z[j] - zi : 0.0;
+        const real    d2 = dx*dx + dy*dy + dz*dz;
+        const real    dot = (f->u.x[j] - ui) * dx + (f->u.y[j] - vi) * dy +
+            ((dim == 3) ? (f->u.z[j] - wi) * dz : 0.0);
+
+        s[m] = (j > i && j < a->np && d2 < a->dist2 && dot < 0.0) ?
+            a->coef * dot / d2 : 0.0;
+    }
+}
+
+static inline void collisionKernelDim(void *arg, const integer i,
+    scatterTarget *acc, const integer dim)
+{
+    register integer k;
+
+    collisionArgs *a = (collisionArgs *) arg;
+    const fluid   *f = a->particles;
+
+    if (!a->candidate[i])
+    {
+        return;
+    }
+
+    const integer *nb = f->neighS.arr + f->startS.arr[i];
+    const integer  n  = f->nNeighS.arr[i];
+
+    real s[COLLISION_BLOCK];
+    real gx = 0.0, gy = 0.0, gz = 0.0;
+    integer b;
+
+    for (b = 0; b < n; b += COLLISION_BLOCK)
+    {
+        const integer len = (n - b < COLLISION_BLOCK) ? n - b :
+            COLLISION_BLOCK;
+
+        pairCoefficients(a, i, nb + b, len, s, dim);
+
+        /*collisions are rare: the impulses are applied pair by pair*/
+        for (k = 0; k < len; k++)
+        {
+            if (s[k] == 0.0)
+            {
+                continue;
+            }
+
+            const integer j  = nb[b + k];
+            const real    dx = s[k] * (f->r.x[j] - f->r.x[i]);
+            const real    dy = s[k] * (f->r.y[j] - f->r.y[i]);
+
+            gx += dx;
+            gy += dy;
+            scatterAdd(acc, 0, j, -dx);
+            scatterAdd(acc, 1, j, -dy);
+
+            if (dim == 3)
+            {
+                const real dz = s[k] * (f->r.z[j] - f->r.z[i]);
+
+                gz += dz;
+                scatterAdd(acc, 2, j, -dz);
+            }
+        }
+    }
+
+    if (gx != 0.0 || gy != 0.0 || gz != 0.0)
+    {
+        scatterAdd(acc, 0, i, gx);
+        scatterAdd(acc, 1, i, gy);
+
+        if (dim == 3)
+        {
+            scatterAdd(acc, 2, i, gz);
+        }
+    }
+}
+
+static void collisionKernel2D(void *arg, const integer i, scatterTarget *acc)
+{
+    collisionKernelDim(arg, i, acc, 2);
+}
+
+static void collisionKernel3D(void *arg, const integer i, scatterTarget *acc)
+{
+    collisionKernelDim(arg, i, acc, 3);
+}
+
+/******************************************************************************
+ * COLLISION STAGE                                                            *
+ ******************************************************************************/
+
+void initCollisionConfig(collisionConfig *cfg)
+{
+    cfg->distance    = 0.5;
+    cfg->restitution = 0.2;
+    cfg->skin        = 0.1;
+}
+
+integer collideParticles(fluid *particles, parameters *par,
+    collisionConfig *cfg, scatterPlan *plan, cellGrid *grid)
+{
+    register long i;
+
+    const long    np    = (long) par->np;
+    const integer dim   = (par->dim == 3) ? 3 : 2;
+    const real    reach = (cfg->distance + cfg->skin) * par->l0;
+
+    unsigned char *candidate = (unsigned char *) malloc(np > 0 ? np : 1);
+
+    if (candidate == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the collisions\n");
+        exit (EXIT_FAILURE);
+    }
+
+    integer ncand = 0;
+
+    /*contiguous pass over the cached distances*/
+    #pragma omp parallel for schedule(static) reduction(+:ncand)
+    for (i = 0; i < np; i++)
+    {
+        register integer k;
+
+        const real   *d = particles->dNeighS.x + particles->startS.arr[i];
+        const integer n = particles->nNeighS.arr[i];
+
+        real dMin = reach;
+
+        for (k = 0; k < n; k++)
+        {
+            dMin = (d[k] < dMin) ? d[k] : dMin;
+        }
+
+        candidate[i] = (dMin < reach) ? 1 : 0;
+        ncand       += candidate[i];
+    }
+
+    if (ncand == 0)
+    {
+        free(candidate);
+        return 0;
+    }
+
+    collisionArgs args;
+
+    args.particles = particles;
+    args.candidate = candidate;
+    args.np        = par->np;
+    args.dist2     = cfg->distance * par->l0 * cfg->distance * par->l0;
+    args.coef      = 0.5 * (1.0 + cfg->restitution);
+
+    real *du[3] = {particles->du.x, particles->du.y, particles->du.z};
+
+    #pragma omp parallel for schedule(static)
+    for (i = 0; i < np; i++)
+    {
+        du[0][i] = 0.0;
+        du[1][i] = 0.0;
+        du[2][i] = 0.0;
+    }
+
+    scatterParticles(plan, grid, par, &particles->nNeighS,
+        (dim == 3) ? collisionKernel3D : collisionKernel2D, &args, du, dim);
+
+    #pragma omp parallel for schedule(static)
+    for (i = 0; i < np; i++)
+    {
+        particles->u.x[i] += du[0][i];
+        particles->u.y[i] += du[1][i];
+        particles->r.x[i] += par->dt * du[0][i];
+        particles->r.y[i] += par->dt * du[1][i];
+
+        if (dim == 3)
+        {
+            particles->u.z[i] += du[2][i];
+            particles->r.z[i] += par->dt * du[2][i];
+        }
+    }
+
+    free(candidate);
+
+    return ncand;
+}
@@ -0,0 +1,91 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                              COLLISION.H                                   *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Particle collision model: two particles closer than the collision          *
+ * distance and approaching each other exchange momentum along the line of    *
+ * their centres, as equal masses with a restitution coefficient, which keeps *
+ * the particles from clustering. The stage runs after the prediction, on the *
+ * small-radius neighbour lists of the last search.                           *
+ *                                                                            *
+ * Most particles have no neighbour that close, so a first contiguous pass    *
+ * over the cached distances marks the candidates, and only these visit       *
+ * their neighbours. A pair is handled once, by its lower index, and the      *
+ * impulses go to both particles through the scatter accumulation. The pair   *
+ * loop gathers the positions and velocities of four neighbours at a time     *
+ * with AVX2 when available, and is a vectorisable loop otherwise.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __COLLISION_H__
+#define __COLLISION_H__
+
+#include "structures.h"
+#include "neighbours.h"
+#include "scatter.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+typedef struct collisionConfig
+{
+    real distance;      /* collision distance, in l0                          */
+    real restitution;   /* restitution coefficient of a collision             */
+    real skin;          /* motion allowed since the search, in l0             */
+
+} collisionConfig;
+
+/******************************************************************************
+ * COLLISION STAGE                                                            *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    initCollisionConfig                                           *
+ * -------------------------------------------------------------------------- *
+ * description: fills the configuration with the default values: collision    *
+ *              distance 0.5 l0, restitution 0.2 and skin 0.1 l0.             *
+ * -------------------------------------------------------------------------- *
+ * input:  collisionConfig *cfg   // collision configuration                  *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void initCollisionConfig(collisionConfig *cfg);
+
+/******************************************************************************
+ * Function:    collideParticles                                              *
+ * -------------------------------------------------------------------------- *
+ * description: applies the collisions of the pairs of the small-radius       *
+ *              lists: the velocity changes are accumulated into du, then     *
+ *              u += du and r += dt du. Particles whose cached neighbour      *
+ *              distances all exceed distance + skin are skipped; the skin    *
+ *              must cover the motion since the search. Pairs with a ghost    *
+ *              neighbour j >= par->np are skipped, since du has no slot for  *
+ *              it.                                                           *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid           *particles   // fluid particles                    *
+ *         parameters      *par         // simulation parameters              *
+ *         collisionConfig *cfg         // collision configuration            *
+ *         scatterPlan     *plan        // scatter accumulation of du         *
+ *         cellGrid        *grid        // cell grid of the lists, or NULL    *
+ * -------------------------------------------------------------------------- *
+ * output: integer                      // number of candidate particles      *
+ ******************************************************************************/
+integer collideParticles(fluid *particles, parameters *par,
+    collisionConfig *cfg, scatterPlan *plan, cellGrid *grid);
+
+#endif
@@ -0,0 +1,705 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                                DOMAIN.C                                    *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "domain.h"
+
+#if defined(CMPS_USE_MPI)
+
+#include "particles.h"
+#include "pressure.h"
+
+#include <stdio.h>  /*input and output variable manipulation*/
+#include <stdlib.h> /*address and memory manipulation*/
+#include <math.h>   /*square root*/
+
+/******************************************************************************
+ * AUXILIARY FUNCTIONS                                                        *
+ ******************************************************************************/
+
+#define GHOST_FIELDS    15  // r, rn, u, un, pressure, temperature, pndS
+#define MIGRATE_FIELDS  31  // every field of a particle but the neighbours
+
+static void *growArray(void *old, const integer size)
+{
+    void *self = realloc(old, size > 0 ? size : 1);
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the domain\n");
+        exit (EXIT_FAILURE);
+    }
+
+    return self;
+}
+
+static void reserveBuffer(domain *dom, const integer n)
+{
+    if (n > dom->bufferCap)
+    {
+        dom->bufferCap = (integer) (GROWTH * n);
+        dom->buffer    = (real *) growArray(dom->buffer,
+            dom->bufferCap * sizeof(real));
+    }
+}
+
+static void checkCuts(domain *dom)
+{
+    register int k;
+
+    for (k = 0; k < dom->size; k++)
+    {
+        if (dom->cuts[k+1] - dom->cuts[k] < dom->halo)
+        {
+            printf ("ERROR: slab %d of the domain is thinner than reL\n", k);
+            exit (EXIT_FAILURE);
+        }
+    }
+}
+
+static real *axisOf(domain *dom, vector3D *v)
+{
+    return (dom->axis == 0) ? v->x : (dom->axis == 1) ? v->y : v->z;
+}
+
+static int ownerOf(domain *dom, const real x)
+{
+    int lo = 0;
+    int hi = dom->size - 1;
+
+    /*positions beyond the outer faces stay on the end ranks*/
+    while (lo < hi)
+    {
+        const int mid = (lo + hi + 1) / 2;
+
+        if (x >= dom->cuts[mid])
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid - 1;
+        }
+    }
+
+    return lo;
+}
+
+static void ghostFields(fluid *particles, real *fields[GHOST_FIELDS])
+{
+    real *list[GHOST_FIELDS] = {
+        particles->r.x,  particles->r.y,  particles->r.z,
+        particles->rn.x, particles->rn.y, particles->rn.z,
+        particles->u.x,  particles->u.y,  particles->u.z,
+        particles->un.x, particles->un.y, particles->un.z,
+        particles->pressure.x, particles->temperature.x, particles->pndS.x};
+
+    for (int k = 0; k < GHOST_FIELDS; k++)
+    {
+        fields[k] = list[k];
+    }
+}
+
+/* sends the fields of sendIdx to both sides; the ghosts from the left rank */
+/* are stored from nLocal and those from the right rank after them          */
+static void haloExchange(domain *dom, real *const *fields,
+    const integer nfields)
+{
+    register integer i, f;
+
+    const integer nSend  = dom->nSend[DOMAIN_LEFT] + dom->nSend[DOMAIN_RIGHT];
+    const integer nRecv  = dom->nRecv[DOMAIN_LEFT] + dom->nRecv[DOMAIN_RIGHT];
+    const integer offset[2] = {dom->nLocal,
+                               dom->nLocal + dom->nRecv[DOMAIN_LEFT]};
+
+    reserveBuffer(dom, (nSend + nRecv) * nfields);
+
+    for (int side = 0; side < 2; side++)
+    {
+        const int other = 1 - side;
+        real *send = dom->buffer;
+        real *recv = dom->buffer + dom->nSend[side] * nfields;
+
+        for (i = 0; i < dom->nSend[side]; i++)
+        {
+            const integer j = dom->sendIdx[side][i];
+
+            for (f = 0; f < nfields; f++)
+            {
+                send[i*nfields + f] = fields[f][j];
+            }
+        }
+
+        /*what goes to one side comes from the other one*/
+        MPI_Sendrecv(send, (int) (dom->nSend[side] * nfields), MPI_DOUBLE,
+            dom->peer[side], 0, recv, (int) (dom->nRecv[other] * nfields),
+            MPI_DOUBLE, dom->peer[other], 0, dom->comm, MPI_STATUS_IGNORE);
+
+        for (i = 0; i < dom->nRecv[other]; i++)
+        {
+            for (f = 0; f < nfields; f++)
+            {
+                fields[f][offset[other] + i] = recv[i*nfields + f];
+            }
+        }
+    }
+}
+
+static void packParticle(fluid *particles, const integer i, real *buf)
+{
+    integer k = 0;
+
+    buf[k++] = (real) particles->index.arr[i];
+    buf[k++] = (real) particles->idMat.arr[i];
+    buf[k++] = (real) particles->type.arr[i];
+    buf[k++] = particles->pressure.x[i];
+    buf[k++] = particles->pressurek0.x[i];
+    buf[k++] = particles->temperature.x[i];
+    buf[k++] = particles->pndS.x[i];
+    buf[k++] = particles->pndL.x[i];
+    buf[k++] = particles->pndB.x[i];
+    buf[k++] = particles->pndMat.x[i];
+
+    vector3D *v[7] = {&particles->r, &particles->rn, &particles->dr,
+        &particles->u, &particles->un, &particles->du, &particles->normal};
+
+    for (int f = 0; f < 7; f++)
+    {
+        buf[k++] = v[f]->x[i];
+        buf[k++] = v[f]->y[i];
+        buf[k++] = v[f]->z[i];
+    }
+}
+
+static void unpackParticle(fluid *particles, const integer i, const real *buf)
+{
+    integer k = 0;
+
+    particles->index.arr[i]     = (integer) buf[k++];
+    particles->idMat.arr[i]     = (integer) buf[k++];
+    particles->type.arr[i]      = (integer) buf[k++];
+    particles->pressure.x[i]    = buf[k++];
+    particles->pressurek0.x[i]  = buf[k++];
+    particles->temperature.x[i] = buf[k++];
+    particles->pndS.x[i]        = buf[k++];
+    particles->pndL.x[i]        = buf[k++];
+    particles->pndB.x[i]        = buf[k++];
+    particles->pndMat.x[i]      = buf[k++];
+
+    vector3D *v[7] = {&particles->r, &particles->rn, &particles->dr,
+        &particles->u, &particles->un, &particles->du, &particles->normal};
+
+    for (int f = 0; f < 7; f++)
+    {
+        v[f]->x[i] = buf[k++];
+        v[f]->y[i] = buf[k++];
+        v[f]->z[i] = buf[k++];
+    }
+}
+
+static real dotDomain(domain *dom, const real *a, const real *b,
+    const integer n)
+{
+    register integer i;
+
+    real local = 0.0;
+    real total;
+
+    for (i = 0; i < n; i++)
+    {
+        local += a[i] * b[i];
+    }
+
+    MPI_Allreduce(&local, &total, 1, MPI_DOUBLE, MPI_SUM, dom->comm);
+
+    return total;
+}
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+domain *makeDomain(MPI_Comm comm, const integer axis, const real min,
+    const real max, const real halo)
+{
+    register int k;
+
+    domain *self = (domain *) malloc(sizeof(domain));
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the object\n");
+        exit (EXIT_FAILURE);
+    }
+
+    if (axis > 2)
+    {
+        printf ("ERROR: the cut axis of the domain must be 0, 1 or 2\n");
+        exit (EXIT_FAILURE);
+    }
+
+    MPI_Comm_rank(comm, &self->rank);
+    MPI_Comm_size(comm, &self->size);
+
+    self->comm = comm;
+    self->axis = axis;
+    self->halo = halo;
+    self->cuts = (real *) growArray(NULL, (self->size + 1) * sizeof(real));
+
+    for (k = 0; k <= self->size; k++)
+    {
+        self->cuts[k] = min + (max - min) * k / self->size;
+    }
+
+    self->peer[DOMAIN_LEFT]  = (self->rank > 0) ?
+        self->rank - 1 : MPI_PROC_NULL;
+    self->peer[DOMAIN_RIGHT] = (self->rank < self->size - 1) ?
+        self->rank + 1 : MPI_PROC_NULL;
+
+    for (k = 0; k < 2; k++)
+    {
+        self->sendIdx[k] = NULL;
+        self->nSend[k]   = 0;
+        self->sendCap[k] = 0;
+        self->nRecv[k]   = 0;
+    }
+
+    self->nLocal    = 0;
+    self->nGhost    = 0;
+    self->buffer    = NULL;
+    self->bufferCap = 0;
+
+    checkCuts(self);
+
+    return self;
+}
+
+void freeDomain(domain *self)
+{
+    free(self->cuts);
+    free(self->sendIdx[DOMAIN_LEFT]);
+    free(self->sendIdx[DOMAIN_RIGHT]);
+    free(self->buffer);
+    free(self);
+}
+
+/******************************************************************************
+ * PARTICLE DISTRIBUTION                                                      *
+ ******************************************************************************/
+
+void setDomainCuts(domain *dom, const real *cuts)
+{
+    register int k;
+
+    for (k = 0; k <= dom->size; k++)
+    {
+        dom->cuts[k] = cuts[k];
+    }
+
+    checkCuts(dom);
+}
+
+integer migrateParticles(domain *dom, fluid *particles, parameters *par)
+{
+    register integer i;
+    register int     k;
+
+    const integer n = par->np;
+    const real   *x = axisOf(dom, &particles->r);
+
+    int *sendCount = (int *) growArray(NULL, 4 * dom->size * sizeof(int));
+    int *recvCount = sendCount + dom->size;
+    int *sendDispl = sendCount + 2 * dom->size;
+    int *recvDispl = sendCount + 3 * dom->size;
+    int *dest      = (int *) growArray(NULL, n * sizeof(int));
+
+    for (k = 0; k < dom->size; k++)
+    {
+        sendCount[k] = 0;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        dest[i] = ownerOf(dom, x[i]);
+
+        if (dest[i] != dom->rank)
+        {
+            sendCount[dest[i]]++;
+        }
+    }
+
+    MPI_Alltoall(sendCount, 1, MPI_INT, recvCount, 1, MPI_INT, dom->comm);
+
+    integer nSend = 0;
+    integer nRecv = 0;
+
+    for (k = 0; k < dom->size; k++)
+    {
+        sendDispl[k] = (int) nSend;
+        recvDispl[k] = (int) nRecv;
+        nSend += sendCount[k];
+        nRecv += recvCount[k];
+    }
+
+    reserveBuffer(dom, (nSend + nRecv) * MIGRATE_FIELDS);
+
+    real *send = dom->buffer;
+    real *recv = dom->buffer + nSend * MIGRATE_FIELDS;
+    real  kept[MIGRATE_FIELDS];
+    integer nKept = 0;
+
+    /*pack the leaving particles by rank and compact the others in order*/
+    for (i = 0; i < n; i++)
+    {
+        if (dest[i] != dom->rank)
+        {
+            packParticle(particles, i,
+                send + (sendDispl[dest[i]]++) * MIGRATE_FIELDS);
+        }
+        else if (nKept++ != i)
+        {
+            packParticle(particles, i, kept);
+            unpackParticle(particles, nKept - 1, kept);
+        }
+    }
+
+    for (k = 0; k < dom->size; k++)
+    {
+        sendDispl[k] = (sendDispl[k] - sendCount[k]) * MIGRATE_FIELDS;
+        sendCount[k] *= MIGRATE_FIELDS;
+        recvDispl[k] *= MIGRATE_FIELDS;
+        recvCount[k] *= MIGRATE_FIELDS;
+    }
+
+    MPI_Alltoallv(send, sendCount, sendDispl, MPI_DOUBLE, recv, recvCount,
+        recvDispl, MPI_DOUBLE, dom->comm);
+
+    reserveFluid(particles, nKept + nRecv);
+
+    for (i = 0; i < nRecv; i++)
+    {
+        unpackParticle(particles, nKept + i, recv + i * MIGRATE_FIELDS);
+    }
+
+    dom->nLocal = nKept + nRecv;
+    dom->nGhost = 0;
+    dom->nSend[DOMAIN_LEFT]  = dom->nSend[DOMAIN_RIGHT] = 0;
+    dom->nRecv[DOMAIN_LEFT]  = dom->nRecv[DOMAIN_RIGHT] = 0;
+    par->np     = dom->nLocal;
+
+    free(sendCount);
+    free(dest);
+
+    return nRecv;
+}
+
+void exchangeGhosts(domain *dom, fluid *particles, parameters *par)
+{
+    register integer i;
+
+    const real lo = dom->cuts[dom->rank]     + dom->halo;
+    const real hi = dom->cuts[dom->rank + 1] - dom->halo;
+    const real *x = axisOf(dom, &particles->r);
+
+    dom->nLocal = par->np;
+
+    for (int side = 0; side < 2; side++)
+    {
+        if (dom->sendCap[side] < dom->nLocal)
+        {
+            dom->sendCap[side] = dom->nLocal;
+            dom->sendIdx[side] = (integer *) growArray(dom->sendIdx[side],
+                dom->sendCap[side] * sizeof(integer));
+        }
+
+        dom->nSend[side] = 0;
+        dom->nRecv[side] = 0;
+    }
+
+    /*the end ranks have no neighbour past their outer faces*/
+    for (i = 0; i < dom->nLocal; i++)
+    {
+        if (dom->peer[DOMAIN_LEFT] != MPI_PROC_NULL && x[i] < lo)
+        {
+            dom->sendIdx[DOMAIN_LEFT][dom->nSend[DOMAIN_LEFT]++] = i;
+        }
+
+        if (dom->peer[DOMAIN_RIGHT] != MPI_PROC_NULL && x[i] >= hi)
+        {
+            dom->sendIdx[DOMAIN_RIGHT][dom->nSend[DOMAIN_RIGHT]++] = i;
+        }
+    }
+
+    MPI_Sendrecv(&dom->nSend[DOMAIN_LEFT], 1, MPI_UNSIGNED_LONG,
+        dom->peer[DOMAIN_LEFT], 1, &dom->nRecv[DOMAIN_RIGHT], 1,
+        MPI_UNSIGNED_LONG, dom->peer[DOMAIN_RIGHT], 1, dom->comm,
+        MPI_STATUS_IGNORE);
+    MPI_Sendrecv(&dom->nSend[DOMAIN_RIGHT], 1, MPI_UNSIGNED_LONG,
+        dom->peer[DOMAIN_RIGHT], 1, &dom->nRecv[DOMAIN_LEFT], 1,
+        MPI_UNSIGNED_LONG, dom->peer[DOMAIN_LEFT], 1, dom->comm,
+        MPI_STATUS_IGNORE);
+
+    dom->nGhost = dom->nRecv[DOMAIN_LEFT] + dom->nRecv[DOMAIN_RIGHT];
+
+    reserveFluid(particles, dom->nLocal + dom->nGhost);
+
+    real *fields[GHOST_FIELDS];
+
+    ghostFields(particles, fields);
+    haloExchange(dom, fields, GHOST_FIELDS);
+
+    for (i = dom->nLocal; i < dom->nLocal + dom->nGhost; i++)
+    {
+        particles->nNeighS.arr[i] = 0;
+        particles->nNeighL.arr[i] = 0;
+    }
+}
+
+void refreshGhosts(domain *dom, fluid *particles)
+{
+    real *fields[GHOST_FIELDS];
+
+    ghostFields(particles, fields);
+    haloExchange(dom, fields, GHOST_FIELDS);
+}
+
+void updateGhostField(domain *dom, real *field)
+{
+    haloExchange(dom, &field, 1);
+}
+
+/******************************************************************************
+ * DISTRIBUTED STAGES                                                         *
+ ******************************************************************************/
+
+void searchNeighboursDomain(domain *dom, cellGrid *grid, fluid *particles,
+    parameters *par)
+{
+    parameters all = *par;
+
+    all.np = dom->nLocal + dom->nGhost;
+
+    fitCellGrid(grid, particles, &all);
+    buildCellGrid(grid, particles, &all);
+    countNeighbours(grid, particles, &all, 0, dom->nLocal);
+    searchNeighboursRange(grid, particles, &all, 0, dom->nLocal);
+}
+
+integer solvePressureDomain(domain *dom, fluid *particles, parameters *par,
+    surfaceList *surf, solverConfig *cfg)
+{
+    register integer r; /*row       counter loop*/
+    register integer k; /*neighbour counter loop*/
+    register integer it;
+
+    if (par->pressure == PRESSURE_EXPLICIT)
+    {
+        explicitPressure(particles, par);
+        updateGhostField(dom, particles->pressure.x);
+        return 0;
+    }
+
+    const real    coef   = 2.0 * par->dim / (par->lambda * par->n0L);
+    const real    source = par->rho / (par->dt * par->dt * par->n0S);
+    const integer nL     = dom->nLocal;
+    const integer nT     = dom->nLocal + dom->nGhost;
+    const integer n      = surf->nInterior;
+
+    /*column of each particle: its row, or n + k for the k-th ghost unknown*/
+    real    *scratch = (real *)    growArray(NULL, nT * sizeof(real));
+    integer *column  = (integer *) growArray(NULL, nT * sizeof(integer));
+    integer *ghost   = (integer *) growArray(NULL,
+        (dom->nGhost + 1) * sizeof(integer));
+    integer  nG      = 0;
+
+    for (r = 0; r < nL; r++)
+    {
+        column[r]  = surf->row[r];
+        scratch[r] = (surf->row[r] != SURFACE_NONE) ? 1.0 : 0.0;
+    }
+
+    updateGhostField(dom, scratch);
+
+    for (r = nL; r < nT; r++)
+    {
+        column[r] = SURFACE_NONE;
+
+        if (scratch[r] != 0.0)
+        {
+            ghost[nG] = r;
+            column[r] = n + nG++;
+        }
+    }
+
+    /*local rows of the pressure Poisson equation*/
+    integer nnz = n;
+
+    for (r = 0; r < n; r++)
+    {
+        nnz += particles->nNeighL.arr[surf->interior[r]];
+    }
+
+    csrMatrix *A = makeCsrMatrix(n, nnz);
+    vector1D  *b = makeVector1D(n);
+
+    nnz = 0;
+
+    for (r = 0; r < n; r++)
+    {
+        const integer  i    = surf->interior[r];
+        const integer *nb   = particles->neighL.arr + particles->startL.arr[i];
+        const real    *d    = particles->dNeighL.x  + particles->startL.arr[i];
+        const integer  diag = nnz++;
+
+        real sumW = 0.0;
+
+        A->rowPtr[r] = diag;
+
+        for (k = 0; k < particles->nNeighL.arr[i]; k++)
+        {
+            const real    w   = coef * weight(d[k], par->reL);
+            const integer col = column[nb[k]];
+
+            sumW += w;
+
+            if (col != SURFACE_NONE)
+            {
+                A->colInd[nnz] = (integer32) col;
+                A->val[nnz++]  = -w;
+            }
+        }
+
+        A->colInd[diag] = (integer32) r;
+        A->val[diag]    = sumW;
+        b->x[r]         = source * (particles->pndS.x[i] - par->n0S);
+    }
+
+    A->rowPtr[n] = nnz;
+    A->nnz       = nnz;
+
+    /*Jacobi preconditioned CG; x and p carry the ghost unknowns after n*/
+    vector1D *x    = makeVector1D(n + nG);
+    vector1D *p    = makeVector1D(n + nG);
+    vector1D *res  = makeVector1D(n);
+    vector1D *z    = makeVector1D(n);
+    vector1D *q    = makeVector1D(n);
+    vector1D *dinv = makeVector1D(n);
+
+    diagonalCsr(A, dinv);
+
+    for (r = 0; r < n; r++)
+    {
+        dinv->x[r] = (dinv->x[r] != 0.0) ? 1.0 / dinv->x[r] : 1.0;
+        x->x[r]    = particles->pressure.x[surf->interior[r]];
+    }
+
+    for (k = 0; k < nG; k++)
+    {
+        x->x[n + k] = particles->pressure.x[ghost[k]];
+    }
+
+    /*r = b - A x*/
+    spmvCsr(A, x, q);
+
+    for (r = 0; r < n; r++)
+    {
+        res->x[r] = b->x[r] - q->x[r];
+        z->x[r]   = dinv->x[r] * res->x[r];
+        p->x[r]   = z->x[r];
+    }
+
+    real bnorm = sqrt(dotDomain(dom, b->x, b->x, n));
+    real rz    = dotDomain(dom, res->x, z->x, n);
+    real rnorm = sqrt(dotDomain(dom, res->x, res->x, n));
+
+    bnorm = (bnorm > 0.0) ? bnorm : 1.0;
+
+    for (it = 0; it < cfg->maxIter && rnorm > cfg->tol * bnorm; it++)
+    {
+        /*the search direction of the ghost unknowns comes from the owners*/
+        for (r = 0; r < n; r++)
+        {
+            scratch[surf->interior[r]] = p->x[r];
+        }
+
+        updateGhostField(dom, scratch);
+
+        for (k = 0; k < nG; k++)
+        {
+            p->x[n + k] = scratch[ghost[k]];
+        }
+
+        spmvCsr(A, p, q);
+
+        const real alpha = rz / dotDomain(dom, p->x, q->x, n);
+
+        for (r = 0; r < n; r++)
+        {
+            x->x[r]   += alpha * p->x[r];
+            res->x[r] -= alpha * q->x[r];
+            z->x[r]    = dinv->x[r] * res->x[r];
+        }
+
+        const real rzNew = dotDomain(dom, res->x, z->x, n);
+        const real beta  = rzNew / rz;
+
+        for (r = 0; r < n; r++)
+        {
+            p->x[r] = z->x[r] + beta * p->x[r];
+        }
+
+        rz    = rzNew;
+        rnorm = sqrt(dotDomain(dom, res->x, res->x, n));
+    }
+
+    cfg->iterations = it;
+    cfg->residual   = rnorm / bnorm;
+
+    for (r = 0; r < n; r++)
+    {
+        particles->pressure.x[surf->interior[r]] = x->x[r];
+    }
+
+    applyPressureBoundary(particles, surf);
+    updateGhostField(dom, particles->pressure.x);
+
+    freeCsrMatrix(A);
+    freeVector1D(b);
+    freeVector1D(x);
+    freeVector1D(p);
+    freeVector1D(res);
+    freeVector1D(z);
+    freeVector1D(q);
+    freeVector1D(dinv);
+    free(scratch);
+    free(column);
+    free(ghost);
+
+    return it;
+}
+
+real reduceMaxDomain(domain *dom, const real value)
+{
+    real result;
+
+    MPI_Allreduce(&value, &result, 1, MPI_DOUBLE, MPI_MAX, dom->comm);
+
+    return result;
+}
+
+#endif
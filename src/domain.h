@@ -0,0 +1,247 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                                DOMAIN.H                                    *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Distributed-memory execution with MPI, compiled when CMPS_USE_MPI is       *
+ * defined (set by CMake when MPI is found). The domain is cut into slabs     *
+ * along one axis, one slab per rank, each at least reL thick, so that every  *
+ * neighbour of a particle lives on its own rank or on an adjacent one.       *
+ *                                                                            *
+ * On each rank the fluid holds its own particles in [0, nLocal) followed by  *
+ * the ghost particles in [nLocal, nLocal + nGhost): the copies of the        *
+ * particles of the adjacent ranks that lie within reL of the slab faces.     *
+ * par->np is nLocal, so every stage loops over the owned particles only,     *
+ * while the neighbour lists may point to ghosts. The ghosts carry the        *
+ * positions, velocities, pressure, temperature and pndS of their owners.     *
+ *                                                                            *
+ * A distributed step is ordered as follows:                                  *
+ *     store un, rn; refreshGhosts; predictionStep;                           *
+ *     migrateParticles; exchangeGhosts; searchNeighboursDomain;              *
+ *     computePnd; detectFreeSurface; computeTemperature (explicit);          *
+ *     solvePressureDomain; correctVelocity; reduceMaxDomain(uMax).           *
+ * refreshGhosts updates the ghosts of the last exchange in place, so the     *
+ * neighbour lists of the previous search stay valid for the prediction.      *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __DOMAIN_H__
+#define __DOMAIN_H__
+
+#if defined(CMPS_USE_MPI)
+
+#include "structures.h"
+#include "neighbours.h"
+#include "surface.h"
+#include "solver.h"
+
+#include <mpi.h>
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+#define DOMAIN_LEFT  0  // side of the lower adjacent rank
+#define DOMAIN_RIGHT 1  // side of the upper adjacent rank
+
+typedef struct domain
+{
+    MPI_Comm  comm;         /* communicator of the ranks                      */
+    int       rank;         /* rank of this process                           */
+    int       size;         /* number of ranks                                */
+    int       peer[2];      /* adjacent ranks, MPI_PROC_NULL at the ends      */
+    integer   axis;         /* cut axis: 0, 1 or 2                            */
+    real     *cuts;         /* slab faces, size + 1 values                    */
+    real      halo;         /* ghost layer thickness, the reL                 */
+    integer   nLocal;       /* particles owned by this rank                   */
+    integer   nGhost;       /* ghost particles after the owned ones           */
+    integer  *sendIdx[2];   /* owned particles sent as ghosts to each side    */
+    integer   nSend[2];     /* number of particles sent to each side          */
+    integer   sendCap[2];   /* slots in sendIdx                               */
+    integer   nRecv[2];     /* number of ghosts received from each side       */
+    real     *buffer;       /* packing buffer                                 */
+    integer   bufferCap;    /* slots in buffer                                */
+
+} domain;
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    makeDomain                                                    *
+ * -------------------------------------------------------------------------- *
+ * description: cuts [min, max] along axis into equal slabs, one per rank of  *
+ *              comm. The run stops if a slab is thinner than the halo.       *
+ * -------------------------------------------------------------------------- *
+ * input:  MPI_Comm      comm   // communicator of the ranks                  *
+ *         const integer axis   // cut axis: 0, 1 or 2                        *
+ *         const real    min    // lower bound of the domain along axis       *
+ *         const real    max    // upper bound of the domain along axis       *
+ *         const real    halo   // ghost layer thickness, usually reL         *
+ * -------------------------------------------------------------------------- *
+ * output: domain *self                                                       *
+ ******************************************************************************/
+domain *makeDomain(MPI_Comm comm, const integer axis, const real min,
+    const real max, const real halo);
+
+/******************************************************************************
+ * Function:    freeDomain                                                    *
+ * -------------------------------------------------------------------------- *
+ * description: deallocates the domain. The communicator is not freed.        *
+ * -------------------------------------------------------------------------- *
+ * input:  domain *self   // domain decomposition                             *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void freeDomain(domain *self);
+
+/******************************************************************************
+ * PARTICLE DISTRIBUTION                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    setDomainCuts                                                 *
+ * -------------------------------------------------------------------------- *
+ * description: replaces the slab faces, e.g. with the faces of a load        *
+ *              balancer. The particles move on the next migrateParticles.    *
+ * -------------------------------------------------------------------------- *
+ * input:  domain     *dom    // domain decomposition                         *
+ *         const real *cuts   // size + 1 increasing slab faces               *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void setDomainCuts(domain *dom, const real *cuts);
+
+/******************************************************************************
+ * Function:    migrateParticles                                              *
+ * -------------------------------------------------------------------------- *
+ * description: sends every owned particle outside the slab of the rank to    *
+ *              the rank owning its position, with all its fields, and        *
+ *              appends the particles received. The ghosts are dropped and    *
+ *              par->np is set to the new nLocal.                             *
+ * -------------------------------------------------------------------------- *
+ * input:  domain     *dom         // domain decomposition                    *
+ *         fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ * -------------------------------------------------------------------------- *
+ * output: integer                 // particles received by this rank         *
+ ******************************************************************************/
+integer migrateParticles(domain *dom, fluid *particles, parameters *par);
+
+/******************************************************************************
+ * Function:    exchangeGhosts                                                *
+ * -------------------------------------------------------------------------- *
+ * description: selects the owned particles within the halo of each slab      *
+ *              face, sends them to the adjacent ranks and stores the ghosts  *
+ *              received after the owned particles. The ghosts have no        *
+ *              neighbour lists.                                              *
+ * -------------------------------------------------------------------------- *
+ * input:  domain     *dom         // domain decomposition                    *
+ *         fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void exchangeGhosts(domain *dom, fluid *particles, parameters *par);
+
+/******************************************************************************
+ * Function:    refreshGhosts                                                 *
+ * -------------------------------------------------------------------------- *
+ * description: sends again the particles of the last exchangeGhosts, so the  *
+ *              ghosts get the current fields of their owners in the same     *
+ *              slots.                                                        *
+ * -------------------------------------------------------------------------- *
+ * input:  domain *dom         // domain decomposition                        *
+ *         fluid  *particles   // fluid particles                             *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void refreshGhosts(domain *dom, fluid *particles);
+
+/******************************************************************************
+ * Function:    updateGhostField                                              *
+ * -------------------------------------------------------------------------- *
+ * description: copies one per-particle field from the owners to the ghosts   *
+ *              of the last exchange.                                         *
+ * -------------------------------------------------------------------------- *
+ * input:  domain *dom     // domain decomposition                            *
+ *         real   *field   // field of size nLocal + nGhost                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void updateGhostField(domain *dom, real *field);
+
+/******************************************************************************
+ * DISTRIBUTED STAGES                                                         *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    searchNeighboursDomain                                        *
+ * -------------------------------------------------------------------------- *
+ * description: fits and builds the cell grid on the owned and ghost          *
+ *              particles and fills the neighbour lists of the owned ones.    *
+ * -------------------------------------------------------------------------- *
+ * input:  domain     *dom         // domain decomposition                    *
+ *         cellGrid   *grid        // cell grid                               *
+ *         fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void searchNeighboursDomain(domain *dom, cellGrid *grid, fluid *particles,
+    parameters *par);
+
+/******************************************************************************
+ * Function:    solvePressureDomain                                           *
+ * -------------------------------------------------------------------------- *
+ * description: computes the pressure of the owned particles and updates the  *
+ *              ghosts. In the implicit mode every rank assembles the rows of *
+ *              its interior particles; the ghost interior particles are      *
+ *              extra columns whose values are exchanged before every product *
+ *              of a double precision Jacobi preconditioned CG on CSR, and    *
+ *              the dot products are reduced over the ranks. cfg->mode and    *
+ *              cfg->format are not used. The surface lists are those of the  *
+ *              owned particles.                                              *
+ * -------------------------------------------------------------------------- *
+ * input:  domain       *dom         // domain decomposition                  *
+ *         fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // simulation parameters                 *
+ *         surfaceList  *surf        // free-surface and interior lists       *
+ *         solverConfig *cfg         // maxIter and tol; iterations and       *
+ *                                   // residual on output                    *
+ * -------------------------------------------------------------------------- *
+ * output: integer                   // solver iterations, 0 if explicit      *
+ ******************************************************************************/
+integer solvePressureDomain(domain *dom, fluid *particles, parameters *par,
+    surfaceList *surf, solverConfig *cfg);
+
+/******************************************************************************
+ * Function:    reduceMaxDomain                                               *
+ * -------------------------------------------------------------------------- *
+ * description: returns the maximum of value over the ranks, e.g. of the      *
+ *              velocity returned by correctVelocity before nextTimeStep.     *
+ * -------------------------------------------------------------------------- *
+ * input:  domain    *dom     // domain decomposition                         *
+ *         const real value   // value of this rank                           *
+ * -------------------------------------------------------------------------- *
+ * output: real               // maximum over the ranks                       *
+ ******************************************************************************/
+real reduceMaxDomain(domain *dom, const real value);
+
+#endif
+
+#endif
@@ -0,0 +1,238 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                                LAYOUT.C                                    *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "layout.h"
+#include "particles.h"
+#include "prediction.h"
+#include "pressure.h"
+#include "timestep.h"
+#include "collision.h"
+
+#include <stdio.h>  /*input and output variable manipulation*/
+#include <stdlib.h> /*address and memory manipulation*/
+
+/******************************************************************************
+ * AUXILIARY FUNCTIONS                                                        *
+ ******************************************************************************/
+
+/* stable counting sort of src by key, into dst */
+static void countingSort(const integer *src, integer *dst, const integer *key,
+    const integer n, integer *count, const integer nkeys)
+{
+    register integer k;
+
+    for (k = 0; k <= nkeys; k++)
+    {
+        count[k] = 0;
+    }
+
+    for (k = 0; k < n; k++)
+    {
+        count[key[src[k]] + 1]++;
+    }
+
+    for (k = 0; k < nkeys; k++)
+    {
+        count[k + 1] += count[k];
+    }
+
+    for (k = 0; k < n; k++)
+    {
+        dst[count[key[src[k]]]++] = src[k];
+    }
+}
+
+/******************************************************************************
+ * TYPE LAYOUT                                                                *
+ ******************************************************************************/
+
+boolean sortByType(fluid *particles, parameters *par, typeLayout *layout,
+    cellGrid *grid)
+{
+    register integer i; /*particle counter loop*/
+    register integer t; /*type     counter loop*/
+
+    const integer np = par->np;
+    boolean moved    = false;
+    integer nmat     = 0;
+
+    if (np == 0)
+    {
+        for (t = 0; t <= PARTICLE_TYPES; t++)
+        {
+            layout->start[t] = 0;
+        }
+
+        return false;
+    }
+
+    for (i = 0; i < np; i++)
+    {
+        if (particles->type.arr[i] >= PARTICLE_TYPES)
+        {
+            printf ("ERROR: particle %lu has an unknown type\n", i);
+            exit (EXIT_FAILURE);
+        }
+
+        nmat = (particles->idMat.arr[i] + 1 > nmat) ?
+            particles->idMat.arr[i] + 1 : nmat;
+    }
+
+    const integer ncells = (grid != NULL) ? grid->nx * grid->ny * grid->nz : 0;
+
+    integer nkeys = (ncells > nmat) ? ncells : nmat;
+
+    nkeys = (nkeys > PARTICLE_TYPES) ? nkeys : PARTICLE_TYPES;
+
+    integer *perm  = (integer *) malloc(np * sizeof(integer));
+    integer *tmp   = (integer *) malloc(np * sizeof(integer));
+    integer *key   = (integer *) malloc(np * sizeof(integer));
+    integer *count = (integer *) malloc((nkeys + 1) * sizeof(integer));
+
+    if (perm == NULL || tmp == NULL || key == NULL || count == NULL)
+    {
+        printf ("ERROR: no free space in RAM to sort the types\n");
+        exit (EXIT_FAILURE);
+    }
+
+    for (i = 0; i < np; i++)
+    {
+        perm[i] = i;
+    }
+
+    /*least significant key first: cell, material, then type*/
+    if (grid != NULL)
+    {
+        for (i = 0; i < np; i++)
+        {
+            key[i] = cellIndex(grid, particles->r.x[i], particles->r.y[i],
+                particles->r.z[i]);
+        }
+
+        countingSort(perm, tmp, key, np, count, ncells);
+
+        for (i = 0; i < np; i++)
+        {
+            perm[i] = tmp[i];
+        }
+    }
+
+    countingSort(perm, tmp, particles->idMat.arr, np, count, nmat);
+    countingSort(tmp, perm, particles->type.arr, np, count, PARTICLE_TYPES);
+
+    /*type ranges: count holds the end of each type*/
+    layout->start[0] = 0;
+
+    for (t = 0; t < PARTICLE_TYPES; t++)
+    {
+        layout->start[t + 1] = count[t];
+    }
+
+    for (i = 0; i < np && !moved; i++)
+    {
+        moved = (perm[i] != i) ? true : false;
+    }
+
+    if (moved)
+    {
+        permuteFluid(particles, perm, np);
+    }
+
+    free(perm);
+    free(tmp);
+    free(key);
+    free(count);
+
+    return moved;
+}
+
+/******************************************************************************
+ * STAGES                                                                     *
+ ******************************************************************************/
+
+void searchNeighboursLayout(cellGrid *grid, fluid *particles, parameters *par,
+    typeLayout *layout)
+{
+    buildCellGrid(grid, particles, par);
+    countNeighbours(grid, particles, par, 0, layout->start[PARTICLE_DUMMY]);
+    searchNeighboursRange(grid, particles, par, 0,
+        layout->start[PARTICLE_DUMMY]);
+}
+
+void computePndLayout(fluid *particles, parameters *par, typeLayout *layout)
+{
+    computePndRange(particles, par, 0, layout->start[PARTICLE_DUMMY]);
+}
+
+real predictionLayout(fluid *particles, parameters *par, typeLayout *layout)
+{
+    return predictionReach(particles, par, 0, layout->start[PARTICLE_WALL],
+        layout->start[PARTICLE_DUMMY]);
+}
+
+void detectSurfaceLayout(fluid *particles, parameters *par, typeLayout *layout,
+    surfaceConfig *cfg, surfaceList *surf)
+{
+    parameters local = *par;
+
+    local.np = layout->start[PARTICLE_DUMMY];
+
+    detectFreeSurface(particles, &local, cfg, surf);
+}
+
+integer computePressureLayout(fluid *particles, parameters *par,
+    typeLayout *layout, surfaceList *surf, solverConfig *cfg)
+{
+    if (par->pressure == PRESSURE_EXPLICIT)
+    {
+        explicitPressureRange(particles, par, 0, layout->start[PARTICLE_DUMMY]);
+        return 0;
+    }
+
+    vector1D     *b = makeVector1D(surf->nInterior);
+    sparseMatrix *A = makeSparseMatrix(assemblePressurePoissonReach(particles,
+        par, surf, b, layout->start[PARTICLE_DUMMY]), cfg->format);
+
+    const integer it = solvePressure(particles, surf->interior, A, b, cfg);
+
+    applyPressureBoundary(particles, surf);
+
+    freeSparseMatrix(A);
+    freeVector1D(b);
+
+    return it;
+}
+
+real correctVelocityLayout(fluid *particles, parameters *par,
+    typeLayout *layout)
+{
+    return correctVelocityReach(particles, par, 0,
+        layout->start[PARTICLE_WALL], layout->start[PARTICLE_DUMMY]);
+}
+
+integer collideParticlesLayout(fluid *particles, parameters *par,
+    typeLayout *layout, collisionConfig *cfg, scatterPlan *plan)
+{
+    parameters fluidOnly = *par;
+
+    /*the walls and dummies are neither moved nor scattered into*/
+    fluidOnly.np = layout->start[PARTICLE_WALL];
+
+    return collideParticles(particles, &fluidOnly, cfg, plan, NULL);
+}
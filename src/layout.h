@@ -0,0 +1,205 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                                LAYOUT.H                                    *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Type-partitioned particle layout: the fluid, wall and dummy particles are  *
+ * stored in this order, in contiguous ranges of every fluid array, and each  *
+ * stage only visits the ranges it needs:                                     *
+ *                                                                            *
+ *   stage               particles      neighbours                            *
+ *   neighbour search    fluid, wall    all                                   *
+ *   pnd, surface        fluid, wall    all                                   *
+ *   prediction          fluid          fluid, wall                           *
+ *   pressure            fluid, wall    fluid, wall                           *
+ *   correction          fluid          fluid, wall                           *
+ *                                                                            *
+ * The walls and dummies never move: the stages that update r and u for       *
+ * every particle below par->np, i.e. collideParticles and                    *
+ * correctWallVelocity, are given the fluid-only np, start[PARTICLE_WALL],    *
+ * as collideParticlesLayout does. The dummies only complete the pnd of       *
+ * the particles near the walls and have no pressure: they drop out of the    *
+ * pressure equation as Neumann neighbours. The walls keep their rows, which  *
+ * give the pressure the fluid is pushed back with; with Neumann walls and    *
+ * the wall pressure averaged from the fluid, a settling tank goes unstable.  *
+ * A neighbour is classified by comparing its index with the range bounds,    *
+ * without reading a type per neighbour.                                      *
+ * Any other reordering, e.g. sortByMaterial or balanceParticles, breaks the  *
+ * ranges: sortByType must run after it.                                      *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __LAYOUT_H__
+#define __LAYOUT_H__
+
+#include "structures.h"
+#include "neighbours.h"
+#include "surface.h"
+#include "solver.h"
+#include "collision.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+typedef struct typeLayout
+{
+    integer start[PARTICLE_TYPES + 1];   /* particle range of each type       */
+
+} typeLayout;
+
+/******************************************************************************
+ * TYPE LAYOUT                                                                *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    sortByType                                                    *
+ * -------------------------------------------------------------------------- *
+ * description: reorders the particles into contiguous ranges of type and     *
+ *              updates layout->start. Inside each type the particles are     *
+ *              grouped by material and, when a cell grid is given, sorted    *
+ *              by cell. The sort is stable and the fluid is only permuted    *
+ *              when the order changed; the neighbour lists must then be      *
+ *              searched again.                                               *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ *         typeLayout *layout      // range of each type                      *
+ *         cellGrid   *grid        // cell grid, or NULL                      *
+ * -------------------------------------------------------------------------- *
+ * output: boolean                 // true if the particles were moved        *
+ ******************************************************************************/
+boolean sortByType(fluid *particles, parameters *par, typeLayout *layout,
+    cellGrid *grid);
+
+/******************************************************************************
+ * STAGES                                                                     *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    searchNeighboursLayout                                        *
+ * -------------------------------------------------------------------------- *
+ * description: builds the cell grid over every particle and fills the        *
+ *              neighbour lists of the fluid and wall particles only.         *
+ * -------------------------------------------------------------------------- *
+ * input:  cellGrid   *grid        // cell grid with edge >= reL              *
+ *         fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ *         typeLayout *layout      // range of each type                      *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void searchNeighboursLayout(cellGrid *grid, fluid *particles, parameters *par,
+    typeLayout *layout);
+
+/******************************************************************************
+ * Function:    computePndLayout                                              *
+ * -------------------------------------------------------------------------- *
+ * description: computes pndS and pndL of the fluid and wall particles, to    *
+ *              which the dummy neighbours contribute.                        *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ *         typeLayout *layout      // range of each type                      *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void computePndLayout(fluid *particles, parameters *par, typeLayout *layout);
+
+/******************************************************************************
+ * Function:    predictionLayout                                              *
+ * -------------------------------------------------------------------------- *
+ * description: prediction step of the fluid particles; the fixed walls give  *
+ *              the no-slip viscous term and the dummies are left out.        *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ *         typeLayout *layout      // range of each type                      *
+ * -------------------------------------------------------------------------- *
+ * output: real                    // maximum predicted velocity norm         *
+ ******************************************************************************/
+real predictionLayout(fluid *particles, parameters *par, typeLayout *layout);
+
+/******************************************************************************
+ * Function:    detectSurfaceLayout                                           *
+ * -------------------------------------------------------------------------- *
+ * description: detects the free surface among the fluid and wall particles.  *
+ *              The lists only cover these two ranges.                        *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid         *particles   // fluid particles                      *
+ *         parameters    *par         // simulation parameters                *
+ *         typeLayout    *layout      // range of each type                   *
+ *         surfaceConfig *cfg         // detection configuration              *
+ *         surfaceList   *surf        // surface and interior lists           *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void detectSurfaceLayout(fluid *particles, parameters *par, typeLayout *layout,
+    surfaceConfig *cfg, surfaceList *surf);
+
+/******************************************************************************
+ * Function:    computePressureLayout                                         *
+ * -------------------------------------------------------------------------- *
+ * description: computes the pressure of the fluid and wall particles, by the *
+ *              equation of state or by a pressure Poisson equation with      *
+ *              their rows, the dummy neighbours being left out.              *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // simulation parameters                 *
+ *         typeLayout   *layout      // range of each type                    *
+ *         surfaceList  *surf        // lists of detectSurfaceLayout          *
+ *         solverConfig *cfg         // pressure solver                       *
+ * -------------------------------------------------------------------------- *
+ * output: integer                   // solver iterations, 0 if explicit      *
+ ******************************************************************************/
+integer computePressureLayout(fluid *particles, parameters *par,
+    typeLayout *layout, surfaceList *surf, solverConfig *cfg);
+
+/******************************************************************************
+ * Function:    correctVelocityLayout                                         *
+ * -------------------------------------------------------------------------- *
+ * description: corrects the fluid particles with the pressure gradient of    *
+ *              their fluid and wall neighbours.                              *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ *         typeLayout *layout      // range of each type                      *
+ * -------------------------------------------------------------------------- *
+ * output: real                    // maximum fluid velocity norm             *
+ ******************************************************************************/
+real correctVelocityLayout(fluid *particles, parameters *par,
+    typeLayout *layout);
+
+/******************************************************************************
+ * Function:    collideParticlesLayout                                        *
+ * -------------------------------------------------------------------------- *
+ * description: collideParticles on the fluid particles only: the pairs with  *
+ *              wall and dummy neighbours are skipped, so those never move.   *
+ *              The scatter runs without the cell colouring, since the grid   *
+ *              also holds the walls and dummies.                             *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid           *particles   // fluid particles                    *
+ *         parameters      *par         // simulation parameters              *
+ *         typeLayout      *layout      // range of each type                 *
+ *         collisionConfig *cfg         // collision configuration            *
+ *         scatterPlan     *plan        // scatter accumulation of du         *
+ * -------------------------------------------------------------------------- *
+ * output: integer                      // number of candidate particles      *
+ ******************************************************************************/
+integer collideParticlesLayout(fluid *particles, parameters *par,
+    typeLayout *layout, collisionConfig *cfg, scatterPlan *plan);
+
+#endif
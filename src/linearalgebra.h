@@ -0,0 +1,30 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                             LINEARALGEBRA.H                                *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Gathers the linear algebra objects: vectors, dense and sparse matrices.    *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __LINEARALGEBRA_H__
+#define __LINEARALGEBRA_H__
+
+#include "vectors.h"
+#include "matrices.h"
+#include "sparse.h"
+
+#endif
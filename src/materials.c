@@ -0,0 +1,324 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                              MATERIALS.C                                   *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "materials.h"
+#include "particles.h"
+#include "pressure.h"
+#include "timestep.h"
+
+#include <stdio.h>  /*input and output variable manipulation*/
+#include <stdlib.h> /*address and memory manipulation*/
+
+/******************************************************************************
+ * AUXILIARY FUNCTIONS                                                        *
+ ******************************************************************************/
+
+/* stable counting sort of src by key, into dst */
+static void countingSort(const integer *src, integer *dst, const integer *key,
+    const integer n, integer *count, const integer nkeys)
+{
+    register integer k;
+
+    for (k = 0; k <= nkeys; k++)
+    {
+        count[k] = 0;
+    }
+
+    for (k = 0; k < n; k++)
+    {
+        count[key[src[k]] + 1]++;
+    }
+
+    for (k = 0; k < nkeys; k++)
+    {
+        count[k + 1] += count[k];
+    }
+
+    for (k = 0; k < n; k++)
+    {
+        dst[count[key[src[k]]]++] = src[k];
+    }
+}
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+materialTable *makeMaterialTable(const integer nmat)
+{
+    materialTable *self = (materialTable *) malloc(sizeof(materialTable));
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the object\n");
+        exit (EXIT_FAILURE);
+    }
+
+    self->nmat  = nmat;
+    self->prop  = (material *) calloc(nmat > 0 ? nmat : 1, sizeof(material));
+    self->start = (integer *)  calloc(nmat + 1, sizeof(integer));
+
+    if (self->prop == NULL || self->start == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the materials\n");
+        exit (EXIT_FAILURE);
+    }
+
+    return self;
+}
+
+void freeMaterialTable(materialTable *self)
+{
+    free(self->prop);
+    free(self->start);
+    free(self);
+}
+
+/******************************************************************************
+ * MATERIAL LAYOUT                                                            *
+ ******************************************************************************/
+
+boolean sortByMaterial(fluid *particles, parameters *par, materialTable *table,
+    cellGrid *grid)
+{
+    register integer i; /*particle counter loop*/
+    register integer m; /*material counter loop*/
+
+    const integer np = par->np;
+    boolean moved    = false;
+
+    if (np == 0)
+    {
+        for (m = 0; m <= table->nmat; m++)
+        {
+            table->start[m] = 0;
+        }
+
+        return false;
+    }
+
+    for (i = 0; i < np; i++)
+    {
+        if (particles->idMat.arr[i] >= table->nmat)
+        {
+            printf ("ERROR: particle %lu has an unknown material\n", i);
+            exit (EXIT_FAILURE);
+        }
+    }
+
+    const integer ncells = (grid != NULL) ? grid->nx * grid->ny * grid->nz : 0;
+    const integer nkeys  = (ncells > table->nmat) ? ncells : table->nmat;
+
+    integer *perm  = (integer *) malloc(np * sizeof(integer));
+    integer *tmp   = (integer *) malloc(np * sizeof(integer));
+    integer *key   = (integer *) malloc(np * sizeof(integer));
+    integer *count = (integer *) malloc((nkeys + 1) * sizeof(integer));
+
+    if (perm == NULL || tmp == NULL || key == NULL || count == NULL)
+    {
+        printf ("ERROR: no free space in RAM to sort the materials\n");
+        exit (EXIT_FAILURE);
+    }
+
+    for (i = 0; i < np; i++)
+    {
+        tmp[i] = i;
+    }
+
+    /*least significant key first: cell, then material*/
+    if (grid != NULL)
+    {
+        for (i = 0; i < np; i++)
+        {
+            key[i] = cellIndex(grid, particles->r.x[i], particles->r.y[i],
+                particles->r.z[i]);
+        }
+
+        countingSort(tmp, perm, key, np, count, ncells);
+
+        for (i = 0; i < np; i++)
+        {
+            tmp[i] = perm[i];
+        }
+    }
+
+    countingSort(tmp, perm, particles->idMat.arr, np, count, table->nmat);
+
+    /*material ranges: count holds the end of each material*/
+    table->start[0] = 0;
+
+    for (m = 0; m < table->nmat; m++)
+    {
+        table->start[m + 1] = count[m];
+    }
+
+    for (i = 0; i < np && !moved; i++)
+    {
+        moved = (perm[i] != i) ? true : false;
+    }
+
+    if (moved)
+    {
+        permuteFluid(particles, perm, np);
+    }
+
+    free(perm);
+    free(tmp);
+    free(key);
+    free(count);
+
+    return moved;
+}
+
+void materialParameters(parameters *par, materialTable *table,
+    const integer m, parameters *local)
+{
+    *local       = *par;
+    local->rho   = table->prop[m].rho;
+    local->nu    = table->prop[m].nu;
+    local->c0    = table->prop[m].c0;
+    local->kappa = table->prop[m].kappa;
+}
+
+real forEachMaterial(fluid *particles, parameters *par, materialTable *table,
+    materialKernel kernel)
+{
+    register integer m;
+
+    real result = 0.0;
+
+    for (m = 0; m < table->nmat; m++)
+    {
+        parameters local;
+
+        if (table->start[m + 1] == table->start[m])
+        {
+            continue;
+        }
+
+        materialParameters(par, table, m, &local);
+
+        const real r = kernel(particles, &local, table->start[m],
+            table->start[m + 1]);
+
+        result = (r > result) ? r : result;
+    }
+
+    return result;
+}
+
+/******************************************************************************
+ * MATERIAL STAGES                                                            *
+ ******************************************************************************/
+
+real correctVelocityMaterial(fluid *particles, parameters *par,
+    materialTable *table)
+{
+    forEachMaterial(particles, par, table, pressureGradientRange);
+
+    return applyCorrectionRange(particles, par, 0, par->np);
+}
+
+csrMatrix *assemblePressurePoissonMaterial(fluid *particles, parameters *par,
+    materialTable *table, surfaceList *surf, vector1D *b)
+{
+    register integer m;
+
+    csrMatrix *A = assemblePressurePoisson(particles, par, surf, b);
+
+    for (m = 0; m < table->nmat; m++)
+    {
+        parameters local;
+
+        materialParameters(par, table, m, &local);
+        pressureSourceRange(particles, &local, surf, b, table->start[m],
+            table->start[m + 1]);
+    }
+
+    return A;
+}
+
+integer computeTemperatureMaterial(fluid *particles, parameters *par,
+    materialTable *table, thermalMode mode, solverConfig *cfg)
+{
+    register integer i; /*particle counter loop*/
+    register integer m; /*material counter loop*/
+
+    const integer np = par->np;
+    parameters local;
+
+    if (mode == THERMAL_EXPLICIT)
+    {
+        vector1D *dT = makeVector1D(np);
+
+        for (m = 0; m < table->nmat; m++)
+        {
+            materialParameters(par, table, m, &local);
+            temperatureRateRange(particles, &local, dT, table->start[m],
+                table->start[m + 1]);
+        }
+
+        for (i = 0; i < np; i++)
+        {
+            particles->temperature.x[i] += dT->x[i];
+        }
+
+        freeVector1D(dT);
+
+        return 0;
+    }
+
+    integer nnz = np;
+
+    for (i = 0; i < np; i++)
+    {
+        nnz += particles->nNeighL.arr[i];
+    }
+
+    csrMatrix *T = makeCsrMatrix(np, nnz);
+    vector1D  *b = makeVector1D(np);
+
+    /*diagonal first, then the neighbours, as in assembleHeatEquation*/
+    T->rowPtr[0] = 0;
+
+    for (i = 0; i < np; i++)
+    {
+        T->rowPtr[i + 1] = T->rowPtr[i] + 1 + particles->nNeighL.arr[i];
+    }
+
+    T->nnz = nnz;
+
+    for (m = 0; m < table->nmat; m++)
+    {
+        materialParameters(par, table, m, &local);
+        assembleHeatRange(particles, &local, T, b, table->start[m],
+            table->start[m + 1]);
+    }
+
+    sparseMatrix *A = makeSparseMatrix(T, cfg->format);
+
+    const integer it = (cfg->mode == SOLVER_MIXED) ?
+        mixedSolve(A, b, &particles->temperature, cfg) :
+        pcgSolve(A, b, &particles->temperature, cfg);
+
+    freeSparseMatrix(A);
+    freeVector1D(b);
+
+    return it;
+}
@@ -0,0 +1,202 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                              MATERIALS.H                                   *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Material-partitioned particle layout for multi-material runs. Particles    *
+ * are sorted by fluid.idMat into contiguous ranges, and the kernels are      *
+ * dispatched once per range with the properties of that material, so the     *
+ * density, viscosity, diffusivity and equation of state parameters are loop  *
+ * constants. Range kernels go through forEachMaterial; the stages that must  *
+ * finish every range before the next step, the velocity correction, the      *
+ * pressure Poisson source and the heat update, have their own entry points.  *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __MATERIALS_H__
+#define __MATERIALS_H__
+
+#include "structures.h"
+#include "neighbours.h"
+#include "thermal.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+typedef struct material
+{
+    real rho;     /* density                                                  */
+    real nu;      /* kinematic viscosity                                      */
+    real c0;      /* numerical speed of sound                                 */
+    real kappa;   /* thermal diffusivity                                      */
+
+} material;
+
+typedef struct materialTable
+{
+    integer   nmat;    /* number of materials                                 */
+    material *prop;    /* properties of each material, nmat                   */
+    integer  *start;   /* particle range of each material, nmat + 1           */
+
+} materialTable;
+
+/* kernel over the particles [begin, end) with the parameters of a material */
+typedef real (*materialKernel)(fluid *particles, parameters *par,
+    const integer begin, const integer end);
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    makeMaterialTable                                             *
+ * -------------------------------------------------------------------------- *
+ * description: creates a table of nmat materials with zero properties and    *
+ *              empty ranges.                                                 *
+ * -------------------------------------------------------------------------- *
+ * input:  const integer nmat   // number of materials                        *
+ * -------------------------------------------------------------------------- *
+ * output: materialTable *self                                                *
+ ******************************************************************************/
+materialTable *makeMaterialTable(const integer nmat);
+
+/******************************************************************************
+ * Function:    freeMaterialTable                                             *
+ * -------------------------------------------------------------------------- *
+ * description: deallocates the properties, the ranges and the table.         *
+ * -------------------------------------------------------------------------- *
+ * input:  materialTable *self   // materials and their ranges                *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void freeMaterialTable(materialTable *self);
+
+/******************************************************************************
+ * MATERIAL LAYOUT                                                            *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    sortByMaterial                                                *
+ * -------------------------------------------------------------------------- *
+ * description: reorders the particles into contiguous ranges of idMat and    *
+ *              updates table->start. When a cell grid is given, particles    *
+ *              are also sorted by cell inside each material range, which     *
+ *              keeps neighbours close in memory as the particles move. The   *
+ *              sort is stable and the fluid is only permuted when the order  *
+ *              changed; in that case the neighbour lists must be searched    *
+ *              again.                                                        *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid         *particles   // fluid particles                      *
+ *         parameters    *par         // simulation parameters                *
+ *         materialTable *table       // materials and their ranges           *
+ *         cellGrid      *grid        // cell grid, or NULL                   *
+ * -------------------------------------------------------------------------- *
+ * output: boolean                    // true if the particles were moved     *
+ ******************************************************************************/
+boolean sortByMaterial(fluid *particles, parameters *par, materialTable *table,
+    cellGrid *grid);
+
+/******************************************************************************
+ * Function:    materialParameters                                            *
+ * -------------------------------------------------------------------------- *
+ * description: copies the simulation parameters into local, replacing rho,   *
+ *              nu, c0 and kappa by the properties of the material m.         *
+ * -------------------------------------------------------------------------- *
+ * input:  parameters    *par     // simulation parameters                    *
+ *         materialTable *table   // materials and their ranges               *
+ *         const integer  m       // material id                              *
+ *         parameters    *local   // parameters of the material m             *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void materialParameters(parameters *par, materialTable *table,
+    const integer m, parameters *local);
+
+/******************************************************************************
+ * Function:    forEachMaterial                                               *
+ * -------------------------------------------------------------------------- *
+ * description: calls the kernel once per non-empty material range, with the  *
+ *              parameters of that material, e.g. explicitPressureRange or    *
+ *              predictionRange.                                              *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid          *particles   // fluid particles                     *
+ *         parameters     *par         // simulation parameters               *
+ *         materialTable  *table       // materials and their ranges          *
+ *         materialKernel  kernel      // range kernel                        *
+ * -------------------------------------------------------------------------- *
+ * output: real                        // maximum of the kernel results       *
+ ******************************************************************************/
+real forEachMaterial(fluid *particles, parameters *par, materialTable *table,
+    materialKernel kernel);
+
+/******************************************************************************
+ * MATERIAL STAGES                                                            *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    correctVelocityMaterial                                       *
+ * -------------------------------------------------------------------------- *
+ * description: correctVelocity with the density of each material: the        *
+ *              gradients of every range are stored first, then the           *
+ *              particles are moved.                                          *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid         *particles   // fluid particles                      *
+ *         parameters    *par         // simulation parameters                *
+ *         materialTable *table       // materials and their ranges           *
+ * -------------------------------------------------------------------------- *
+ * output: real                       // maximum velocity norm                *
+ ******************************************************************************/
+real correctVelocityMaterial(fluid *particles, parameters *par,
+    materialTable *table);
+
+/******************************************************************************
+ * Function:    assemblePressurePoissonMaterial                               *
+ * -------------------------------------------------------------------------- *
+ * description: assemblePressurePoisson with the source of each row built     *
+ *              from the density of its material. The matrix does not depend  *
+ *              on the density.                                               *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid         *particles   // fluid particles                      *
+ *         parameters    *par         // simulation parameters                *
+ *         materialTable *table       // materials and their ranges           *
+ *         surfaceList   *surf        // free-surface and interior lists      *
+ *         vector1D      *b           // right-hand side, surf->nInterior     *
+ * -------------------------------------------------------------------------- *
+ * output: csrMatrix *A               // symmetric positive definite matrix   *
+ ******************************************************************************/
+csrMatrix *assemblePressurePoissonMaterial(fluid *particles, parameters *par,
+    materialTable *table, surfaceList *surf, vector1D *b);
+
+/******************************************************************************
+ * Function:    computeTemperatureMaterial                                    *
+ * -------------------------------------------------------------------------- *
+ * description: computeTemperature with the diffusivity of each material. In  *
+ *              the implicit mode each row is divided by its kappa, which     *
+ *              must be positive, so that the system stays symmetric.         *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid         *particles   // fluid particles                      *
+ *         parameters    *par         // simulation parameters                *
+ *         materialTable *table       // materials and their ranges           *
+ *         thermalMode    mode        // explicit or implicit update          *
+ *         solverConfig  *cfg         // solver used in the implicit mode     *
+ * -------------------------------------------------------------------------- *
+ * output: integer                    // solver iterations, 0 if explicit     *
+ ******************************************************************************/
+integer computeTemperatureMaterial(fluid *particles, parameters *par,
+    materialTable *table, thermalMode mode, solverConfig *cfg);
+
+#endif
@@ -12,14 +12,177 @@
  * The full license is in the file LICENSE, distributed with this software.   *
  ******************************************************************************
  * Creation date    : 04.02.2021                                              *
- * Modification date: 07.02.2021                                              *
+ * Modification date: 19.10.2026                                              *
  ******************************************************************************
  * LIBRARIES:                                                                 *
  ******************************************************************************/
 #include "matrices.h"
+#include "cmps_include.h"
+#include "parallel.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+#include <float.h>
+#include <limits.h>
+#include <ctype.h>
+
+/******************************************************************************
+ * EXTERNAL BLAS AND LAPACK ROUTINES                                          *
+ ******************************************************************************/
+
+#if defined(CMPS_USE_BLAS)
+extern void dgemm_(const char *transa, const char *transb, const int *m,
+    const int *n, const int *k, const double *alpha, const double *a,
+    const int *lda, const double *b, const int *ldb, const double *beta,
+    double *c, const int *ldc);
+extern void dgemv_(const char *trans, const int *m, const int *n,
+    const double *alpha, const double *a, const int *lda, const double *x,
+    const int *incx, const double *beta, double *y, const int *incy);
+#endif
+
+#if defined(CMPS_USE_LAPACK)
+extern void dgetrf_(const int *m, const int *n, double *a, const int *lda,
+    int *ipiv, int *info);
+extern void dgetrs_(const char *trans, const int *n, const int *nrhs,
+    const double *a, const int *lda, const int *ipiv, double *b,
+    const int *ldb, int *info);
+extern void dpotrf_(const char *uplo, const int *n, double *a, const int *lda,
+    int *info);
+extern void dpotrs_(const char *uplo, const int *n, const int *nrhs,
+    const double *a, const int *lda, double *b, const int *ldb, int *info);
+extern void dsyev_(const char *jobz, const char *uplo, const int *n, double *a,
+    const int *lda, double *w, double *work, const int *lwork, int *info);
+#endif
+
+/******************************************************************************
+ * AUXILIARY FUNCTIONS                                                        *
+ ******************************************************************************/
+
+#if defined(CMPS_USE_BLAS) || defined(CMPS_USE_LAPACK)
+/* a size passed to BLAS or LAPACK, which take int arguments */
+static int blasInt(const integer value)
+{
+    if (value > (integer) INT_MAX)
+    {
+        printf ("ERROR: dimension %lu exceeds the BLAS/LAPACK int range\n",
+            value);
+        exit (EXIT_FAILURE);
+    }
+
+    return (int) value;
+}
+#endif
+
+/* 'N' or 'T' for a BLAS transpose flag, in either case */
+static char transFlag(const char trans)
+{
+    const char t = (char) toupper((unsigned char) trans);
+
+    if (t == 'N')
+    {
+        return 'N';
+    }
+
+    if (t == 'T' || t == 'C')
+    {
+        return 'T';
+    }
+
+    printf ("ERROR: unknown transpose flag '%c'\n", trans);
+    exit (EXIT_FAILURE);
+}
+
+static integer leadingDimension(const integer nrows)
+{
+    const integer align = ALIGN_BYTES / sizeof(real);
+    integer ld = ((nrows + align - 1) / align) * align;
+
+    if (ld == 0)
+    {
+        return align;
+    }
+
+    /*a stride of a multiple of CONFLICT_BYTES puts every column in the same
+      cache sets*/
+    if ((ld * sizeof(real)) % CONFLICT_BYTES == 0)
+    {
+        ld += align;
+    }
+
+    return ld;
+}
+
+/* b = a^T for an m x n block of a (stride lda) into b (stride ldb) */
+static void transposeTile(const real *a, const integer lda, real *b,
+    const integer ldb, const integer m, const integer n)
+{
+    register integer i;  /*row    counter loop of a*/
+    register integer j;  /*column counter loop of a*/
+
+#if CMPS_X86_INSTR_SET >= CMPS_X86_AVX_VERSION
+    const integer m4 = m & ~((integer) 3);
+    const integer n4 = n & ~((integer) 3);
+
+    /*4 x 4 register tiles: four columns of a become four columns of b*/
+    for (j = 0; j < n4; j += 4)
+    {
+        for (i = 0; i < m4; i += 4)
+        {
+            const real *s = a + i + lda*j;
+            real       *d = b + j + ldb*i;
+
+            const __m256d c0 = _mm256_loadu_pd(s);
+            const __m256d c1 = _mm256_loadu_pd(s + lda);
+            const __m256d c2 = _mm256_loadu_pd(s + 2*lda);
+            const __m256d c3 = _mm256_loadu_pd(s + 3*lda);
+
+            const __m256d t0 = _mm256_unpacklo_pd(c0, c1);
+            const __m256d t1 = _mm256_unpackhi_pd(c0, c1);
+            const __m256d t2 = _mm256_unpacklo_pd(c2, c3);
+            const __m256d t3 = _mm256_unpackhi_pd(c2, c3);
+
+            _mm256_storeu_pd(d,         _mm256_permute2f128_pd(t0, t2, 0x20));
+            _mm256_storeu_pd(d + ldb,   _mm256_permute2f128_pd(t1, t3, 0x20));
+            _mm256_storeu_pd(d + 2*ldb, _mm256_permute2f128_pd(t0, t2, 0x31));
+            _mm256_storeu_pd(d + 3*ldb, _mm256_permute2f128_pd(t1, t3, 0x31));
+        }
+    }
+#else
+    const integer m4 = 0;
+    const integer n4 = 0;
+#endif
+
+    /*remaining rows and columns*/
+    for (j = 0; j < n; j++)
+    {
+        for (i = (j < n4) ? m4 : 0; i < m; i++)
+        {
+            b[j + ldb*i] = a[i + lda*j];
+        }
+    }
+}
+
+/* zeroes whole columns with the column schedule of the kernels (first touch) */
+static void zeroColumns(real *a, const integer ld, const integer ncols)
+{
+    register integer j;
+
+    #pragma omp parallel for PARALLEL_COLUMNS(ld * ncols)
+    for (j = 0; j < ncols; j++)
+    {
+        memset(a + ld*j, 0, ld * sizeof(real));
+    }
+}
+
+static void checkSquare(MatrixView *A, const integer nrows)
+{
+    if (A->row != A->col || A->row != nrows)
+    {
+        printf ("ERROR: matrix with inappropriate dimensions\n");
+        exit (EXIT_FAILURE);
+    }
+}
 
 /******************************************************************************
  * CONSTRUCTOR AND DESTRUCTOR                                                 *
@@ -28,21 +191,36 @@
 Matrix *makeMatrix(const integer r, const integer c)
 {
     /*initialize object's memory block*/
-    Matrix *self = (Matrix *) malloc (sizeof(Matrix));     
+    Matrix *self = (Matrix *) malloc (sizeof(Matrix));
+
+    /*verify if the object's memory block was allocated into RAM*/
+    if (self == NULL) 
+    {
+        printf ("ERROR: no free space in RAM to allocate\n");
+        exit (EXIT_FAILURE);
+    }
+
     /*row's    size*/
     self->row    = r;
     /*column's size*/                                     
     self->col    = c;
-    /*matrix initialization in the object's memory block*/                                     
-    self->matrix = (real *) malloc( r * c * sizeof(real)); 
+    /*padded column length*/
+    self->ld     = leadingDimension(r);
 
-    /*verify if the object's memory block was allocated into RAM*/
-    if (self == NULL) 
+    const size_t bytes = self->ld * (c > 0 ? c : 1) * sizeof(real);
+
+    /*matrix initialization in the object's memory block, aligned columns*/
+    self->matrix = (real *) aligned_alloc(ALIGN_BYTES, bytes);
+
+    if (self->matrix == NULL) 
     {
         printf ("ERROR: no free space in RAM to allocate\n");
         exit (EXIT_FAILURE);
     }
 
+    /*the padding is zeroed, so whole-column vector loads are defined*/
+    zeroColumns(self->matrix, self->ld, c);
+
     return self;
 }
 
@@ -58,13 +236,13 @@ void freeMatrix(Matrix *self)
 
 void copyMatrix(Matrix* __restrict src, Matrix* __restrict dst)
 {
-    memcpy(dst->matrix, src->matrix, src->row * src->col * sizeof(real));
+    copyView(viewMatrix(src), viewMatrix(dst));
 }
 
 void getColumn(Matrix* __restrict src, vector1D* __restrict dst, 
     const integer column, const integer nrows)
 {
-    memcpy(dst->x, src->matrix + column*nrows, nrows * sizeof(real));
+    memcpy(dst->x, src->matrix + column*src->ld, nrows * sizeof(real));
 }
 
 void getRow(Matrix *src, vector1D* dst, const integer row, const integer ncols)
@@ -73,7 +251,7 @@ void getRow(Matrix *src, vector1D* dst, const integer row, const integer ncols)
 
     for(j = 0; j < ncols; j++)
     {
-        dst->x[j] = *(src->matrix + row + ncols * j);
+        dst->x[j] = *(src->matrix + row + src->ld * j);
     }
 }
 
@@ -86,7 +264,7 @@ void transverseMatrix(Matrix *src)
     {
         for(j = 0; j < src->col; j++)
         {
-            printf("%g\t", src->matrix[i + src->col*j]);
+            printf("%g\t", src->matrix[i + src->ld*j]);
         }
 
         printf("\n");
@@ -96,15 +274,14 @@ void transverseMatrix(Matrix *src)
 void getConstSubmatrix(Matrix *src, Matrix *dst, const integer startRow, 
     const integer startCol)
 {
-    if(dst->row > src->row || dst->col > src->row)
+    if(dst->row > src->row || dst->col > src->col)
     {
         printf ("ERROR: sub-matrix with inappropriate dimensions\n");
         exit (EXIT_FAILURE);
     }
 
     /*verify limits of the entry values: startRow and startCol*/
-    if(startRow >= 0 &&  startCol >= 0 && startRow < src->row - 1 && 
-       startCol < src->col - 1) 
+    if(startRow + dst->row <= src->row && startCol + dst->col <= src->col) 
     {
         register integer ib;             /*row counter of matrix dst*/
         register integer jb;             /*col counter of matrix dst*/
@@ -114,8 +291,8 @@ void getConstSubmatrix(Matrix *src, Matrix *dst, const integer startRow,
         {
             for(jb = 0; jb < dst->col; jb++)
             {
-                *(dst->matrix + ib + dst->col*jb) = *(src->matrix + startRow + 
-                    ib + src->col*ja);
+                *(dst->matrix + ib + dst->ld*jb) = *(src->matrix + startRow + 
+                    ib + src->ld*ja);
 
                 ja++; /*walking along the matrix src columns*/ 
             }
@@ -132,7 +309,7 @@ void getConstSubmatrix(Matrix *src, Matrix *dst, const integer startRow,
 
 void getGeneralSubmatrix(Matrix *src, Matrix *dst, integer *row, integer *col)
 {
-    if(dst->row > src->row || dst->col > src->row)
+    if(dst->row > src->row || dst->col > src->col)
     {
         printf ("ERROR: sub-matrix with inappropriate dimensions\n");
         exit (EXIT_FAILURE);
@@ -145,15 +322,15 @@ void getGeneralSubmatrix(Matrix *src, Matrix *dst, integer *row, integer *col)
     {   
         for(jb = 0; jb < dst->col; jb++)
         {
-            *(dst->matrix + ib + dst->col * jb) = *(src->matrix + *(row + ib) + 
-                src->col * *(col + jb));
+            *(dst->matrix + ib + dst->ld * jb) = *(src->matrix + *(row + ib) + 
+                src->ld * *(col + jb));
         }
     }
 }
 
 void setGeneralSubmatrix(Matrix *dst, Matrix *src, integer *row, integer *col)
 {
-    if(src->row > dst->row || src->col > dst->row)
+    if(src->row > dst->row || src->col > dst->col)
     {
         printf ("ERROR: sub-matrix with inappropriate dimensions\n");
         exit (EXIT_FAILURE);
@@ -165,8 +342,8 @@ void setGeneralSubmatrix(Matrix *dst, Matrix *src, integer *row, integer *col)
     {   
         for(jb = 0; jb < src->col; jb++)
         {
-            *(src->matrix + *(row + ib) + src->col * *(col + jb)) = *(
-                dst->matrix + ib + dst->col * jb);
+            *(dst->matrix + *(row + ib) + dst->ld * *(col + jb)) = *(
+                src->matrix + ib + src->ld * jb);
         }
     }
 }
@@ -176,36 +353,892 @@ void setGeneralSubmatrix(Matrix *dst, Matrix *src, integer *row, integer *col)
  ******************************************************************************/
 
 void zeroMatrix(Matrix *src)
+{
+    zeroColumns(src->matrix, src->ld, src->col);
+}
+
+void identityMatrix(Matrix *src)
 {
     register integer i;  /*row    counter loop*/
     register integer j;  /*column counter loop*/
 
-    for(i = 0; i < src->row; i++)
+    #pragma omp parallel for private(i) PARALLEL_COLUMNS(src->row * src->col)
+    for(j = 0; j < src->col; j++)
     {
-        for(j = 0; j < src->col; j++)
+        for(i = 0; i < src->row; i++)
         {
-            src->matrix[i + src->col*j] = 0.0;
+            if (i == j)
+            {
+                src->matrix[i + src->ld*j] = 1.0;
+            }
+            else
+            {
+                src->matrix[i + src->ld*j] = 0.0;
+            }
         }
     }
 }
 
-void identityMatrix(Matrix *src)
+/******************************************************************************
+ * MATRIX VIEWS                                                               *
+ ******************************************************************************/
+
+MatrixView viewMatrix(Matrix *src)
+{
+    MatrixView self;
+
+    self.row    = src->row;
+    self.col    = src->col;
+    self.ld     = src->ld;
+    self.matrix = src->matrix;
+
+    return self;
+}
+
+MatrixView viewBlock(MatrixView src, const integer startRow,
+    const integer startCol, const integer nrows, const integer ncols)
+{
+    if (startRow + nrows > src.row || startCol + ncols > src.col)
+    {
+        printf ("ERROR: block outside of the viewed matrix\n");
+        exit (EXIT_FAILURE);
+    }
+
+    MatrixView self;
+
+    self.row    = nrows;
+    self.col    = ncols;
+    self.ld     = src.ld;
+    self.matrix = src.matrix + startRow + src.ld*startCol;
+
+    return self;
+}
+
+MatrixView viewRow(MatrixView src, const integer row)
+{
+    return viewBlock(src, row, 0, 1, src.col);
+}
+
+vector1D viewColumn(MatrixView src, const integer column)
+{
+    if (column >= src.col)
+    {
+        printf ("ERROR: column outside of the viewed matrix\n");
+        exit (EXIT_FAILURE);
+    }
+
+    vector1D self;
+
+    self.size = src.row;
+    self.x    = src.matrix + src.ld*column;
+
+    return self;
+}
+
+void copyView(MatrixView src, MatrixView dst)
 {
-    register integer i;  /*row    counter loop*/
     register integer j;  /*column counter loop*/
 
-    for(i = 0; i < src->row; i++)
+    if (src.row != dst.row || src.col != dst.col)
     {
-        for(j = 0; j < src->col; j++)
+        printf ("ERROR: views with different dimensions\n");
+        exit (EXIT_FAILURE);
+    }
+
+    #pragma omp parallel for PARALLEL_COLUMNS(src.row * src.col)
+    for (j = 0; j < src.col; j++)
+    {
+        memmove(dst.matrix + dst.ld*j, src.matrix + src.ld*j,
+            src.row * sizeof(real));
+    }
+}
+
+/******************************************************************************
+ * TRANSPOSITION AND GATHER                                                   *
+ ******************************************************************************/
+
+void transposeView(MatrixView src, MatrixView dst)
+{
+    integer ii, jj;  /*block counter loops*/
+
+    if (dst.row != src.col || dst.col != src.row)
+    {
+        printf ("ERROR: transpose with inappropriate dimensions\n");
+        exit (EXIT_FAILURE);
+    }
+
+    #pragma omp parallel for private(ii) PARALLEL_COLUMNS(src.row * src.col)
+    for (jj = 0; jj < src.col; jj += TRANSPOSE_BLOCK)
+    {
+        const integer n = (jj + TRANSPOSE_BLOCK < src.col) ? TRANSPOSE_BLOCK :
+            src.col - jj;
+
+        for (ii = 0; ii < src.row; ii += TRANSPOSE_BLOCK)
         {
-            if (i == j)
+            const integer m = (ii + TRANSPOSE_BLOCK < src.row) ?
+                TRANSPOSE_BLOCK : src.row - ii;
+
+            transposeTile(src.matrix + ii + src.ld*jj, src.ld,
+                dst.matrix + jj + dst.ld*ii, dst.ld, m, n);
+        }
+    }
+}
+
+void transposeMatrix(Matrix *src, Matrix *dst)
+{
+    transposeView(viewMatrix(src), viewMatrix(dst));
+}
+
+void transposeMatrixInPlace(Matrix *A)
+{
+    integer ii, jj;  /*block counter loops*/
+
+    if (A->row != A->col)
+    {
+        /*the shape changes: transpose into new storage and swap it in*/
+        Matrix *T = makeMatrix(A->col, A->row);
+
+        transposeMatrix(A, T);
+
+        free(A->matrix);
+
+        A->row    = T->row;
+        A->col    = T->col;
+        A->ld     = T->ld;
+        A->matrix = T->matrix;
+
+        free(T);
+
+        return;
+    }
+
+    const integer n  = A->row;
+    const integer ld = A->ld;
+
+    /*the block columns shrink along jj: round-robin keeps threads balanced*/
+    #pragma omp parallel for private(ii) if (n*n >= getParallelThreshold()) \
+        schedule(static, 1)
+    for (jj = 0; jj < n; jj += TRANSPOSE_BLOCK)
+    {
+        const integer nj = (jj + TRANSPOSE_BLOCK < n) ? TRANSPOSE_BLOCK :
+            n - jj;
+
+        real tile[TRANSPOSE_BLOCK * TRANSPOSE_BLOCK];
+
+        /*diagonal block, through the tile buffer*/
+        transposeTile(A->matrix + jj + ld*jj, ld, tile, TRANSPOSE_BLOCK, nj,
+            nj);
+        copyView((MatrixView) {nj, nj, TRANSPOSE_BLOCK, tile},
+            (MatrixView) {nj, nj, ld, A->matrix + jj + ld*jj});
+
+        /*off-diagonal blocks (ii, jj) and (jj, ii) swapped transposed*/
+        for (ii = jj + TRANSPOSE_BLOCK; ii < n; ii += TRANSPOSE_BLOCK)
+        {
+            const integer ni = (ii + TRANSPOSE_BLOCK < n) ? TRANSPOSE_BLOCK :
+                n - ii;
+
+            real *lower = A->matrix + ii + ld*jj;  /*ni x nj block*/
+            real *upper = A->matrix + jj + ld*ii;  /*nj x ni block*/
+
+            transposeTile(lower, ld, tile, TRANSPOSE_BLOCK, ni, nj);
+            transposeTile(upper, ld, lower, ld, nj, ni);
+            copyView((MatrixView) {nj, ni, TRANSPOSE_BLOCK, tile},
+                (MatrixView) {nj, ni, ld, upper});
+        }
+    }
+}
+
+void gatherRowsView(MatrixView src, const integer *rows, const integer nrows,
+    MatrixView dst)
+{
+    register integer j;  /*column counter loop*/
+    register integer k;  /*row    counter loop*/
+
+    if (dst.row != nrows || dst.col != src.col)
+    {
+        printf ("ERROR: gather with inappropriate dimensions\n");
+        exit (EXIT_FAILURE);
+    }
+
+    for (k = 0; k < nrows; k++)
+    {
+        if (rows[k] >= src.row)
+        {
+            printf ("ERROR: gathered row outside of the matrix\n");
+            exit (EXIT_FAILURE);
+        }
+    }
+
+    /*one column at a time: the reads stay inside a single column of src*/
+    #pragma omp parallel for private(k) PARALLEL_COLUMNS(nrows * src.col)
+    for (j = 0; j < src.col; j++)
+    {
+        const real *s = src.matrix + src.ld*j;
+        real       *d = dst.matrix + dst.ld*j;
+
+        k = 0;
+
+#if CMPS_X86_INSTR_SET >= CMPS_X86_AVX2_VERSION
+        for (; k + 4 <= nrows; k += 4)
+        {
+            const __m256i idx = _mm256_loadu_si256(
+                (const __m256i *) (rows + k));
+
+            _mm256_storeu_pd(d + k, _mm256_i64gather_pd(s,
+                idx, sizeof(real)));
+        }
+#endif
+
+        for (; k < nrows; k++)
+        {
+            d[k] = s[rows[k]];
+        }
+    }
+}
+
+void gatherRows(Matrix *src, const integer *rows, const integer nrows,
+    Matrix *dst)
+{
+    gatherRowsView(viewMatrix(src), rows, nrows, viewMatrix(dst));
+}
+
+/******************************************************************************
+ * LINEAR ALGEBRA                                                             *
+ ******************************************************************************/
+
+void gemmView(const char transA, const char transB, const real alpha,
+    MatrixView A, MatrixView B, const real beta, MatrixView C)
+{
+    const char tA = transFlag(transA);
+    const char tB = transFlag(transB);
+    const integer m   = C.row;
+    const integer n   = C.col;
+    const integer k   = (tA == 'N') ? A.col : A.row;
+    const integer lda = A.ld;
+    const integer ldb = B.ld;
+    const integer ldc = C.ld;
+
+    if ((tA == 'N' ? A.row : A.col) != m ||
+        (tB == 'N' ? B.row : B.col) != k ||
+        (tB == 'N' ? B.col : B.row) != n)
+    {
+        printf ("ERROR: matrix product with inappropriate dimensions\n");
+        exit (EXIT_FAILURE);
+    }
+
+#if defined(CMPS_USE_BLAS)
+    const int im = blasInt(m), in = blasInt(n), ik = blasInt(k);
+    const int ia = blasInt(lda), ib = blasInt(ldb), ic = blasInt(ldc);
+
+    dgemm_(&tA, &tB, &im, &in, &ik, &alpha, A.matrix, &ia,
+        B.matrix, &ib, &beta, C.matrix, &ic);
+#else
+    register integer i, j, p;    /*row, column and inner counter loops*/
+    integer ii, jj, pp;          /*block counter loops*/
+
+    /*strides of op(A)(i, p) and op(B)(p, j)*/
+    const integer ai = (tA == 'N') ? 1   : lda;
+    const integer ap = (tA == 'N') ? lda : 1;
+    const integer bp = (tB == 'N') ? 1   : ldb;
+    const integer bj = (tB == 'N') ? ldb : 1;
+
+    #pragma omp parallel for private(i) PARALLEL_COLUMNS(m * n)
+    for (j = 0; j < n; j++)
+    {
+        for (i = 0; i < m; i++)
+        {
+            C.matrix[i + ldc*j] = (beta == 0.0) ? 0.0 :
+                beta * C.matrix[i + ldc*j];
+        }
+    }
+
+    /*each thread owns whole block columns of C*/
+    #pragma omp parallel for private(i, j, p, ii, pp) \
+        PARALLEL_COLUMNS(m * n * k / MATRIX_BLOCK)
+    for (jj = 0; jj < n; jj += MATRIX_BLOCK)
+    for (pp = 0; pp < k; pp += MATRIX_BLOCK)
+    for (ii = 0; ii < m; ii += MATRIX_BLOCK)
+    {
+        const integer jEnd = (jj + MATRIX_BLOCK < n) ? jj + MATRIX_BLOCK : n;
+        const integer pEnd = (pp + MATRIX_BLOCK < k) ? pp + MATRIX_BLOCK : k;
+        const integer iEnd = (ii + MATRIX_BLOCK < m) ? ii + MATRIX_BLOCK : m;
+
+        for (j = jj; j < jEnd; j++)
+        {
+            real *c = C.matrix + ldc*j;
+
+            if (ai == 1)
             {
-                src->matrix[i + src->row*j] = 1.0;
+                /*columns of A are contiguous: axpy on the column of C*/
+                for (p = pp; p < pEnd; p++)
+                {
+                    const real  bpj = alpha * B.matrix[p*bp + j*bj];
+                    const real *a   = A.matrix + p*ap;
+
+                    for (i = ii; i < iEnd; i++)
+                    {
+                        c[i] += a[i] * bpj;
+                    }
+                }
             }
             else
             {
-                src->matrix[i + src->row*j] = 0.0;
+                /*rows of op(A) are contiguous: dot products*/
+                for (i = ii; i < iEnd; i++)
+                {
+                    const real *a   = A.matrix + i*ai;
+                    real        sum = 0.0;
+
+                    for (p = pp; p < pEnd; p++)
+                    {
+                        sum += a[p] * B.matrix[p*bp + j*bj];
+                    }
+
+                    c[i] += alpha * sum;
+                }
             }
         }
     }
+#endif
+}
+
+void gemvView(const char trans, const real alpha, MatrixView A, vector1D *x,
+    const real beta, vector1D *y)
+{
+    const char t = transFlag(trans);
+    const integer m   = A.row;
+    const integer n   = A.col;
+    const integer lda = A.ld;
+
+    if ((t == 'N' ? n : m) > x->size || (t == 'N' ? m : n) > y->size)
+    {
+        printf ("ERROR: matrix-vector product with inappropriate sizes\n");
+        exit (EXIT_FAILURE);
+    }
+
+#if defined(CMPS_USE_BLAS)
+    const int im = blasInt(m), in = blasInt(n), ia = blasInt(lda), inc = 1;
+
+    dgemv_(&t, &im, &in, &alpha, A.matrix, &ia, x->x, &inc, &beta,
+        y->x, &inc);
+#else
+    register integer i;  /*row    counter loop*/
+    register integer j;  /*column counter loop*/
+    integer ii;          /*block  counter loop*/
+
+    if (t == 'N')
+    {
+        /*each thread owns a block of rows of y and sweeps every column*/
+        #pragma omp parallel for private(i, j) PARALLEL_COLUMNS(m * n)
+        for (ii = 0; ii < m; ii += MATRIX_BLOCK)
+        {
+            const integer iEnd = (ii + MATRIX_BLOCK < m) ? ii + MATRIX_BLOCK :
+                m;
+
+            for (i = ii; i < iEnd; i++)
+            {
+                y->x[i] = (beta == 0.0) ? 0.0 : beta * y->x[i];
+            }
+
+            for (j = 0; j < n; j++)
+            {
+                const real *a  = A.matrix + lda*j;
+                const real  xj = alpha * x->x[j];
+
+                for (i = ii; i < iEnd; i++)
+                {
+                    y->x[i] += a[i] * xj;
+                }
+            }
+        }
+    }
+    else
+    {
+        #pragma omp parallel for private(i) PARALLEL_COLUMNS(m * n)
+        for (j = 0; j < n; j++)
+        {
+            const real *a   = A.matrix + lda*j;
+            real        sum = 0.0;
+
+            for (i = 0; i < m; i++)
+            {
+                sum += a[i] * x->x[i];
+            }
+
+            y->x[j] = alpha * sum + ((beta == 0.0) ? 0.0 : beta * y->x[j]);
+        }
+    }
+#endif
+}
+
+int luFactorView(MatrixView A, int *ipiv)
+{
+    const integer n   = A.row;
+    const integer lda = A.ld;
+
+    checkSquare(&A, n);
+
+#if defined(CMPS_USE_LAPACK)
+    const int in = blasInt(n), ia = blasInt(lda);
+    int info;
+
+    dgetrf_(&in, &in, A.matrix, &ia, ipiv, &info);
+
+    return info;
+#else
+    register integer i, j, k;
+    real *a = A.matrix;
+    int info = 0;
+
+    for (k = 0; k < n; k++)
+    {
+        integer p = k;
+
+        /*partial pivoting on the largest entry of the column*/
+        for (i = k + 1; i < n; i++)
+        {
+            if (fabs(a[i + lda*k]) > fabs(a[p + lda*k]))
+            {
+                p = i;
+            }
+        }
+
+        ipiv[k] = (int) (p + 1);
+
+        if (a[p + lda*k] == 0.0)
+        {
+            info = (info == 0) ? (int) (k + 1) : info;
+            continue;
+        }
+
+        if (p != k)
+        {
+            for (j = 0; j < n; j++)
+            {
+                const real t = a[k + lda*j];
+                a[k + lda*j] = a[p + lda*j];
+                a[p + lda*j] = t;
+            }
+        }
+
+        const real inv = 1.0 / a[k + lda*k];
+
+        for (i = k + 1; i < n; i++)
+        {
+            a[i + lda*k] *= inv;
+        }
+
+        /*rank-one update of the trailing matrix, column by column*/
+        #pragma omp parallel for private(i) \
+            PARALLEL_COLUMNS((n - k) * (n - k))
+        for (j = k + 1; j < n; j++)
+        {
+            const real akj = a[k + lda*j];
+
+            for (i = k + 1; i < n; i++)
+            {
+                a[i + lda*j] -= a[i + lda*k] * akj;
+            }
+        }
+    }
+
+    return info;
+#endif
+}
+
+void luSolveView(MatrixView LU, const int *ipiv, MatrixView B)
+{
+    const integer n   = LU.row;
+    const integer lda = LU.ld;
+    const integer ldb = B.ld;
+
+    checkSquare(&LU, B.row);
+
+#if defined(CMPS_USE_LAPACK)
+    const int in = blasInt(n), nrhs = blasInt(B.col), ia = blasInt(lda);
+    const int ib = blasInt(ldb);
+    int info;
+
+    dgetrs_("N", &in, &nrhs, LU.matrix, &ia, ipiv, B.matrix, &ib, &info);
+#else
+    register integer i, j, k;
+    const real *a = LU.matrix;
+
+    /*the right-hand sides are independent*/
+    #pragma omp parallel for private(i, k) PARALLEL_COLUMNS(n * n * B.col)
+    for (j = 0; j < B.col; j++)
+    {
+        real *b = B.matrix + ldb*j;
+
+        /*row interchanges*/
+        for (k = 0; k < n; k++)
+        {
+            const integer p = (integer) ipiv[k] - 1;
+
+            if (p != k)
+            {
+                const real t = b[k];
+                b[k] = b[p];
+                b[p] = t;
+            }
+        }
+
+        /*forward substitution with the unit lower triangle*/
+        for (k = 0; k < n; k++)
+        {
+            for (i = k + 1; i < n; i++)
+            {
+                b[i] -= a[i + lda*k] * b[k];
+            }
+        }
+
+        /*backward substitution with the upper triangle*/
+        for (k = n; k-- > 0;)
+        {
+            b[k] /= a[k + lda*k];
+
+            for (i = 0; i < k; i++)
+            {
+                b[i] -= a[i + lda*k] * b[k];
+            }
+        }
+    }
+#endif
+}
+
+int choleskyFactorView(MatrixView A)
+{
+    const integer n   = A.row;
+    const integer lda = A.ld;
+
+    checkSquare(&A, n);
+
+#if defined(CMPS_USE_LAPACK)
+    const int in = blasInt(n), ia = blasInt(lda);
+    int info;
+
+    dpotrf_("L", &in, A.matrix, &ia, &info);
+
+    return info;
+#else
+    register integer i, j, k;
+    real *a = A.matrix;
+
+    for (k = 0; k < n; k++)
+    {
+        const real d = a[k + lda*k];
+
+        if (d <= 0.0)
+        {
+            return (int) (k + 1);
+        }
+
+        const real lkk = sqrt(d);
+
+        a[k + lda*k] = lkk;
+
+        for (i = k + 1; i < n; i++)
+        {
+            a[i + lda*k] /= lkk;
+        }
+
+        /*update of the trailing lower triangle*/
+        #pragma omp parallel for private(i) \
+            PARALLEL_COLUMNS((n - k) * (n - k) / 2)
+        for (j = k + 1; j < n; j++)
+        {
+            const real ljk = a[j + lda*k];
+
+            for (i = j; i < n; i++)
+            {
+                a[i + lda*j] -= a[i + lda*k] * ljk;
+            }
+        }
+    }
+
+    return 0;
+#endif
+}
+
+void choleskySolveView(MatrixView L, MatrixView B)
+{
+    const integer n   = L.row;
+    const integer lda = L.ld;
+    const integer ldb = B.ld;
+
+    checkSquare(&L, B.row);
+
+#if defined(CMPS_USE_LAPACK)
+    const int in = blasInt(n), nrhs = blasInt(B.col), ia = blasInt(lda);
+    const int ib = blasInt(ldb);
+    int info;
+
+    dpotrs_("L", &in, &nrhs, L.matrix, &ia, B.matrix, &ib, &info);
+#else
+    register integer i, j, k;
+    const real *a = L.matrix;
+
+    #pragma omp parallel for private(i, k) PARALLEL_COLUMNS(n * n * B.col)
+    for (j = 0; j < B.col; j++)
+    {
+        real *b = B.matrix + ldb*j;
+
+        /*L y = b*/
+        for (k = 0; k < n; k++)
+        {
+            b[k] /= a[k + lda*k];
+
+            for (i = k + 1; i < n; i++)
+            {
+                b[i] -= a[i + lda*k] * b[k];
+            }
+        }
+
+        /*L^T x = y*/
+        for (k = n; k-- > 0;)
+        {
+            real sum = b[k];
+
+            for (i = k + 1; i < n; i++)
+            {
+                sum -= a[i + lda*k] * b[i];
+            }
+
+            b[k] = sum / a[k + lda*k];
+        }
+    }
+#endif
+}
+
+int solveView(MatrixView A, MatrixView B)
+{
+    int *ipiv = (int *) malloc((A.row > 0 ? A.row : 1) * sizeof(int));
+
+    if (ipiv == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate\n");
+        exit (EXIT_FAILURE);
+    }
+
+    const int info = luFactorView(A, ipiv);
+
+    if (info == 0)
+    {
+        luSolveView(A, ipiv, B);
+    }
+
+    free(ipiv);
+
+    return info;
+}
+
+int eigenSymmetricView(MatrixView A, vector1D *w)
+{
+    const integer n   = A.row;
+    const integer lda = A.ld;
+
+    checkSquare(&A, n);
+
+    if (w->size < n)
+    {
+        printf ("ERROR: eigenvalue vector with inappropriate size\n");
+        exit (EXIT_FAILURE);
+    }
+
+#if defined(CMPS_USE_LAPACK)
+    const int in = blasInt(n), ia = blasInt(lda);
+    int  info, lwork = -1;
+    real query;
+
+    /*workspace query*/
+    dsyev_("V", "L", &in, A.matrix, &ia, w->x, &query, &lwork, &info);
+
+    lwork = (int) query;
+
+    real *work = (real *) malloc((lwork > 0 ? lwork : 1) * sizeof(real));
+
+    if (work == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate\n");
+        exit (EXIT_FAILURE);
+    }
+
+    dsyev_("V", "L", &in, A.matrix, &ia, w->x, work, &lwork, &info);
+
+    free(work);
+
+    return info;
+#else
+    register integer i, p, q;
+    integer sweep;
+
+    real *a = A.matrix;
+    real *v = (real *) malloc((n > 0 ? n*n : 1) * sizeof(real));
+
+    if (v == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate\n");
+        exit (EXIT_FAILURE);
+    }
+
+    real norm = 0.0;
+
+    for (q = 0; q < n; q++)
+    {
+        for (p = 0; p < n; p++)
+        {
+            v[p + n*q] = (p == q) ? 1.0 : 0.0;
+            norm      += a[p + lda*q] * a[p + lda*q];
+        }
+    }
+
+    const real tol = DBL_EPSILON * DBL_EPSILON * norm;
+    int info = 1;
+
+    /*cyclic Jacobi sweeps until the off-diagonal part vanishes*/
+    for (sweep = 0; sweep < 100; sweep++)
+    {
+        real off = 0.0;
+
+        for (q = 1; q < n; q++)
+        {
+            for (p = 0; p < q; p++)
+            {
+                off += a[p + lda*q] * a[p + lda*q];
+            }
+        }
+
+        if (off <= tol)
+        {
+            info = 0;
+            break;
+        }
+
+        for (q = 1; q < n; q++)
+        for (p = 0; p < q; p++)
+        {
+            const real apq = a[p + lda*q];
+
+            if (apq == 0.0)
+            {
+                continue;
+            }
+
+            const real theta = (a[q + lda*q] - a[p + lda*p]) / (2.0 * apq);
+            const real t     = ((theta >= 0.0) ? 1.0 : -1.0) /
+                (fabs(theta) + sqrt(theta*theta + 1.0));
+            const real c     = 1.0 / sqrt(t*t + 1.0);
+            const real s     = t * c;
+
+            /*A <- A J: columns p and q*/
+            for (i = 0; i < n; i++)
+            {
+                const real aip = a[i + lda*p];
+                const real aiq = a[i + lda*q];
+
+                a[i + lda*p] = c*aip - s*aiq;
+                a[i + lda*q] = s*aip + c*aiq;
+            }
+
+            /*A <- J^T A: rows p and q*/
+            for (i = 0; i < n; i++)
+            {
+                const real api = a[p + lda*i];
+                const real aqi = a[q + lda*i];
+
+                a[p + lda*i] = c*api - s*aqi;
+                a[q + lda*i] = s*api + c*aqi;
+            }
+
+            /*V <- V J*/
+            for (i = 0; i < n; i++)
+            {
+                const real vip = v[i + n*p];
+                const real viq = v[i + n*q];
+
+                v[i + n*p] = c*vip - s*viq;
+                v[i + n*q] = s*vip + c*viq;
+            }
+        }
+    }
+
+    for (p = 0; p < n; p++)
+    {
+        w->x[p] = a[p + lda*p];
+    }
+
+    /*ascending order, eigenvectors copied back into A*/
+    for (p = 0; p < n; p++)
+    {
+        integer m = p;
+
+        for (q = p + 1; q < n; q++)
+        {
+            m = (w->x[q] < w->x[m]) ? q : m;
+        }
+
+        const real t = w->x[p];
+        w->x[p] = w->x[m];
+        w->x[m] = t;
+
+        for (i = 0; i < n; i++)
+        {
+            const real vt = v[i + n*p];
+            v[i + n*p]    = v[i + n*m];
+            v[i + n*m]    = vt;
+        }
+    }
+
+    for (q = 0; q < n; q++)
+    {
+        memcpy(a + lda*q, v + n*q, n * sizeof(real));
+    }
+
+    free(v);
+
+    return info;
+#endif
+}
+
+void gemmMatrix(const char transA, const char transB, const real alpha,
+    Matrix *A, Matrix *B, const real beta, Matrix *C)
+{
+    gemmView(transA, transB, alpha, viewMatrix(A), viewMatrix(B), beta,
+        viewMatrix(C));
+}
+
+void gemvMatrix(const char trans, const real alpha, Matrix *A, vector1D *x,
+    const real beta, vector1D *y)
+{
+    gemvView(trans, alpha, viewMatrix(A), x, beta, y);
+}
+
+int luFactorMatrix(Matrix *A, int *ipiv)
+{
+    return luFactorView(viewMatrix(A), ipiv);
+}
+
+void luSolveMatrix(Matrix *LU, const int *ipiv, Matrix *B)
+{
+    luSolveView(viewMatrix(LU), ipiv, viewMatrix(B));
+}
+
+int choleskyFactorMatrix(Matrix *A)
+{
+    return choleskyFactorView(viewMatrix(A));
+}
+
+void choleskySolveMatrix(Matrix *L, Matrix *B)
+{
+    choleskySolveView(viewMatrix(L), viewMatrix(B));
+}
+
+int solveMatrix(Matrix *A, Matrix *B)
+{
+    return solveView(viewMatrix(A), viewMatrix(B));
+}
+
+int eigenSymmetricMatrix(Matrix *A, vector1D *w)
+{
+    return eigenSymmetricView(viewMatrix(A), w);
 }
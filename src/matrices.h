@@ -1,12 +1,12 @@
 /******************************************************************************
  *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
- *                                MATRICES.H                                   *
+ *                                MATRICES.H                                  *
  ******************************************************************************
  * Author: Almério José Venâncio Pains Soares Pamplona                        *
  * E-mail: almeriopamplona@gmail.com                                          *
  ******************************************************************************
  * Creation date    : 04.02.2021                                              *
- * Modification date: 07.02.2021                                              *
+ * Modification date: 19.10.2026                                              *
  ******************************************************************************
  * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
  *                                                                            *
@@ -19,6 +19,31 @@
  * In the present script, matrices objects are created with some general      *
  * purpouse functions to manipulate them.                                     *
  *                                                                            *
+ * The matrices are stored column by column, element (i, j) at                *
+ * matrix[i + ld*j], as BLAS and LAPACK do. The leading dimension ld is the   *
+ * number of rows padded so that every column starts on an ALIGN_BYTES        *
+ * boundary, and padded once more when the column stride is a multiple of     *
+ * CONFLICT_BYTES, which would map the columns onto the same cache sets.      *
+ *                                                                            *
+ * The linear algebra routines call the Fortran BLAS when CMPS_USE_BLAS is    *
+ * defined and LAPACK when CMPS_USE_LAPACK is defined (both set by CMake when *
+ * the libraries are found); otherwise a portable implementation, cache       *
+ * blocked for the products, is used.                                         *
+ *                                                                            *
+ * A MatrixView references a block, a row or the whole of a matrix without    *
+ * copying it, and every linear algebra routine has a View form working on    *
+ * such blocks in place. A column view is a plain vector1D that can be passed *
+ * to the vector functions; views own no memory and are never freed.          *
+ *                                                                            *
+ * Rows are strided in this layout: the transposition works on cache-sized    *
+ * tiles, split into 4 x 4 register tiles with AVX, and several rows are      *
+ * gathered at once column by column (with the AVX2 gather instruction)       *
+ * rather than one strided element at a time.                                 *
+ *                                                                            *
+ * Without BLAS and LAPACK the routines are threaded over columns (over row   *
+ * blocks for the product with a vector), as described in parallel.h; the     *
+ * constructor zeroes the columns with the same schedule.                     *
+ *                                                                            *
  ******************************************************************************/
 
 #ifndef __MATRICES_H__
@@ -30,6 +55,14 @@
  * MEMORY ALIGN                                                               *
  ******************************************************************************/
 #define ALIGN_BYTES             128
+#define CONFLICT_BYTES          4096  /* column strides multiple of it are   */
+                                      /* padded to avoid cache-set conflicts */
+
+/******************************************************************************
+ * CACHE BLOCKING                                                             *
+ ******************************************************************************/
+#define MATRIX_BLOCK            64    /* tile size of the portable products  */
+#define TRANSPOSE_BLOCK         32    /* tile size of the transposition      */
 
 /******************************************************************************
  * TYPE DEFINITIONS                                                           *
@@ -46,10 +79,22 @@ typedef struct Matrix
 {
     integer row;
     integer col;
+    integer ld;        /* leading dimension, row padded to ALIGN_BYTES */
     real    *matrix;
 
 } Matrix;
 
+/* non-owning reference to a block of a matrix, column (j) at matrix + ld*j */
+
+typedef struct MatrixView
+{
+    integer row;
+    integer col;
+    integer ld;        /* distance between the starts of two columns */
+    real    *matrix;
+
+} MatrixView;
+
 /******************************************************************************
  * CONSTRUCTOR, DESTRUCTOR                                                    *
  ******************************************************************************/
@@ -58,7 +103,8 @@ typedef struct Matrix
  * Function:    makeMatrix                                                    *
  * -------------------------------------------------------------------------- *
  * description: creates a struct Matrix object initializing it with malloc,   *
- *              as also the matrix element.                                   *
+ *              as also the matrix element, aligned to ALIGN_BYTES with       *
+ *              padded columns and filled with zeros.                         *
  * -------------------------------------------------------------------------- *
  * input:  const integer row   // total number of rows                        *
  *         const integer col   // total number of columns                     *
@@ -157,15 +203,15 @@ void getConstSubmatrix(Matrix *src, Matrix *dst, const integer startRow,
 void getGeneralSubmatrix(Matrix *src, Matrix *dst, integer *row, integer *col);
 
 /******************************************************************************
- * Function:    getGeneralSubmatrix                                           *
+ * Function:    setGeneralSubmatrix                                           *
  * -------------------------------------------------------------------------- *
- * description: copies a sub-matrix from a source sub-matrix into a destine   *
- *              matrix.                                                       *
+ * description: copies a source sub-matrix into the given rows and columns of *
+ *              a destine matrix.                                             *
  * -------------------------------------------------------------------------- *
- * input:  Matrix        *dst   // source  sub-matrix                         *
- *         Matrix        *src   // destine matrix                             *
- *         const integer *row   // array with all the desired rows from dst   *
- *         const integer *col   // array with all the desired cols form dst   *
+ * input:  Matrix        *dst   // destine matrix                             *
+ *         Matrix        *src   // source  sub-matrix                         *
+ *         const integer *row   // array with all the desired rows of dst     *
+ *         const integer *col   // array with all the desired cols of dst     *
  * -------------------------------------------------------------------------- *
  * output: void                                                               *
  ******************************************************************************/
@@ -209,4 +255,252 @@ void zeroMatrix(Matrix *src);
  ******************************************************************************/
 void identityMatrix(Matrix *src);
 
+/******************************************************************************
+ * MATRIX VIEWS                                                               *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    viewMatrix                                                    *
+ * -------------------------------------------------------------------------- *
+ * description: view of a whole matrix.                                       *
+ * -------------------------------------------------------------------------- *
+ * input:  Matrix *src   // viewed matrix                                     *
+ * -------------------------------------------------------------------------- *
+ * output: MatrixView    // view sharing the storage of src                   *
+ ******************************************************************************/
+MatrixView viewMatrix(Matrix *src);
+
+/******************************************************************************
+ * Function:    viewBlock                                                     *
+ * -------------------------------------------------------------------------- *
+ * description: view of the block of nrows x ncols elements starting at       *
+ *              (startRow, startCol) of another view.                         *
+ * -------------------------------------------------------------------------- *
+ * input:  MatrixView    src        // viewed matrix                          *
+ *         const integer startRow   // first row    of the block              *
+ *         const integer startCol   // first column of the block              *
+ *         const integer nrows      // number of rows    of the block         *
+ *         const integer ncols      // number of columns of the block         *
+ * -------------------------------------------------------------------------- *
+ * output: MatrixView               // view of the block                      *
+ ******************************************************************************/
+MatrixView viewBlock(MatrixView src, const integer startRow,
+    const integer startCol, const integer nrows, const integer ncols);
+
+/******************************************************************************
+ * Function:    viewRow                                                       *
+ * -------------------------------------------------------------------------- *
+ * description: view of one row, a 1 x col block with stride ld.              *
+ * -------------------------------------------------------------------------- *
+ * input:  MatrixView    src   // viewed matrix                               *
+ *         const integer row   // desired row                                 *
+ * -------------------------------------------------------------------------- *
+ * output: MatrixView          // view of the row                             *
+ ******************************************************************************/
+MatrixView viewRow(MatrixView src, const integer row);
+
+/******************************************************************************
+ * Function:    viewColumn                                                    *
+ * -------------------------------------------------------------------------- *
+ * description: view of one column as a vector1D, which must not be freed.    *
+ * -------------------------------------------------------------------------- *
+ * input:  MatrixView    src      // viewed matrix                            *
+ *         const integer column   // desired column                           *
+ * -------------------------------------------------------------------------- *
+ * output: vector1D               // contiguous column of src                 *
+ ******************************************************************************/
+vector1D viewColumn(MatrixView src, const integer column);
+
+/******************************************************************************
+ * Function:    copyView                                                      *
+ * -------------------------------------------------------------------------- *
+ * description: copies the elements of a view into another view of the same   *
+ *              dimensions, column by column.                                 *
+ * -------------------------------------------------------------------------- *
+ * input:  MatrixView src   // source  view                                   *
+ *         MatrixView dst   // destine view                                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void copyView(MatrixView src, MatrixView dst);
+
+/******************************************************************************
+ * TRANSPOSITION AND GATHER                                                   *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    transposeMatrix, transposeView                                *
+ * -------------------------------------------------------------------------- *
+ * description: out-of-place transposition dst = src^T, by tiles of           *
+ *              TRANSPOSE_BLOCK x TRANSPOSE_BLOCK elements.                   *
+ * -------------------------------------------------------------------------- *
+ * input:  Matrix(View) src   // source  matrix                               *
+ *         Matrix(View) dst   // destine matrix, not overlapping src          *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void transposeMatrix(Matrix *src, Matrix *dst);
+void transposeView(MatrixView src, MatrixView dst);
+
+/******************************************************************************
+ * Function:    transposeMatrixInPlace                                        *
+ * -------------------------------------------------------------------------- *
+ * description: in-place transposition. Square matrices swap their tiles      *
+ *              through a stack buffer; rectangular ones are transposed into  *
+ *              new storage, which replaces the old one.                      *
+ * -------------------------------------------------------------------------- *
+ * input:  Matrix *A   // matrix, overwritten by its transpose                *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void transposeMatrixInPlace(Matrix *A);
+
+/******************************************************************************
+ * Function:    gatherRows, gatherRowsView                                    *
+ * -------------------------------------------------------------------------- *
+ * description: copies the rows rows[0..nrows) of src into the rows of dst,   *
+ *              dst(k, j) = src(rows[k], j), streaming one column at a time.  *
+ * -------------------------------------------------------------------------- *
+ * input:  Matrix(View)   src     // source  matrix                           *
+ *         const integer *rows    // rows of src to gather                    *
+ *         const integer  nrows   // number of gathered rows                  *
+ *         Matrix(View)   dst     // destine matrix, nrows x src->col         *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void gatherRows(Matrix *src, const integer *rows, const integer nrows,
+    Matrix *dst);
+void gatherRowsView(MatrixView src, const integer *rows, const integer nrows,
+    MatrixView dst);
+
+/******************************************************************************
+ * LINEAR ALGEBRA                                                             *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    gemmMatrix, gemmView                                          *
+ * -------------------------------------------------------------------------- *
+ * description: general matrix product C = alpha op(A) op(B) + beta C, where  *
+ *              op(X) is X for 'N' and its transpose for 'T' (or 'C'); the    *
+ *              flags are accepted in either case and any other is an error.  *
+ * -------------------------------------------------------------------------- *
+ * input:  const char  transA   // 'N' or 'T'                                 *
+ *         const char  transB   // 'N' or 'T'                                 *
+ *         const real  alpha    // scale of the product                       *
+ *         Matrix(View) A       // left  operand                              *
+ *         Matrix(View) B       // right operand                              *
+ *         const real  beta     // scale of C                                 *
+ *         Matrix(View) C       // result, distinct from A and B              *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void gemmMatrix(const char transA, const char transB, const real alpha,
+    Matrix *A, Matrix *B, const real beta, Matrix *C);
+void gemmView(const char transA, const char transB, const real alpha,
+    MatrixView A, MatrixView B, const real beta, MatrixView C);
+
+/******************************************************************************
+ * Function:    gemvMatrix, gemvView                                          *
+ * -------------------------------------------------------------------------- *
+ * description: matrix-vector product y = alpha op(A) x + beta y, with the    *
+ *              transpose flag read as in gemmView.                           *
+ * -------------------------------------------------------------------------- *
+ * input:  const char  trans   // 'N' or 'T'                                  *
+ *         const real  alpha   // scale of the product                        *
+ *         Matrix(View) A      // matrix                                      *
+ *         vector1D   *x       // input vector                                *
+ *         const real  beta    // scale of y                                  *
+ *         vector1D   *y       // result, distinct from x                     *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void gemvMatrix(const char trans, const real alpha, Matrix *A, vector1D *x,
+    const real beta, vector1D *y);
+void gemvView(const char trans, const real alpha, MatrixView A, vector1D *x,
+    const real beta, vector1D *y);
+
+/******************************************************************************
+ * Function:    luFactorMatrix, luFactorView                                  *
+ * -------------------------------------------------------------------------- *
+ * description: LU factorisation with partial pivoting, P A = L U, in place.  *
+ *              The pivots are 1-based, as in LAPACK.                         *
+ * -------------------------------------------------------------------------- *
+ * input:  Matrix(View) A   // square matrix, overwritten by L and U          *
+ *         int    *ipiv     // row interchanges, size A->row                  *
+ * -------------------------------------------------------------------------- *
+ * output: int              // 0, or k > 0 if U(k, k) is exactly zero         *
+ ******************************************************************************/
+int luFactorMatrix(Matrix *A, int *ipiv);
+int luFactorView(MatrixView A, int *ipiv);
+
+/******************************************************************************
+ * Function:    luSolveMatrix, luSolveView                                    *
+ * -------------------------------------------------------------------------- *
+ * description: solves A X = B with the factors of luFactorMatrix.            *
+ * -------------------------------------------------------------------------- *
+ * input:  Matrix(View) LU   // factors of luFactorMatrix                     *
+ *         const int *ipiv   // pivots  of luFactorMatrix                     *
+ *         Matrix(View) B    // right-hand sides, overwritten by X            *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void luSolveMatrix(Matrix *LU, const int *ipiv, Matrix *B);
+void luSolveView(MatrixView LU, const int *ipiv, MatrixView B);
+
+/******************************************************************************
+ * Function:    choleskyFactorMatrix, choleskyFactorView                      *
+ * -------------------------------------------------------------------------- *
+ * description: Cholesky factorisation A = L L^T of a symmetric positive      *
+ *              definite matrix. L overwrites the lower triangle of A; the    *
+ *              strict upper triangle is not referenced.                      *
+ * -------------------------------------------------------------------------- *
+ * input:  Matrix(View) A   // symmetric positive definite matrix             *
+ * -------------------------------------------------------------------------- *
+ * output: int              // 0, or k > 0 if minor k is not positive         *
+ ******************************************************************************/
+int choleskyFactorMatrix(Matrix *A);
+int choleskyFactorView(MatrixView A);
+
+/******************************************************************************
+ * Function:    choleskySolveMatrix, choleskySolveView                        *
+ * -------------------------------------------------------------------------- *
+ * description: solves A X = B with the factor of choleskyFactorMatrix.       *
+ * -------------------------------------------------------------------------- *
+ * input:  Matrix(View) L   // factor of choleskyFactorMatrix                 *
+ *         Matrix(View) B   // right-hand sides, overwritten by X             *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void choleskySolveMatrix(Matrix *L, Matrix *B);
+void choleskySolveView(MatrixView L, MatrixView B);
+
+/******************************************************************************
+ * Function:    solveMatrix, solveView                                        *
+ * -------------------------------------------------------------------------- *
+ * description: solves the general system A X = B by LU factorisation.        *
+ * -------------------------------------------------------------------------- *
+ * input:  Matrix(View) A   // square matrix, overwritten by its LU factors   *
+ *         Matrix(View) B   // right-hand sides, overwritten by X             *
+ * -------------------------------------------------------------------------- *
+ * output: int              // 0, or k > 0 if A is singular                   *
+ ******************************************************************************/
+int solveMatrix(Matrix *A, Matrix *B);
+int solveView(MatrixView A, MatrixView B);
+
+/******************************************************************************
+ * Function:    eigenSymmetricMatrix, eigenSymmetricView                      *
+ * -------------------------------------------------------------------------- *
+ * description: eigenvalues and eigenvectors of a symmetric matrix. The       *
+ *              eigenvalues are sorted in ascending order and column k of A   *
+ *              becomes the normalised eigenvector of w[k]. The fallback uses *
+ *              the cyclic Jacobi method.                                     *
+ * -------------------------------------------------------------------------- *
+ * input:  Matrix(View) A   // symmetric matrix, overwritten by eigenvectors  *
+ *         vector1D *w      // eigenvalues, size A->row                       *
+ * -------------------------------------------------------------------------- *
+ * output: int              // 0, or > 0 if the iteration did not converge    *
+ ******************************************************************************/
+int eigenSymmetricMatrix(Matrix *A, vector1D *w);
+int eigenSymmetricView(MatrixView A, vector1D *w);
+
 #endif
@@ -0,0 +1,649 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                              NEIGHBOURS.C                                  *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "neighbours.h"
+#include "particles.h"
+
+#include <stdio.h>  /*input and output variable manipulation*/
+#include <stdlib.h> /*address and memory manipulation*/
+#include <math.h>   /*mathematical functions*/
+
+/******************************************************************************
+ * AUXILIARY FUNCTIONS                                                        *
+ ******************************************************************************/
+
+static integer clampCell(const real x, const real xmin, const real size,
+    const integer n)
+{
+    const real c = floor((x - xmin) / size);
+
+    if (c < 0.0)
+    {
+        return 0;
+    }
+
+    return (c >= (real) n) ? n - 1 : (integer) c;
+}
+
+/* cell of a point; in 2D every particle lies in the first layer of cells */
+static inline integer cellOf(cellGrid *grid, const real x, const real y,
+    const real z, const integer dim)
+{
+    const integer ix = clampCell(x, grid->xmin, grid->size, grid->nx);
+    const integer iy = clampCell(y, grid->ymin, grid->size, grid->ny);
+    const integer iz = (dim == 3) ?
+        clampCell(z, grid->zmin, grid->size, grid->nz) : 0;
+
+    return ix + grid->nx * (iy + grid->ny * iz);
+}
+
+static integer *growIndices(integer *old, const integer size)
+{
+    integer *self = (integer *) realloc(old, (size > 0 ? size : 1) *
+        sizeof(integer));
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the cell grid\n");
+        exit (EXIT_FAILURE);
+    }
+
+    return self;
+}
+
+static integer cellsAlong(const real min, const real max, const real size)
+{
+    return (integer) ceil((max - min) / size) + 1;
+}
+
+/* sets the grid dimensions, growing cellStart if the box needs more cells */
+static void resizeCellGrid(cellGrid *grid, const integer nx, const integer ny,
+    const integer nz)
+{
+    const real ncells = (real) nx * (real) ny * (real) nz;
+
+    if (ncells > (real) grid->maxCells)
+    {
+        printf ("ERROR: the cell grid needs %.0f cells, more than the limit "
+            "of %lu\n", ncells, grid->maxCells);
+        exit (EXIT_FAILURE);
+    }
+
+    grid->nx = nx;
+    grid->ny = ny;
+    grid->nz = nz;
+
+    if (nx * ny * nz > grid->cellCapacity)
+    {
+        const integer grown = (integer) (GROWTH * grid->cellCapacity);
+        const integer n     = (grown > nx*ny*nz) ? grown : nx*ny*nz;
+
+        grid->cellCapacity = (n < grid->maxCells) ? n : grid->maxCells;
+        grid->cellStart    = growIndices(grid->cellStart,
+            grid->cellCapacity + 1);
+    }
+}
+
+/* cells around (x, y, z) holding the neighbours, bounds included; a single
+   layer of cells in 2D: 9 cells instead of 27 */
+static inline void cellWindow(cellGrid *grid, const real x, const real y,
+    const real z, integer lo[3], integer hi[3], const integer dim)
+{
+    const integer ix = clampCell(x, grid->xmin, grid->size, grid->nx);
+    const integer iy = clampCell(y, grid->ymin, grid->size, grid->ny);
+    const integer iz = (dim == 3) ?
+        clampCell(z, grid->zmin, grid->size, grid->nz) : 0;
+
+    lo[0] = (ix > 0) ? ix - 1 : 0;
+    lo[1] = (iy > 0) ? iy - 1 : 0;
+    lo[2] = (dim == 3 && iz > 0) ? iz - 1 : iz;
+    hi[0] = (ix + 1 < grid->nx) ? ix + 1 : grid->nx - 1;
+    hi[1] = (iy + 1 < grid->ny) ? iy + 1 : grid->ny - 1;
+    hi[2] = (dim == 3 && iz + 1 < grid->nz) ? iz + 1 : iz;
+}
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+cellGrid *makeCellGrid(const real min[3], const real max[3], const real size,
+    const integer np)
+{
+    cellGrid *self = (cellGrid *) malloc(sizeof(cellGrid));
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the object\n");
+        exit (EXIT_FAILURE);
+    }
+
+    self->xmin          = min[0];
+    self->ymin          = min[1];
+    self->zmin          = min[2];
+    self->size          = size;
+    self->maxCells      = CELLS_MAX;
+    self->cellCapacity  = 0;
+    self->cellStart     = NULL;
+    self->capacity      = np;
+    self->cellParticles = growIndices(NULL, np);
+
+    resizeCellGrid(self, cellsAlong(min[0], max[0], size),
+        cellsAlong(min[1], max[1], size), cellsAlong(min[2], max[2], size));
+
+    return self;
+}
+
+void freeCellGrid(cellGrid *self)
+{
+    free(self->cellStart);
+    free(self->cellParticles);
+    free(self);
+}
+
+void fitCellGrid(cellGrid *grid, fluid *particles, parameters *par)
+{
+    register integer i;
+
+    if (par->np == 0)
+    {
+        return;
+    }
+
+    real min[3] = {particles->r.x[0], particles->r.y[0], 0.0};
+    real max[3] = {particles->r.x[0], particles->r.y[0], 0.0};
+
+    if (par->dim == 3)
+    {
+        min[2] = max[2] = particles->r.z[0];
+    }
+
+    for (i = 1; i < par->np; i++)
+    {
+        min[0] = fmin(min[0], particles->r.x[i]);
+        max[0] = fmax(max[0], particles->r.x[i]);
+        min[1] = fmin(min[1], particles->r.y[i]);
+        max[1] = fmax(max[1], particles->r.y[i]);
+
+        if (par->dim == 3)
+        {
+            min[2] = fmin(min[2], particles->r.z[i]);
+            max[2] = fmax(max[2], particles->r.z[i]);
+        }
+    }
+
+    const real    pad = grid->size;
+    const integer nz  = (par->dim == 3) ?
+        cellsAlong(min[2] - pad, max[2] + pad, grid->size) : 1;
+
+    grid->xmin = min[0] - pad;
+    grid->ymin = min[1] - pad;
+    grid->zmin = (par->dim == 3) ? min[2] - pad : 0.0;
+
+    resizeCellGrid(grid, cellsAlong(grid->xmin, max[0] + pad, grid->size),
+        cellsAlong(grid->ymin, max[1] + pad, grid->size), nz);
+}
+
+/******************************************************************************
+ * NEIGHBOUR SEARCH                                                           *
+ ******************************************************************************/
+
+integer cellIndex(cellGrid *grid, const real x, const real y, const real z)
+{
+    return cellOf(grid, x, y, z, 3);
+}
+
+static inline void buildCellGridDim(cellGrid *grid, fluid *particles,
+    parameters *par, const integer dim)
+{
+    register integer i; /*particle counter loop*/
+    register integer c; /*cell     counter loop*/
+
+    const integer ncells = grid->nx * grid->ny * grid->nz;
+
+    if (par->np > grid->capacity)
+    {
+        const integer grown = (integer) (GROWTH * grid->capacity);
+
+        grid->capacity      = (grown > par->np) ? grown : par->np;
+        grid->cellParticles = growIndices(grid->cellParticles,
+            grid->capacity);
+    }
+
+    for (c = 0; c <= ncells; c++)
+    {
+        grid->cellStart[c] = 0;
+    }
+
+    /*count the particles of each cell*/
+    for (i = 0; i < par->np; i++)
+    {
+        c = cellOf(grid, particles->r.x[i], particles->r.y[i],
+            (dim == 3) ? particles->r.z[i] : 0.0, dim);
+        grid->cellStart[c + 1]++;
+    }
+
+    for (c = 0; c < ncells; c++)
+    {
+        grid->cellStart[c + 1] += grid->cellStart[c];
+    }
+
+    /*scatter the particles, using the cell ends as running counters*/
+    for (i = 0; i < par->np; i++)
+    {
+        c = cellOf(grid, particles->r.x[i], particles->r.y[i],
+            (dim == 3) ? particles->r.z[i] : 0.0, dim);
+        grid->cellParticles[grid->cellStart[c]++] = i;
+    }
+
+    /*restore the cell starts*/
+    for (c = ncells; c > 0; c--)
+    {
+        grid->cellStart[c] = grid->cellStart[c - 1];
+    }
+
+    grid->cellStart[0] = 0;
+}
+
+void buildCellGrid(cellGrid *grid, fluid *particles, parameters *par)
+{
+    DIM_DISPATCH(par->dim, buildCellGridDim, grid, particles, par);
+}
+
+static inline void countNeighboursDim(cellGrid *grid, fluid *particles,
+    parameters *par, const integer begin, const integer end,
+    const integer dim)
+{
+    long i; /*particle counter loop, signed for OpenMP*/
+
+    const long np   = (long) par->np;
+    const real reS2 = par->reS * par->reS;
+    const real reL2 = par->reL * par->reL;
+
+    #pragma omp parallel for schedule(static)
+    for (i = 0; i < np; i++)
+    {
+        integer nS = 0;
+        integer nL = 0;
+
+        if ((integer) i >= begin && (integer) i < end)
+        {
+            const real xi = particles->r.x[i];
+            const real yi = particles->r.y[i];
+            const real zi = (dim == 3) ? particles->r.z[i] : 0.0;
+
+            integer lo[3], hi[3];
+            integer cx, cy, cz, k;
+
+            cellWindow(grid, xi, yi, zi, lo, hi, dim);
+
+            for (cz = lo[2]; cz <= hi[2]; cz++)
+            for (cy = lo[1]; cy <= hi[1]; cy++)
+            for (cx = lo[0]; cx <= hi[0]; cx++)
+            {
+                const integer c = cx + grid->nx * (cy + grid->ny * cz);
+
+                for (k = grid->cellStart[c]; k < grid->cellStart[c + 1]; k++)
+                {
+                    const integer j = grid->cellParticles[k];
+
+                    const real dx = particles->r.x[j] - xi;
+                    const real dy = particles->r.y[j] - yi;
+                    const real dz = (dim == 3) ? particles->r.z[j] - zi : 0.0;
+                    const real d2 = dx*dx + dy*dy + dz*dz;
+
+                    nL += (j != (integer) i && d2 < reL2) ? 1 : 0;
+                    nS += (j != (integer) i && d2 < reS2) ? 1 : 0;
+                }
+            }
+        }
+
+        particles->nNeighS.arr[i] = nS;
+        particles->nNeighL.arr[i] = nL;
+    }
+
+    /*exclusive prefix sum: the slots of every particle, reserved at once*/
+    integer oS = 0;
+    integer oL = 0;
+
+    for (i = 0; i < np; i++)
+    {
+        particles->startS.arr[i] = oS;
+        particles->startL.arr[i] = oL;
+
+        oS += particles->nNeighS.arr[i];
+        oL += particles->nNeighL.arr[i];
+    }
+
+    reserveNeighbours(particles, oS, oL);
+}
+
+static inline void searchNeighboursDim(cellGrid *grid, fluid *particles,
+    parameters *par, const integer begin, const integer end,
+    const weightFunction *wS, const weightFunction *wL, const integer dim)
+{
+    register integer i; /*particle  counter loop*/
+    register integer k; /*neighbour counter loop*/
+
+    const real reS2 = par->reS * par->reS;
+    const real reL2 = par->reL * par->reL;
+
+    for (i = begin; i < end; i++)
+    {
+        const real xi = particles->r.x[i];
+        const real yi = particles->r.y[i];
+        const real zi = (dim == 3) ? particles->r.z[i] : 0.0;
+
+        /*the slots laid out by countNeighbours*/
+        const integer oS   = particles->startS.arr[i];
+        const integer oL   = particles->startL.arr[i];
+        const integer maxS = particles->nNeighS.arr[i];
+        const integer maxL = particles->nNeighL.arr[i];
+
+        integer lo[3], hi[3];
+        integer nS = 0;
+        integer nL = 0;
+        integer cx, cy, cz;
+
+        cellWindow(grid, xi, yi, zi, lo, hi, dim);
+
+        for (cz = lo[2]; cz <= hi[2]; cz++)
+        for (cy = lo[1]; cy <= hi[1]; cy++)
+        for (cx = lo[0]; cx <= hi[0]; cx++)
+        {
+            const integer c = cx + grid->nx * (cy + grid->ny * cz);
+
+            for (k = grid->cellStart[c]; k < grid->cellStart[c + 1]; k++)
+            {
+                const integer j = grid->cellParticles[k];
+
+                if (j == i)
+                {
+                    continue;
+                }
+
+                const real dx = particles->r.x[j] - xi;
+                const real dy = particles->r.y[j] - yi;
+                const real dz = (dim == 3) ? particles->r.z[j] - zi : 0.0;
+                const real d2 = dx*dx + dy*dy + dz*dz;
+
+                if (d2 >= reL2)
+                {
+                    continue;
+                }
+
+                /*the lists of the other particles follow: never overrun*/
+                if (nL == maxL || (d2 < reS2 && nS == maxS))
+                {
+                    printf ("ERROR: neighbour lists of particle %lu not laid "
+                            "out by countNeighbours\n", i);
+                    exit (EXIT_FAILURE);
+                }
+
+                /*squared distances for now: no sqrt in the cell loops*/
+                particles->neighL.arr[oL + nL] = j;
+                particles->dNeighL.x[oL + nL]  = d2;
+                nL++;
+
+                if (d2 < reS2)
+                {
+                    particles->neighS.arr[oS + nS] = j;
+                    particles->dNeighS.x[oS + nS]  = d2;
+                    nS++;
+                }
+            }
+        }
+
+        real *dS = particles->dNeighS.x + oS;
+        real *dL = particles->dNeighL.x + oL;
+
+        if (wL != NULL)
+        {
+            particles->pndS.x[i] = weightSum(wS, dS, nS);
+            particles->pndL.x[i] = weightSum(wL, dL, nL);
+        }
+
+        /*the operators read distances: one contiguous pass per list*/
+        #pragma omp simd
+        for (k = 0; k < nS; k++)
+        {
+            dS[k] = sqrt(dS[k]);
+        }
+
+        #pragma omp simd
+        for (k = 0; k < nL; k++)
+        {
+            dL[k] = sqrt(dL[k]);
+        }
+
+        particles->nNeighS.arr[i] = nS;
+        particles->nNeighL.arr[i] = nL;
+    }
+}
+
+void countNeighbours(cellGrid *grid, fluid *particles, parameters *par,
+    const integer begin, const integer end)
+{
+    DIM_DISPATCH(par->dim, countNeighboursDim, grid, particles, par, begin,
+        end);
+}
+
+void searchNeighboursRange(cellGrid *grid, fluid *particles, parameters *par,
+    const integer begin, const integer end)
+{
+    DIM_DISPATCH(par->dim, searchNeighboursDim, grid, particles, par, begin,
+        end, NULL, NULL);
+}
+
+void searchNeighbours(cellGrid *grid, fluid *particles, parameters *par)
+{
+    buildCellGrid(grid, particles, par);
+    countNeighbours(grid, particles, par, 0, par->np);
+    searchNeighboursRange(grid, particles, par, 0, par->np);
+}
+
+/******************************************************************************
+ * PARTICLE NUMBER DENSITY                                                    *
+ ******************************************************************************/
+
+void computeInitialDensity(parameters *par)
+{
+    const int m  = (int) ceil(par->reL / par->l0) + 1;
+    const int mz = (par->dim == 3) ? m : 0;
+
+    real sumW  = 0.0; /*sum of w(r)     with the large radius*/
+    real sumR2 = 0.0; /*sum of r^2 w(r) with the large radius*/
+    int  ix, iy, iz;
+
+    par->n0S = 0.0;
+    par->n0L = 0.0;
+
+    for (iz = -mz; iz <= mz; iz++)
+    for (iy = -m;  iy <= m;  iy++)
+    for (ix = -m;  ix <= m;  ix++)
+    {
+        const real r = par->l0 * sqrt((real) (ix*ix + iy*iy + iz*iz));
+        const real w = weight(r, par->reL);
+
+        par->n0S += weight(r, par->reS);
+        par->n0L += w;
+        sumW     += w;
+        sumR2    += r * r * w;
+    }
+
+    par->lambda = sumR2 / sumW;
+}
+
+/* the operators sum weight() with reS and reL: the pnd must match them */
+static void checkOperatorKernel(parameters *par, const weightFunction *wS,
+    const weightFunction *wL)
+{
+    if (wS->kernel != WEIGHT_STANDARD || wL->kernel != WEIGHT_STANDARD)
+    {
+        printf ("ERROR: the MPS operators use the standard weight kernel\n");
+        exit (EXIT_FAILURE);
+    }
+
+    if (wS->re != par->reS || wL->re != par->reL)
+    {
+        printf ("ERROR: the weight functions must have the radii reS and "
+                "reL\n");
+        exit (EXIT_FAILURE);
+    }
+}
+
+void computeInitialDensityWeight(parameters *par, const weightFunction *wS,
+    const weightFunction *wL)
+{
+    const int m  = (int) ceil(par->reL / par->l0) + 1;
+    const int mz = (par->dim == 3) ? m : 0;
+
+    real sumW  = 0.0; /*sum of w(r)     with the large radius*/
+    real sumR2 = 0.0; /*sum of r^2 w(r) with the large radius*/
+    int  ix, iy, iz;
+
+    checkOperatorKernel(par, wS, wL);
+
+    par->n0S = 0.0;
+    par->n0L = 0.0;
+
+    for (iz = -mz; iz <= mz; iz++)
+    for (iy = -m;  iy <= m;  iy++)
+    for (ix = -m;  ix <= m;  ix++)
+    {
+        const real q = par->l0 * par->l0 * (real) (ix*ix + iy*iy + iz*iz);
+        const real w = (q > 0.0) ? weightSq(wL, q) : 0.0;
+
+        par->n0S += (q > 0.0) ? weightSq(wS, q) : 0.0;
+        par->n0L += w;
+        sumW     += w;
+        sumR2    += q * w;
+    }
+
+    par->lambda = sumR2 / sumW;
+}
+
+real latticeDensity(const weightFunction *wf, const real l0,
+    const integer dim)
+{
+    const int m  = (int) ceil(wf->re / l0) + 1;
+    const int mz = (dim == 3) ? m : 0;
+
+    real n0 = 0.0;
+    int  ix, iy, iz;
+
+    for (iz = -mz; iz <= mz; iz++)
+    for (iy = -m;  iy <= m;  iy++)
+    for (ix = -m;  ix <= m;  ix++)
+    {
+        const real q = l0 * l0 * (real) (ix*ix + iy*iy + iz*iz);
+
+        /*the particle itself is not its own neighbour*/
+        n0 += (q > 0.0) ? weightSq(wf, q) : 0.0;
+    }
+
+    return n0;
+}
+
+void computePnd(fluid *particles, parameters *par)
+{
+    computePndRange(particles, par, 0, par->np);
+}
+
+void computePndRange(fluid *particles, parameters *par, const integer begin,
+    const integer end)
+{
+    register integer i; /*particle  counter loop*/
+    register integer k; /*neighbour counter loop*/
+
+    for (i = begin; i < end; i++)
+    {
+        const real *dS = particles->dNeighS.x + particles->startS.arr[i];
+        const real *dL = particles->dNeighL.x + particles->startL.arr[i];
+
+        real nS = 0.0;
+        real nL = 0.0;
+
+        for (k = 0; k < particles->nNeighS.arr[i]; k++)
+        {
+            nS += weight(dS[k], par->reS);
+        }
+
+        for (k = 0; k < particles->nNeighL.arr[i]; k++)
+        {
+            nL += weight(dL[k], par->reL);
+        }
+
+        particles->pndS.x[i] = nS;
+        particles->pndL.x[i] = nL;
+    }
+}
+
+void searchNeighboursWeight(cellGrid *grid, fluid *particles,
+    parameters *par, const weightFunction *wS, const weightFunction *wL)
+{
+    checkOperatorKernel(par, wS, wL);
+
+    buildCellGrid(grid, particles, par);
+    countNeighbours(grid, particles, par, 0, par->np);
+    DIM_DISPATCH(par->dim, searchNeighboursDim, grid, particles, par, 0,
+        par->np, wS, wL);
+}
+
+/******************************************************************************
+ * THREAD POOL STAGES                                                         *
+ ******************************************************************************/
+
+typedef struct neighbourRange
+{
+    cellGrid   *grid;        /* cell grid, NULL for the pnd                   */
+    fluid      *particles;   /* fluid particles                               */
+    parameters *par;         /* simulation parameters                         */
+
+} neighbourRange;
+
+static void searchRangeTask(void *arg, const integer begin, const integer end)
+{
+    neighbourRange *r = (neighbourRange *) arg;
+
+    searchNeighboursRange(r->grid, r->particles, r->par, begin, end);
+}
+
+static void pndRangeTask(void *arg, const integer begin, const integer end)
+{
+    neighbourRange *r = (neighbourRange *) arg;
+
+    computePndRange(r->particles, r->par, begin, end);
+}
+
+void searchNeighboursPool(threadPool *pool, cellGrid *grid, fluid *particles,
+    parameters *par)
+{
+    neighbourRange r = {grid, particles, par};
+
+    buildCellGrid(grid, particles, par);
+    countNeighbours(grid, particles, par, 0, par->np);
+    parallelFor(pool, 0, par->np, 0, searchRangeTask, &r);
+}
+
+void computePndPool(threadPool *pool, fluid *particles, parameters *par)
+{
+    neighbourRange r = {NULL, particles, par};
+
+    parallelFor(pool, 0, par->np, 0, pndRangeTask, &r);
+}
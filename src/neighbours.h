@@ -0,0 +1,332 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                              NEIGHBOURS.H                                  *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Neighbour search with a uniform cell grid whose edge is the large          *
+ * effective radius, and the particle number density with the weight          *
+ * functions of weight.h.                                                     *
+ * The grid has no compile-time size: it is sized from the case, can be refit *
+ * to the particles' bounding box and grows with the number of particles, up  *
+ * to the runtime limit maxCells.                                             *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __NEIGHBOURS_H__
+#define __NEIGHBOURS_H__
+
+#include "structures.h"
+#include "weight.h"
+#include "threadpool.h"
+
+/******************************************************************************
+ * PREPROCESSOR DEFINITIONS                                                   *
+ ******************************************************************************/
+
+#define CELLS_MAX (1UL << 26) // default limit on the number of cells
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+typedef struct cellGrid
+{
+    integer  nx, ny, nz;        /* number of cells in each direction          */
+    real     xmin, ymin, zmin;  /* lower corner of the grid                   */
+    real     size;              /* cell edge                                  */
+    integer *cellStart;         /* first particle of each cell, ncells + 1    */
+    integer *cellParticles;     /* particle indices sorted by cell            */
+    integer  capacity;          /* number of slots in cellParticles           */
+    integer  cellCapacity;      /* number of slots in cellStart minus one     */
+    integer  maxCells;          /* largest number of cells allowed            */
+
+} cellGrid;
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    makeCellGrid                                                  *
+ * -------------------------------------------------------------------------- *
+ * description: creates a cell grid covering the box [min, max] with cells    *
+ *              of edge size, sized for np particles. The limit maxCells is   *
+ *              set to CELLS_MAX and may be changed before fitCellGrid.       *
+ * -------------------------------------------------------------------------- *
+ * input:  const real    min[3]   // lower corner of the domain               *
+ *         const real    max[3]   // upper corner of the domain               *
+ *         const real    size     // cell edge, usually the reL               *
+ *         const integer np       // initial number of particles              *
+ * -------------------------------------------------------------------------- *
+ * output: cellGrid *self                                                     *
+ ******************************************************************************/
+cellGrid *makeCellGrid(const real min[3], const real max[3], const real size,
+    const integer np);
+
+/******************************************************************************
+ * Function:    freeCellGrid                                                  *
+ * -------------------------------------------------------------------------- *
+ * description: deallocates the cell grid and the object itself.              *
+ * -------------------------------------------------------------------------- *
+ * input:  cellGrid *self   // cell grid                                      *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void freeCellGrid(cellGrid *self);
+
+/******************************************************************************
+ * Function:    fitCellGrid                                                   *
+ * -------------------------------------------------------------------------- *
+ * description: moves and resizes the grid to the bounding box of the         *
+ *              particles, padded by one cell on each side, so that the       *
+ *              particles leaving the initial box keep their own cells. The   *
+ *              cell array grows when needed and the run stops if the box     *
+ *              needs more than maxCells cells. In 2D the grid has one layer. *
+ * -------------------------------------------------------------------------- *
+ * input:  cellGrid   *grid        // cell grid                               *
+ *         fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void fitCellGrid(cellGrid *grid, fluid *particles, parameters *par);
+
+/******************************************************************************
+ * NEIGHBOUR SEARCH                                                           *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    cellIndex                                                     *
+ * -------------------------------------------------------------------------- *
+ * description: returns the cell containing the point (x, y, z). Points out   *
+ *              of the grid are attributed to the nearest boundary cell.      *
+ * -------------------------------------------------------------------------- *
+ * input:  cellGrid  *grid      // cell grid                                  *
+ *         const real x, y, z   // point coordinates                          *
+ * -------------------------------------------------------------------------- *
+ * output: integer              // cell index                                 *
+ ******************************************************************************/
+integer cellIndex(cellGrid *grid, const real x, const real y, const real z);
+
+/******************************************************************************
+ * Function:    buildCellGrid                                                 *
+ * -------------------------------------------------------------------------- *
+ * description: sorts the particles by cell with a counting sort. In 2D the   *
+ *              z coordinate is not read and every particle is put in the     *
+ *              first layer of cells. The particle slots grow with par->np.   *
+ * -------------------------------------------------------------------------- *
+ * input:  cellGrid   *grid        // cell grid                               *
+ *         fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void buildCellGrid(cellGrid *grid, fluid *particles, parameters *par);
+
+/******************************************************************************
+ * Function:    searchNeighbours                                              *
+ * -------------------------------------------------------------------------- *
+ * description: builds the cell grid and fills the neighbour lists, counts    *
+ *              and distances for the small and the large effective radius.   *
+ *              The 2D variant visits 9 cells instead of 27 and never reads   *
+ *              the z coordinates.                                            *
+ * -------------------------------------------------------------------------- *
+ * input:  cellGrid   *grid        // cell grid with edge >= reL              *
+ *         fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void searchNeighbours(cellGrid *grid, fluid *particles, parameters *par);
+
+/******************************************************************************
+ * Function:    countNeighbours                                               *
+ * -------------------------------------------------------------------------- *
+ * description: lays out the neighbour lists from a cell grid already built   *
+ *              with buildCellGrid: counts the neighbours of the particles    *
+ *              [begin, end), gives the other particles of par->np empty      *
+ *              lists, stores the exclusive prefix sums of the counts in      *
+ *              startS and startL and reserves the lists once. It is called   *
+ *              once, before searchNeighboursRange runs on the range.         *
+ * -------------------------------------------------------------------------- *
+ * input:  cellGrid     *grid        // cell grid built for the particles     *
+ *         fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // simulation parameters                 *
+ *         const integer begin       // first particle with neighbours        *
+ *         const integer end         // one past the last one                 *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void countNeighbours(cellGrid *grid, fluid *particles, parameters *par,
+    const integer begin, const integer end);
+
+/******************************************************************************
+ * Function:    searchNeighboursRange                                         *
+ * -------------------------------------------------------------------------- *
+ * description: fills the neighbour lists of the particles [begin, end) at    *
+ *              the slots laid out by countNeighbours, with the same grid and *
+ *              positions. Nothing is allocated and the lists of the other    *
+ *              particles are left alone, so disjoint ranges may be filled    *
+ *              concurrently, e.g. from the ranges of a parallelFor.          *
+ * -------------------------------------------------------------------------- *
+ * input:  cellGrid     *grid        // cell grid built for the particles     *
+ *         fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // simulation parameters                 *
+ *         const integer begin       // first particle of the range           *
+ *         const integer end         // one past the last particle            *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void searchNeighboursRange(cellGrid *grid, fluid *particles, parameters *par,
+    const integer begin, const integer end);
+
+/******************************************************************************
+ * PARTICLE NUMBER DENSITY                                                    *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    computeInitialDensity                                         *
+ * -------------------------------------------------------------------------- *
+ * description: computes n0S, n0L and lambda for a regular lattice of spacing *
+ *              l0 in par->dim dimensions.                                    *
+ * -------------------------------------------------------------------------- *
+ * input:  parameters *par   // simulation parameters                         *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void computeInitialDensity(parameters *par);
+
+/******************************************************************************
+ * Function:    computeInitialDensityWeight                                   *
+ * -------------------------------------------------------------------------- *
+ * description: computeInitialDensity with the weight functions wS and wL,    *
+ *              e.g. tabulated, so that n0S and n0L match the pnd of          *
+ *              searchNeighboursWeight. The operators normalise their sums    *
+ *              of weight() by n0S, n0L and lambda: wS and wL must be         *
+ *              WEIGHT_STANDARD kernels of radii reS and reL, any method.     *
+ * -------------------------------------------------------------------------- *
+ * input:  parameters           *par   // simulation parameters               *
+ *         const weightFunction *wS    // small-radius weight function        *
+ *         const weightFunction *wL    // large-radius weight function        *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void computeInitialDensityWeight(parameters *par, const weightFunction *wS,
+    const weightFunction *wL);
+
+/******************************************************************************
+ * Function:    latticeDensity                                                *
+ * -------------------------------------------------------------------------- *
+ * description: returns the particle number density of a regular lattice of   *
+ *              spacing l0 with any weight function, e.g. the reference of a  *
+ *              polynomial or spline pnd summed with weightSum. It leaves the *
+ *              n0S, n0L and lambda of the operators alone.                   *
+ * -------------------------------------------------------------------------- *
+ * input:  const weightFunction *wf    // weight function                     *
+ *         const real            l0    // lattice spacing                     *
+ *         const integer         dim   // number of dimensions                *
+ * -------------------------------------------------------------------------- *
+ * output: real                        // lattice particle number density     *
+ ******************************************************************************/
+real latticeDensity(const weightFunction *wf, const real l0,
+    const integer dim);
+
+/******************************************************************************
+ * Function:    computePnd                                                    *
+ * -------------------------------------------------------------------------- *
+ * description: computes pndS and pndL from the cached neighbour distances.   *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void computePnd(fluid *particles, parameters *par);
+
+/******************************************************************************
+ * Function:    computePndRange                                               *
+ * -------------------------------------------------------------------------- *
+ * description: computePnd restricted to the particles [begin, end).          *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // simulation parameters                 *
+ *         const integer begin       // first particle of the range           *
+ *         const integer end         // one past the last particle            *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void computePndRange(fluid *particles, parameters *par, const integer begin,
+    const integer end);
+
+/******************************************************************************
+ * Function:    searchNeighboursWeight                                        *
+ * -------------------------------------------------------------------------- *
+ * description: searchNeighbours that also computes pndS and pndL with the    *
+ *              weight functions wS and wL. The squared distances of each     *
+ *              particle are fed to weightSum as the search finds them, so    *
+ *              the pnd takes no square root; the distances of the lists are  *
+ *              then taken in one vectorised pass. As the operators compare   *
+ *              the pnd with n0S and n0L, wS and wL are restricted as in      *
+ *              computeInitialDensityWeight, which n0S and n0L come from.     *
+ * -------------------------------------------------------------------------- *
+ * input:  cellGrid             *grid        // cell grid with edge >= reL    *
+ *         fluid                *particles   // fluid particles               *
+ *         parameters           *par         // simulation parameters         *
+ *         const weightFunction *wS          // small-radius weight function  *
+ *         const weightFunction *wL          // large-radius weight function  *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void searchNeighboursWeight(cellGrid *grid, fluid *particles,
+    parameters *par, const weightFunction *wS, const weightFunction *wL);
+
+/******************************************************************************
+ * THREAD POOL STAGES                                                         *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    searchNeighboursPool                                          *
+ * -------------------------------------------------------------------------- *
+ * description: searchNeighbours with the lists filled by a parallelFor of    *
+ *              the pool: the grid and the layout of the lists are built by   *
+ *              the calling thread, then searchNeighboursRange runs on the    *
+ *              ranges of the loop.                                           *
+ * -------------------------------------------------------------------------- *
+ * input:  threadPool *pool        // thread pool                             *
+ *         cellGrid   *grid        // cell grid with edge >= reL              *
+ *         fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void searchNeighboursPool(threadPool *pool, cellGrid *grid, fluid *particles,
+    parameters *par);
+
+/******************************************************************************
+ * Function:    computePndPool                                                *
+ * -------------------------------------------------------------------------- *
+ * description: computePnd with computePndRange run on the ranges of a        *
+ *              parallelFor of the pool.                                      *
+ * -------------------------------------------------------------------------- *
+ * input:  threadPool *pool        // thread pool                             *
+ *         fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void computePndPool(threadPool *pool, fluid *particles, parameters *par);
+
+#endif
@@ -0,0 +1,62 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                               PARALLEL.C                                   *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "parallel.h"
+
+#ifdef _OPENMP
+#include <omp.h>    /*number of threads*/
+#endif
+
+/******************************************************************************
+ * GLOBAL VARIABLES                                                           *
+ ******************************************************************************/
+
+static integer threshold = PARALLEL_THRESHOLD;
+
+/******************************************************************************
+ * GENERAL PURPOSE METHODS                                                    *
+ ******************************************************************************/
+
+void setParallelThreshold(const integer n)
+{
+    threshold = n;
+}
+
+integer getParallelThreshold(void)
+{
+    return threshold;
+}
+
+integer parallelThreads(void)
+{
+#ifdef _OPENMP
+    return (integer) omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+integer parallelChunk(const integer n, const integer bytes)
+{
+    const integer threads = parallelThreads();
+    const integer line  = (bytes < CACHE_LINE) ? CACHE_LINE / bytes : 1;
+    const integer share = (n + threads - 1) / threads;
+
+    return ((share + line - 1) / line) * line + (share == 0 ? line : 0);
+}
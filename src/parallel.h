@@ -0,0 +1,107 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                               PARALLEL.H                                   *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Threaded execution layer of the vector, array and matrix kernels. The      *
+ * loops are OpenMP work-sharing loops with a static schedule, so a thread    *
+ * always gets the same range of a given array: the constructors initialise   *
+ * the arrays with the same schedule, and the pages are first touched by the  *
+ * thread that will use them. The element loops are split into chunks of      *
+ * whole cache lines and the matrix loops into columns. Below a tunable       *
+ * number of elements the loops run serially. The loops set no binding: the   *
+ * pinning that keeps the first touch useful is left to OMP_PROC_BIND and     *
+ * OMP_PLACES, e.g. OMP_PROC_BIND=spread OMP_PLACES=cores.                    *
+ * Without OpenMP the kernels are serial.                                     *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __PARALLEL_H__
+#define __PARALLEL_H__
+
+#include "vectors.h"
+
+/******************************************************************************
+ * PREPROCESSOR DEFINITIONS                                                   *
+ ******************************************************************************/
+
+#define CACHE_LINE         64     // bytes of a cache line
+#define PARALLEL_THRESHOLD 32768  // default elements below which loops are serial
+
+/* clauses of an element loop over n items of the given size in bytes */
+#define PARALLEL_CHUNKS(n, bytes)                                              \
+    if ((n) >= getParallelThreshold())                                         \
+    schedule(static, parallelChunk((n), (bytes)))
+
+/* clauses of a column loop of a matrix with the given number of elements */
+#define PARALLEL_COLUMNS(work)                                                 \
+    if ((work) >= getParallelThreshold()) schedule(static)
+
+/******************************************************************************
+ * GENERAL PURPOSE METHODS                                                    *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    setParallelThreshold                                          *
+ * -------------------------------------------------------------------------- *
+ * description: sets the number of elements below which the kernels run       *
+ *              serially. The default is PARALLEL_THRESHOLD.                  *
+ * -------------------------------------------------------------------------- *
+ * input:  const integer n   // threshold in elements, 0 always threads       *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void setParallelThreshold(const integer n);
+
+/******************************************************************************
+ * Function:    getParallelThreshold                                          *
+ * -------------------------------------------------------------------------- *
+ * description: returns the number of elements below which the kernels run    *
+ *              serially.                                                     *
+ * -------------------------------------------------------------------------- *
+ * input:  void                                                               *
+ * -------------------------------------------------------------------------- *
+ * output: integer            // threshold in elements                        *
+ ******************************************************************************/
+integer getParallelThreshold(void);
+
+/******************************************************************************
+ * Function:    parallelThreads                                               *
+ * -------------------------------------------------------------------------- *
+ * description: returns the number of threads of the next parallel loop, 1    *
+ *              without OpenMP.                                               *
+ * -------------------------------------------------------------------------- *
+ * input:  void                                                               *
+ * -------------------------------------------------------------------------- *
+ * output: integer            // number of threads                            *
+ ******************************************************************************/
+integer parallelThreads(void);
+
+/******************************************************************************
+ * Function:    parallelChunk                                                 *
+ * -------------------------------------------------------------------------- *
+ * description: returns the static chunk of a loop over n elements: the share *
+ *              of each thread rounded up to whole cache lines, so two        *
+ *              threads never write to the same line.                         *
+ * -------------------------------------------------------------------------- *
+ * input:  const integer n       // number of elements                        *
+ *         const integer bytes   // size of an element                        *
+ * -------------------------------------------------------------------------- *
+ * output: integer               // elements per chunk                        *
+ ******************************************************************************/
+integer parallelChunk(const integer n, const integer bytes);
+
+#endif
@@ -0,0 +1,336 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                               PARTICLES.C                                  *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "particles.h"
+#include "parallel.h"
+
+#include <stdio.h>  /*input and output variable manipulation*/
+#include <stdlib.h> /*address and memory manipulation*/
+#include <string.h>
+
+/******************************************************************************
+ * AUXILIARY FUNCTIONS                                                        *
+ ******************************************************************************/
+
+static void *allocate(const integer size)
+{
+    void *self = calloc(size > 0 ? size : 1, 1);
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the fluid\n");
+        exit (EXIT_FAILURE);
+    }
+
+    return self;
+}
+
+/* cache-line aligned storage, so the chunks of two threads share no line */
+static void *allocLines(const integer bytes)
+{
+    const integer size = ((bytes + CACHE_LINE - 1) / CACHE_LINE) * CACHE_LINE;
+
+    void *self = aligned_alloc(CACHE_LINE, size > 0 ? size : CACHE_LINE);
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the fluid\n");
+        exit (EXIT_FAILURE);
+    }
+
+    return self;
+}
+
+/* the fields are zeroed with the schedule of the kernels (first touch) */
+static void allocIntArray(intArray *a, const integer size)
+{
+    a->size = size;
+    a->arr  = (integer *) allocLines(size * sizeof(integer));
+
+    zeroIntArray(a, size);
+}
+
+static void allocVector1D(vector1D *v, const integer size)
+{
+    v->size = size;
+    v->x    = (real *) allocLines(size * sizeof(real));
+
+    zeroVector1D(v);
+}
+
+static void allocVector3D(vector3D *v, const integer size)
+{
+    v->size = size;
+    v->x    = (real *) allocLines(size * sizeof(real));
+    v->y    = (real *) allocLines(size * sizeof(real));
+    v->z    = (real *) allocLines(size * sizeof(real));
+
+    zeroVector3D(v);
+}
+
+/* a grown field is first touched as a new one, then the old values copied */
+static void growIntArray(intArray *a, const integer size)
+{
+    intArray grown;
+
+    allocIntArray(&grown, size);
+    memcpy(grown.arr, a->arr,
+        ((a->size < size) ? a->size : size) * sizeof(integer));
+    free(a->arr);
+
+    *a = grown;
+}
+
+static void growVector1D(vector1D *v, const integer size)
+{
+    vector1D grown;
+
+    allocVector1D(&grown, size);
+    memcpy(grown.x, v->x, ((v->size < size) ? v->size : size) * sizeof(real));
+    free(v->x);
+
+    *v = grown;
+}
+
+static void growVector3D(vector3D *v, const integer size)
+{
+    const integer old = ((v->size < size) ? v->size : size) * sizeof(real);
+
+    vector3D grown;
+
+    allocVector3D(&grown, size);
+    memcpy(grown.x, v->x, old);
+    memcpy(grown.y, v->y, old);
+    memcpy(grown.z, v->z, old);
+    free(v->x);
+    free(v->y);
+    free(v->z);
+
+    *v = grown;
+}
+
+static void permuteReal(real *a, const integer *perm, const integer np,
+    real *tmp)
+{
+    register integer k;
+
+    for (k = 0; k < np; k++)
+    {
+        tmp[k] = a[perm[k]];
+    }
+
+    memcpy(a, tmp, np * sizeof(real));
+}
+
+static void permuteInteger(integer *a, const integer *perm, const integer np,
+    integer *tmp)
+{
+    register integer k;
+
+    for (k = 0; k < np; k++)
+    {
+        tmp[k] = a[perm[k]];
+    }
+
+    memcpy(a, tmp, np * sizeof(integer));
+}
+
+static void permuteVector3D(vector3D *v, const integer *perm, 
+    const integer np, real *tmp)
+{
+    permuteReal(v->x, perm, np, tmp);
+    permuteReal(v->y, perm, np, tmp);
+    permuteReal(v->z, perm, np, tmp);
+}
+
+static void freeVector3DFields(vector3D *v)
+{
+    free(v->x);
+    free(v->y);
+    free(v->z);
+}
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+fluid *makeFluid(const integer np)
+{
+    fluid *self = (fluid *) allocate(sizeof(fluid));
+
+    allocIntArray(&self->index,   np);
+    allocIntArray(&self->idMat,   np);
+    allocIntArray(&self->type,    np);
+    allocIntArray(&self->neighS,  0);
+    allocIntArray(&self->neighL,  0);
+    allocIntArray(&self->nNeighS, np);
+    allocIntArray(&self->nNeighL, np);
+    allocIntArray(&self->startS,  np);
+    allocIntArray(&self->startL,  np);
+
+    allocVector1D(&self->pressure,    np);
+    allocVector1D(&self->pressurek0,  np);
+    allocVector1D(&self->temperature, np);
+    allocVector1D(&self->pndS,        np);
+    allocVector1D(&self->pndL,        np);
+    allocVector1D(&self->pndB,        np);
+    allocVector1D(&self->pndMat,      np);
+    allocVector1D(&self->dNeighS,     0);
+    allocVector1D(&self->dNeighL,     0);
+
+    allocVector3D(&self->r,      np);
+    allocVector3D(&self->rn,     np);
+    allocVector3D(&self->dr,     np);
+    allocVector3D(&self->u,      np);
+    allocVector3D(&self->un,     np);
+    allocVector3D(&self->du,     np);
+    allocVector3D(&self->normal, np);
+
+    self->capacity = np;
+
+    return self;
+}
+
+void reserveFluid(fluid *self, const integer np)
+{
+    if (np <= self->capacity)
+    {
+        return;
+    }
+
+    const integer grown = (integer) (GROWTH * self->capacity);
+    const integer n     = (grown > np) ? grown : np;
+
+    growIntArray(&self->index,   n);
+    growIntArray(&self->idMat,   n);
+    growIntArray(&self->type,    n);
+    growIntArray(&self->nNeighS, n);
+    growIntArray(&self->nNeighL, n);
+    growIntArray(&self->startS,  n);
+    growIntArray(&self->startL,  n);
+
+    growVector1D(&self->pressure,    n);
+    growVector1D(&self->pressurek0,  n);
+    growVector1D(&self->temperature, n);
+    growVector1D(&self->pndS,        n);
+    growVector1D(&self->pndL,        n);
+    growVector1D(&self->pndB,        n);
+    growVector1D(&self->pndMat,      n);
+
+    growVector3D(&self->r,      n);
+    growVector3D(&self->rn,     n);
+    growVector3D(&self->dr,     n);
+    growVector3D(&self->u,      n);
+    growVector3D(&self->un,     n);
+    growVector3D(&self->du,     n);
+    growVector3D(&self->normal, n);
+
+    self->capacity = n;
+}
+
+void reserveNeighbours(fluid *self, const integer nS, const integer nL)
+{
+    if (nS > self->neighS.size)
+    {
+        const integer grown = (integer) (GROWTH * self->neighS.size);
+        const integer n     = (grown > nS) ? grown : nS;
+
+        growIntArray(&self->neighS,  n);
+        growVector1D(&self->dNeighS, n);
+    }
+
+    if (nL > self->neighL.size)
+    {
+        const integer grown = (integer) (GROWTH * self->neighL.size);
+        const integer n     = (grown > nL) ? grown : nL;
+
+        growIntArray(&self->neighL,  n);
+        growVector1D(&self->dNeighL, n);
+    }
+}
+
+void freeFluid(fluid *self)
+{
+    free(self->index.arr);
+    free(self->idMat.arr);
+    free(self->type.arr);
+    free(self->neighS.arr);
+    free(self->neighL.arr);
+    free(self->nNeighS.arr);
+    free(self->nNeighL.arr);
+    free(self->startS.arr);
+    free(self->startL.arr);
+
+    free(self->pressure.x);
+    free(self->pressurek0.x);
+    free(self->temperature.x);
+    free(self->pndS.x);
+    free(self->pndL.x);
+    free(self->pndB.x);
+    free(self->pndMat.x);
+    free(self->dNeighS.x);
+    free(self->dNeighL.x);
+
+    freeVector3DFields(&self->r);
+    freeVector3DFields(&self->rn);
+    freeVector3DFields(&self->dr);
+    freeVector3DFields(&self->u);
+    freeVector3DFields(&self->un);
+    freeVector3DFields(&self->du);
+    freeVector3DFields(&self->normal);
+
+    free(self);
+}
+
+/******************************************************************************
+ * GENERAL PURPOSE METHODS                                                    *
+ ******************************************************************************/
+
+void permuteFluid(fluid *self, const integer *perm, const integer np)
+{
+    real    *tmp  = (real *)    allocate(np * sizeof(real));
+    integer *itmp = (integer *) allocate(np * sizeof(integer));
+
+    permuteInteger(self->index.arr, perm, np, itmp);
+    permuteInteger(self->idMat.arr, perm, np, itmp);
+    permuteInteger(self->type.arr,  perm, np, itmp);
+
+    permuteReal(self->pressure.x,    perm, np, tmp);
+    permuteReal(self->pressurek0.x,  perm, np, tmp);
+    permuteReal(self->temperature.x, perm, np, tmp);
+    permuteReal(self->pndS.x,        perm, np, tmp);
+    permuteReal(self->pndL.x,        perm, np, tmp);
+    permuteReal(self->pndB.x,        perm, np, tmp);
+    permuteReal(self->pndMat.x,      perm, np, tmp);
+
+    permuteVector3D(&self->r,      perm, np, tmp);
+    permuteVector3D(&self->rn,     perm, np, tmp);
+    permuteVector3D(&self->dr,     perm, np, tmp);
+    permuteVector3D(&self->u,      perm, np, tmp);
+    permuteVector3D(&self->un,     perm, np, tmp);
+    permuteVector3D(&self->du,     perm, np, tmp);
+    permuteVector3D(&self->normal, perm, np, tmp);
+
+    /*the neighbour lists hold old indices*/
+    memset(self->nNeighS.arr, 0, np * sizeof(integer));
+    memset(self->nNeighL.arr, 0, np * sizeof(integer));
+
+    free(tmp);
+    free(itmp);
+}
@@ -0,0 +1,110 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                               PARTICLES.H                                  *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Creation and destruction of the fluid particle object, with every field    *
+ * allocated for a given number of particles, growth of its capacity and      *
+ * reordering of the fields.                                                  *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __PARTICLES_H__
+#define __PARTICLES_H__
+
+#include "structures.h"
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    makeFluid                                                     *
+ * -------------------------------------------------------------------------- *
+ * description: creates a fluid object and allocates every field for np       *
+ *              particles. The neighbour lists start empty, they are sized by *
+ *              the neighbour search, and the neighbour counts are set to     *
+ *              zero.                                                         *
+ * -------------------------------------------------------------------------- *
+ * input:  const integer np   // total number of particles                    *
+ * -------------------------------------------------------------------------- *
+ * output: fluid *self                                                        *
+ ******************************************************************************/
+fluid *makeFluid(const integer np);
+
+/******************************************************************************
+ * Function:    reserveFluid                                                  *
+ * -------------------------------------------------------------------------- *
+ * description: makes the fields hold at least np particles. The capacity     *
+ *              grows by at least the factor GROWTH, the values of the        *
+ *              existing particles are kept and the new slots are zeroed. The *
+ *              neighbour lists are left to the neighbour search.             *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid        *self   // fluid particles                            *
+ *         const integer np     // required number of particles               *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void reserveFluid(fluid *self, const integer np);
+
+/******************************************************************************
+ * Function:    reserveNeighbours                                             *
+ * -------------------------------------------------------------------------- *
+ * description: makes the packed neighbour lists hold at least nS and nL      *
+ *              entries. Each list grows by at least the factor GROWTH and    *
+ *              keeps its entries.                                            *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid        *self   // fluid particles                            *
+ *         const integer nS     // required entries, small radius             *
+ *         const integer nL     // required entries, large radius             *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void reserveNeighbours(fluid *self, const integer nS, const integer nL);
+
+/******************************************************************************
+ * Function:    freeFluid                                                     *
+ * -------------------------------------------------------------------------- *
+ * description: deallocates every field of the fluid object and the object    *
+ *              itself.                                                       *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid *self   // fluid particles                                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void freeFluid(fluid *self);
+
+/******************************************************************************
+ * GENERAL PURPOSE METHODS                                                    *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    permuteFluid                                                  *
+ * -------------------------------------------------------------------------- *
+ * description: reorders every per-particle field, so that the particle k of  *
+ *              the new order is the particle perm[k] of the old one. The     *
+ *              neighbour lists refer to the old indices, so they are emptied *
+ *              and must be searched again.                                   *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid         *self   // fluid particles                           *
+ *         const integer *perm   // old index of each new position            *
+ *         const integer  np     // number of particles                       *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void permuteFluid(fluid *self, const integer *perm, const integer np);
+
+#endif
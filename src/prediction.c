@@ -0,0 +1,111 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                              PREDICTION.C                                  *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "prediction.h"
+#include "neighbours.h"
+
+#include <math.h>   /*mathematical functions*/
+
+/******************************************************************************
+ * PREDICTION STEP                                                            *
+ ******************************************************************************/
+
+real predictionStep(fluid *particles, parameters *par)
+{
+    return predictionRange(particles, par, 0, par->np);
+}
+
+static inline real predictionRangeDim(fluid *particles, parameters *par,
+    const integer begin, const integer end, const integer reach,
+    const integer dim)
+{
+    register integer i; /*particle  counter loop*/
+    register integer k; /*neighbour counter loop*/
+
+    const real dt   = par->dt;
+    const real visc = par->nu * 2.0 * dim / (par->lambda * par->n0L);
+
+    const real *unx = particles->un.x;
+    const real *uny = particles->un.y;
+    const real *unz = particles->un.z;
+
+    real u2Max = 0.0;
+
+    for (i = begin; i < end; i++)
+    {
+        const integer *nb = particles->neighL.arr + particles->startL.arr[i];
+        const real    *d  = particles->dNeighL.x  + particles->startL.arr[i];
+        const integer  nL = particles->nNeighL.arr[i];
+
+        real lx = 0.0, ly = 0.0, lz = 0.0;
+
+        /*viscous Laplacian of the velocity at the start of the step*/
+        for (k = 0; k < nL; k++)
+        {
+            const integer j = nb[k];
+            const real    w = (j < reach) ? weight(d[k], par->reL) : 0.0;
+
+            lx += w * (unx[j] - unx[i]);
+            ly += w * (uny[j] - uny[i]);
+
+            if (dim == 3)
+            {
+                lz += w * (unz[j] - unz[i]);
+            }
+        }
+
+        /*gravity, velocity and position in the same sweep*/
+        const real ux = unx[i] + dt * (visc * lx + par->g[0]);
+        const real uy = uny[i] + dt * (visc * ly + par->g[1]);
+        const real uz = (dim == 3) ? unz[i] + dt * (visc * lz + par->g[2])
+                                   : 0.0;
+
+        particles->u.x[i]  = ux;
+        particles->u.y[i]  = uy;
+        particles->dr.x[i] = dt * ux;
+        particles->dr.y[i] = dt * uy;
+        particles->r.x[i]  = particles->rn.x[i] + dt * ux;
+        particles->r.y[i]  = particles->rn.y[i] + dt * uy;
+
+        if (dim == 3)
+        {
+            particles->u.z[i]  = uz;
+            particles->dr.z[i] = dt * uz;
+            particles->r.z[i]  = particles->rn.z[i] + dt * uz;
+        }
+
+        u2Max = fmax(u2Max, ux*ux + uy*uy + uz*uz);
+    }
+
+    return sqrt(u2Max);
+}
+
+real predictionRange(fluid *particles, parameters *par, const integer begin,
+    const integer end)
+{
+    return DIM_DISPATCH(par->dim, predictionRangeDim, particles, par, begin,
+        end, REACH_ALL);
+}
+
+real predictionReach(fluid *particles, parameters *par, const integer begin,
+    const integer end, const integer reach)
+{
+    return DIM_DISPATCH(par->dim, predictionRangeDim, particles, par, begin,
+        end, reach);
+}
@@ -0,0 +1,88 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                              PREDICTION.H                                  *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Explicit (prediction) part of the MPS time step: viscosity, gravity and    *
+ * advection fused in a single sweep over the particles and their large-      *
+ * radius neighbour lists.                                                    *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __PREDICTION_H__
+#define __PREDICTION_H__
+
+#include "structures.h"
+
+/******************************************************************************
+ * PREDICTION STEP                                                            *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    predictionStep                                                *
+ * -------------------------------------------------------------------------- *
+ * description: for every particle, accumulates the MPS Laplacian of the      *
+ *              velocity over its neighbour list and writes, in the same      *
+ *              sweep:                                                        *
+ *                  u  = un + dt (nu lap(un) + g)                             *
+ *                  dr = dt u                                                 *
+ *                  r  = rn + dr                                              *
+ *              un and rn must hold the state at the start of the step; since *
+ *              the Laplacian only reads un and the cached distances, u and r *
+ *              can be overwritten while the neighbours are visited.          *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ * -------------------------------------------------------------------------- *
+ * output: real                    // maximum predicted velocity norm         *
+ ******************************************************************************/
+real predictionStep(fluid *particles, parameters *par);
+
+/******************************************************************************
+ * Function:    predictionRange                                               *
+ * -------------------------------------------------------------------------- *
+ * description: prediction step restricted to the particles [begin, end),     *
+ *              e.g. the range of one material.                               *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // parameters of the range               *
+ *         const integer begin       // first particle of the range           *
+ *         const integer end         // one past the last particle            *
+ * -------------------------------------------------------------------------- *
+ * output: real                      // maximum predicted velocity norm       *
+ ******************************************************************************/
+real predictionRange(fluid *particles, parameters *par, const integer begin,
+    const integer end);
+
+/******************************************************************************
+ * Function:    predictionReach                                               *
+ * -------------------------------------------------------------------------- *
+ * description: predictionRange where the neighbours of index reach or more   *
+ *              are left out of the viscous term, e.g. the dummy particles    *
+ *              of the type-partitioned layout.                               *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // parameters of the range               *
+ *         const integer begin       // first particle of the range           *
+ *         const integer end         // one past the last particle            *
+ *         const integer reach       // first neighbour index left out        *
+ * -------------------------------------------------------------------------- *
+ * output: real                      // maximum predicted velocity norm       *
+ ******************************************************************************/
+real predictionReach(fluid *particles, parameters *par, const integer begin,
+    const integer end, const integer reach);
+
+#endif
@@ -0,0 +1,185 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                               PRESSURE.C                                   *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "pressure.h"
+#include "neighbours.h"
+
+#include <stdio.h>  /*input and output variable manipulation*/
+#include <stdlib.h> /*address and memory manipulation*/
+
+/******************************************************************************
+ * PRESSURE METHODS                                                           *
+ ******************************************************************************/
+
+void explicitPressure(fluid *particles, parameters *par)
+{
+    explicitPressureRange(particles, par, 0, par->np);
+}
+
+real explicitPressureRange(fluid *particles, parameters *par,
+    const integer begin, const integer end)
+{
+    register integer i;
+
+    const real coef = par->c0 * par->c0 * par->rho / par->n0S;
+    real pMax = 0.0;
+
+    for (i = begin; i < end; i++)
+    {
+        const real p = coef * (particles->pndS.x[i] - par->n0S);
+
+        particles->pressure.x[i] = (p > 0.0) ? p : 0.0;
+        pMax = (p > pMax) ? p : pMax;
+    }
+
+    return pMax;
+}
+
+csrMatrix *assemblePressurePoisson(fluid *particles, parameters *par,
+    surfaceList *surf, vector1D *b)
+{
+    return assemblePressurePoissonReach(particles, par, surf, b, REACH_ALL);
+}
+
+csrMatrix *assemblePressurePoissonReach(fluid *particles, parameters *par,
+    surfaceList *surf, vector1D *b, const integer reach)
+{
+    register integer r; /*row       counter loop*/
+    register integer k; /*neighbour counter loop*/
+
+    const real    coef   = 2.0 * par->dim / (par->lambda * par->n0L);
+    const real    source = par->rho / (par->dt * par->dt * par->n0S);
+    const integer n      = surf->nInterior;
+
+    integer nnz = n;
+
+    for (r = 0; r < n; r++)
+    {
+        nnz += particles->nNeighL.arr[surf->interior[r]];
+    }
+
+    csrMatrix *A = makeCsrMatrix(n, nnz);
+
+    nnz = 0;
+
+    for (r = 0; r < n; r++)
+    {
+        const integer  i    = surf->interior[r];
+        const integer *nb   = particles->neighL.arr + particles->startL.arr[i];
+        const real    *d    = particles->dNeighL.x  + particles->startL.arr[i];
+        const integer  diag = nnz++;
+
+        real sumW = 0.0;
+
+        A->rowPtr[r] = diag;
+
+        for (k = 0; k < particles->nNeighL.arr[i]; k++)
+        {
+            /*Neumann neighbours: p_j = p_i cancels the pair*/
+            if (nb[k] >= reach)
+            {
+                continue;
+            }
+
+            const real    w   = coef * weight(d[k], par->reL);
+            const integer col = surf->row[nb[k]];
+
+            sumW += w;
+
+            /*surface neighbours have p = 0: no off-diagonal term*/
+            if (col != SURFACE_NONE)
+            {
+                A->colInd[nnz] = (integer32) col;
+                A->val[nnz++]  = -w;
+            }
+        }
+
+        A->colInd[diag] = (integer32) r;
+        A->val[diag]    = sumW;
+        b->x[r]         = source * (particles->pndS.x[i] - par->n0S);
+    }
+
+    A->rowPtr[n] = nnz;
+    A->nnz       = nnz;
+
+    return A;
+}
+
+void pressureSourceRange(fluid *particles, parameters *par, surfaceList *surf,
+    vector1D *b, const integer begin, const integer end)
+{
+    register integer i; /*particle counter loop*/
+
+    const real source = par->rho / (par->dt * par->dt * par->n0S);
+
+    for (i = begin; i < end; i++)
+    {
+        const integer r = surf->row[i];
+
+        if (r != SURFACE_NONE)
+        {
+            b->x[r] = source * (particles->pndS.x[i] - par->n0S);
+        }
+    }
+}
+
+void applyPressureBoundary(fluid *particles, surfaceList *surf)
+{
+    register integer k;
+
+    /*Dirichlet condition on the free surface*/
+    for (k = 0; k < surf->nSurface; k++)
+    {
+        particles->pressure.x[surf->surface[k]] = 0.0;
+    }
+
+    /*negative pressures are not sustained by the fluid*/
+    for (k = 0; k < surf->nInterior; k++)
+    {
+        const integer i = surf->interior[k];
+
+        if (particles->pressure.x[i] < 0.0)
+        {
+            particles->pressure.x[i] = 0.0;
+        }
+    }
+}
+
+integer computePressure(fluid *particles, parameters *par, surfaceList *surf,
+    solverConfig *cfg)
+{
+    if (par->pressure == PRESSURE_EXPLICIT)
+    {
+        explicitPressure(particles, par);
+        return 0;
+    }
+
+    vector1D     *b = makeVector1D(surf->nInterior);
+    sparseMatrix *A = makeSparseMatrix(
+        assemblePressurePoisson(particles, par, surf, b), cfg->format);
+
+    const integer it = solvePressure(particles, surf->interior, A, b, cfg);
+
+    applyPressureBoundary(particles, surf);
+
+    freeSparseMatrix(A);
+    freeVector1D(b);
+
+    return it;
+}
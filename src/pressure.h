@@ -0,0 +1,154 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                               PRESSURE.H                                   *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Pressure computation. In the implicit mode (MPS) the pressure Poisson      *
+ * equation is assembled from the large-radius neighbour lists and solved;    *
+ * in the explicit mode (EMPS) the pressure follows from an equation of state *
+ * on the small-radius particle number density, and no system is solved. The  *
+ * free-surface particles have p = 0 and are left out of the Poisson system,  *
+ * whose rows are the interior particles only.                                *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __PRESSURE_H__
+#define __PRESSURE_H__
+
+#include "structures.h"
+#include "solver.h"
+#include "surface.h"
+
+/******************************************************************************
+ * PRESSURE METHODS                                                           *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    explicitPressure                                              *
+ * -------------------------------------------------------------------------- *
+ * description: computes the pressure with the equation of state              *
+ *              p = c0^2 rho (pndS - n0S) / n0S, negative values set to zero. *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void explicitPressure(fluid *particles, parameters *par);
+
+/******************************************************************************
+ * Function:    explicitPressureRange                                         *
+ * -------------------------------------------------------------------------- *
+ * description: equation of state of explicitPressure restricted to the       *
+ *              particles [begin, end), e.g. the range of one material.       *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // parameters of the range               *
+ *         const integer begin       // first particle of the range           *
+ *         const integer end         // one past the last particle            *
+ * -------------------------------------------------------------------------- *
+ * output: real                      // maximum pressure in the range         *
+ ******************************************************************************/
+real explicitPressureRange(fluid *particles, parameters *par,
+    const integer begin, const integer end);
+
+/******************************************************************************
+ * Function:    assemblePressurePoisson                                       *
+ * -------------------------------------------------------------------------- *
+ * description: assembles the pressure Poisson equation with the MPS          *
+ *              Laplacian model over the interior particles: row k belongs to *
+ *              the particle surf->interior[k], and the free-surface          *
+ *              neighbours (p = 0) only contribute to the diagonal.           *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid       *particles   // fluid particles                        *
+ *         parameters  *par         // simulation parameters                  *
+ *         surfaceList *surf        // free-surface and interior lists        *
+ *         vector1D    *b           // right-hand side, size surf->nInterior  *
+ * -------------------------------------------------------------------------- *
+ * output: csrMatrix *A             // symmetric positive definite matrix     *
+ ******************************************************************************/
+csrMatrix *assemblePressurePoisson(fluid *particles, parameters *par,
+    surfaceList *surf, vector1D *b);
+
+/******************************************************************************
+ * Function:    assemblePressurePoissonReach                                  *
+ * -------------------------------------------------------------------------- *
+ * description: assemblePressurePoisson where the neighbours of index reach   *
+ *              or more have a Neumann condition, p_j = p_i, and drop out of  *
+ *              the row, e.g. the walls of the type-partitioned layout. The   *
+ *              surface lists only need to cover the particles below reach.   *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // simulation parameters                 *
+ *         surfaceList  *surf        // free-surface and interior lists       *
+ *         vector1D     *b           // right-hand side, surf->nInterior      *
+ *         const integer reach       // first Neumann neighbour index         *
+ * -------------------------------------------------------------------------- *
+ * output: csrMatrix *A              // symmetric positive definite matrix    *
+ ******************************************************************************/
+csrMatrix *assemblePressurePoissonReach(fluid *particles, parameters *par,
+    surfaceList *surf, vector1D *b, const integer reach);
+
+/******************************************************************************
+ * Function:    pressureSourceRange                                           *
+ * -------------------------------------------------------------------------- *
+ * description: rewrites the right-hand side of assemblePressurePoisson for   *
+ *              the interior particles of [begin, end), with the rho of par,  *
+ *              e.g. once per material range.                                 *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // simulation parameters                 *
+ *         surfaceList  *surf        // free-surface and interior lists       *
+ *         vector1D     *b           // right-hand side, surf->nInterior      *
+ *         const integer begin       // first particle of the range           *
+ *         const integer end         // one past the last particle            *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void pressureSourceRange(fluid *particles, parameters *par, surfaceList *surf,
+    vector1D *b, const integer begin, const integer end);
+
+/******************************************************************************
+ * Function:    applyPressureBoundary                                         *
+ * -------------------------------------------------------------------------- *
+ * description: sets p = 0 on the free surface and clamps the negative        *
+ *              pressures of the interior particles to zero.                  *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid       *particles   // fluid particles                        *
+ *         surfaceList *surf        // free-surface and interior lists        *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void applyPressureBoundary(fluid *particles, surfaceList *surf);
+
+/******************************************************************************
+ * Function:    computePressure                                               *
+ * -------------------------------------------------------------------------- *
+ * description: computes fluid.pressure with the mode chosen in               *
+ *              par->pressure. The pndS and, in the implicit mode, the        *
+ *              surface lists must be up to date.                             *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // simulation parameters                 *
+ *         surfaceList  *surf        // free-surface and interior lists       *
+ *         solverConfig *cfg         // solver used in the implicit mode      *
+ * -------------------------------------------------------------------------- *
+ * output: integer                   // solver iterations, 0 if explicit      *
+ ******************************************************************************/
+integer computePressure(fluid *particles, parameters *par, surfaceList *surf,
+    solverConfig *cfg);
+
+#endif
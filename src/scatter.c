@@ -0,0 +1,307 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                               SCATTER.C                                    *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "scatter.h"
+#include "parallel.h"
+
+#include <stdio.h>  /*input and output variable manipulation*/
+#include <stdlib.h> /*address and memory manipulation*/
+
+#ifdef _OPENMP
+#include <omp.h>    /*thread number*/
+#endif
+
+/******************************************************************************
+ * AUXILIARY FUNCTIONS                                                        *
+ ******************************************************************************/
+
+static void reserveBuffers(scatterPlan *plan, const integer n)
+{
+    if (n > plan->bufferCap)
+    {
+        free(plan->buffers);
+
+        plan->buffers   = (real *) malloc(n * sizeof(real));
+        plan->bufferCap = n;
+
+        if (plan->buffers == NULL)
+        {
+            printf ("ERROR: no free space in RAM to allocate the buffers\n");
+            exit (EXIT_FAILURE);
+        }
+    }
+}
+
+static void scatterSerial(parameters *par, scatterKernel kernel, void *arg,
+    real **field, const integer ncomp)
+{
+    register integer i, c;
+
+    scatterTarget acc;
+
+    for (c = 0; c < ncomp; c++)
+    {
+        acc.x[c] = field[c];
+    }
+
+    acc.atomic = false;
+
+    for (i = 0; i < par->np; i++)
+    {
+        kernel(arg, i, &acc);
+    }
+}
+
+static void scatterAtomic(parameters *par, scatterKernel kernel, void *arg,
+    real **field, const integer ncomp)
+{
+    register integer i, c;
+
+    scatterTarget acc;
+
+    for (c = 0; c < ncomp; c++)
+    {
+        acc.x[c] = field[c];
+    }
+
+    acc.atomic = true;
+
+    #pragma omp parallel for schedule(dynamic, 256) firstprivate(acc)
+    for (i = 0; i < par->np; i++)
+    {
+        kernel(arg, i, &acc);
+    }
+}
+
+static void scatterBuffers(scatterPlan *plan, parameters *par,
+    scatterKernel kernel, void *arg, real **field, const integer ncomp)
+{
+    const integer np      = par->np;
+    const integer threads = parallelThreads();
+
+    reserveBuffers(plan, threads * ncomp * np);
+
+    real *buffers = plan->buffers;
+
+    #pragma omp parallel
+    {
+        register integer i, c, t;
+
+#ifdef _OPENMP
+        const integer tid = (integer) omp_get_thread_num();
+        const integer nth = (integer) omp_get_num_threads();
+#else
+        const integer tid = 0;
+        const integer nth = 1;
+#endif
+        scatterTarget acc;
+
+        /*each thread zeroes, and so first touches, its own buffer*/
+        for (c = 0; c < ncomp; c++)
+        {
+            acc.x[c] = buffers + (tid * ncomp + c) * np;
+
+            for (i = 0; i < np; i++)
+            {
+                acc.x[c][i] = 0.0;
+            }
+        }
+
+        acc.atomic = false;
+
+        #pragma omp for schedule(dynamic, 256)
+        for (i = 0; i < np; i++)
+        {
+            kernel(arg, i, &acc);
+        }
+
+        /*the implicit barrier above completes every buffer*/
+        #pragma omp for schedule(static)
+        for (i = 0; i < np; i++)
+        {
+            for (c = 0; c < ncomp; c++)
+            {
+                real sum = field[c][i];
+
+                for (t = 0; t < nth; t++)
+                {
+                    sum += buffers[(t * ncomp + c) * np + i];
+                }
+
+                field[c][i] = sum;
+            }
+        }
+    }
+}
+
+static void scatterColour(cellGrid *grid, parameters *par,
+    scatterKernel kernel, void *arg, real **field, const integer ncomp)
+{
+    register integer c;
+
+    const integer nz      = (par->dim == 3) ? grid->nz : 1;
+    const integer ncolour = (par->dim == 3) ? 27 : 9;
+
+    scatterTarget acc;
+
+    for (c = 0; c < ncomp; c++)
+    {
+        acc.x[c] = field[c];
+    }
+
+    acc.atomic = false;
+
+    for (c = 0; c < ncolour; c++)
+    {
+        register long m;
+
+        const integer ox = c % 3;
+        const integer oy = (c / 3) % 3;
+        const integer oz = c / 9;
+        const integer mx = (grid->nx > ox) ? (grid->nx - ox + 2) / 3 : 0;
+        const integer my = (grid->ny > oy) ? (grid->ny - oy + 2) / 3 : 0;
+        const integer mz = (nz > oz) ? (nz - oz + 2) / 3 : 0;
+        const long    nc = (long) (mx * my * mz);
+
+        /*the cells of one colour share no neighbour: plain adds*/
+        #pragma omp parallel for schedule(dynamic, 1) firstprivate(acc)
+        for (m = 0; m < nc; m++)
+        {
+            register integer k;
+
+            const integer cx   = ox + 3 * ((integer) m % mx);
+            const integer cy   = oy + 3 * (((integer) m / mx) % my);
+            const integer cz   = oz + 3 * ((integer) m / (mx * my));
+            const integer cell = cx + grid->nx * (cy + grid->ny * cz);
+
+            for (k = grid->cellStart[cell]; k < grid->cellStart[cell + 1]; k++)
+            {
+                const integer i = grid->cellParticles[k];
+
+                if (i < par->np)
+                {
+                    kernel(arg, i, &acc);
+                }
+            }
+        }
+    }
+}
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+scatterPlan *makeScatterPlan(void)
+{
+    scatterPlan *self = (scatterPlan *) malloc(sizeof(scatterPlan));
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the object\n");
+        exit (EXIT_FAILURE);
+    }
+
+    self->strategy  = SCATTER_AUTO;
+    self->last      = SCATTER_AUTO;
+    self->sparse    = SCATTER_SPARSE;
+    self->maxBytes  = SCATTER_BYTES;
+    self->buffers   = NULL;
+    self->bufferCap = 0;
+
+    return self;
+}
+
+void freeScatterPlan(scatterPlan *self)
+{
+    free(self->buffers);
+    free(self);
+}
+
+/******************************************************************************
+ * SCATTER ACCUMULATION                                                       *
+ ******************************************************************************/
+
+scatterStrategy selectScatter(scatterPlan *plan, cellGrid *grid,
+    const intArray *nNeigh, const integer np, const integer ncomp)
+{
+    register integer i;
+
+    if (plan->strategy != SCATTER_AUTO)
+    {
+        return plan->strategy;
+    }
+
+    integer sum = 0;
+
+    for (i = 0; i < np; i++)
+    {
+        sum += nNeigh->arr[i];
+    }
+
+    const real    density = (np > 0) ? (real) sum / np : 0.0;
+    const integer bytes   = parallelThreads() * ncomp * np * sizeof(real);
+
+    if (density < plan->sparse)
+    {
+        return SCATTER_ATOMIC;
+    }
+
+    return (bytes <= plan->maxBytes || grid == NULL) ? SCATTER_BUFFERS
+                                                     : SCATTER_COLOUR;
+}
+
+scatterStrategy scatterParticles(scatterPlan *plan, cellGrid *grid,
+    parameters *par, const intArray *nNeigh, scatterKernel kernel, void *arg,
+    real **field, const integer ncomp)
+{
+    if (ncomp > SCATTER_MAXCOMP)
+    {
+        printf ("ERROR: more than %d fields to scatter\n", SCATTER_MAXCOMP);
+        exit (EXIT_FAILURE);
+    }
+
+    scatterStrategy s = selectScatter(plan, grid, nNeigh, par->np, ncomp);
+
+    if (s == SCATTER_COLOUR && grid == NULL)
+    {
+        printf ("ERROR: the colour scatter needs the cell grid\n");
+        exit (EXIT_FAILURE);
+    }
+
+    if (parallelThreads() == 1 || par->np < getParallelThreshold())
+    {
+        scatterSerial(par, kernel, arg, field, ncomp);
+    }
+    else if (s == SCATTER_COLOUR)
+    {
+        scatterColour(grid, par, kernel, arg, field, ncomp);
+    }
+    else if (s == SCATTER_BUFFERS)
+    {
+        scatterBuffers(plan, par, kernel, arg, field, ncomp);
+    }
+    else
+    {
+        scatterAtomic(par, kernel, arg, field, ncomp);
+    }
+
+    plan->last = s;
+
+    return s;
+}
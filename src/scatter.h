@@ -0,0 +1,190 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                               SCATTER.H                                    *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Threaded scatter accumulation for symmetric pair kernels, which add the    *
+ * contribution of a pair to both particles, e.g. collision impulses into du  *
+ * or pnd sums over a half neighbour list. Two threads may then write to the  *
+ * same particle; three lock-free strategies avoid the race:                  *
+ *                                                                            *
+ *   - SCATTER_COLOUR: the cells are coloured so that two cells of the same   *
+ *     colour are three cells apart along some axis (9 colours in 2D, 27 in   *
+ *     3D). The cells of a colour run concurrently and never share a          *
+ *     neighbour. No extra memory and plain adds, but one barrier per colour  *
+ *     and the neighbour lists must not reach past the adjacent cells.        *
+ *   - SCATTER_BUFFERS: every thread adds into its own zeroed copy of the     *
+ *     fields, merged afterwards by a parallel loop over the particles.       *
+ *     Plain adds and no ordering, but threads x fields memory and traffic.   *
+ *   - SCATTER_ATOMIC: atomic floating point adds into the fields. No setup,  *
+ *     but each add costs an atomic, and contended lines bounce.              *
+ *                                                                            *
+ * With SCATTER_AUTO the strategy follows the mean neighbour count: sparse    *
+ * lists have few conflicting adds, so the atomics are cheapest; denser lists *
+ * amortise the zeroing and merging of the thread buffers over many pairs,    *
+ * and the colouring is used when the buffers exceed their memory budget.     *
+ * With one thread, or below the parallel threshold, the kernel adds straight *
+ * into the fields.                                                           *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __SCATTER_H__
+#define __SCATTER_H__
+
+#include "structures.h"
+#include "neighbours.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+#define SCATTER_MAXCOMP 4                // largest number of fields
+#define SCATTER_SPARSE  8.0              // default mean neighbours for atomics
+#define SCATTER_BYTES   (256UL << 20)    // default thread buffer budget
+
+typedef enum scatterStrategy
+{
+    SCATTER_AUTO    = 0,   /* selected by the neighbour density               */
+    SCATTER_COLOUR  = 1,   /* cell colouring, no conflicts                    */
+    SCATTER_BUFFERS = 2,   /* per-thread buffers and a parallel merge         */
+    SCATTER_ATOMIC  = 3    /* atomic floating point adds                      */
+
+} scatterStrategy;
+
+typedef struct scatterTarget
+{
+    real    *x[SCATTER_MAXCOMP];   /* arrays the kernel adds into             */
+    boolean  atomic;               /* adds must be atomic                     */
+
+} scatterTarget;
+
+/* adds the contributions of the pairs of particle i through scatterAdd */
+typedef void (*scatterKernel)(void *arg, const integer i, scatterTarget *acc);
+
+typedef struct scatterPlan
+{
+    scatterStrategy strategy;    /* strategy, SCATTER_AUTO to select          */
+    scatterStrategy last;        /* strategy used by the last scatter         */
+    real            sparse;      /* mean neighbours below which atomics win   */
+    integer         maxBytes;    /* largest size of the thread buffers        */
+    real           *buffers;     /* thread buffers                            */
+    integer         bufferCap;   /* slots in buffers                          */
+
+} scatterPlan;
+
+/******************************************************************************
+ * Function:    scatterAdd                                                    *
+ * -------------------------------------------------------------------------- *
+ * description: adds value to the component c of particle j.                  *
+ * -------------------------------------------------------------------------- *
+ * input:  scatterTarget *acc    // target given to the kernel                *
+ *         const integer  c      // component                                 *
+ *         const integer  j      // particle                                  *
+ *         const real     value  // contribution                              *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+static inline void scatterAdd(scatterTarget *acc, const integer c,
+    const integer j, const real value)
+{
+    if (acc->atomic)
+    {
+        #pragma omp atomic
+        acc->x[c][j] += value;
+    }
+    else
+    {
+        acc->x[c][j] += value;
+    }
+}
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    makeScatterPlan                                               *
+ * -------------------------------------------------------------------------- *
+ * description: creates a plan with the automatic selection, the thresholds   *
+ *              SCATTER_SPARSE and SCATTER_BYTES and no buffers yet.          *
+ * -------------------------------------------------------------------------- *
+ * input:  void                                                               *
+ * -------------------------------------------------------------------------- *
+ * output: scatterPlan *self                                                  *
+ ******************************************************************************/
+scatterPlan *makeScatterPlan(void);
+
+/******************************************************************************
+ * Function:    freeScatterPlan                                               *
+ * -------------------------------------------------------------------------- *
+ * description: deallocates the thread buffers and the plan.                  *
+ * -------------------------------------------------------------------------- *
+ * input:  scatterPlan *self   // scatter plan                                *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void freeScatterPlan(scatterPlan *self);
+
+/******************************************************************************
+ * SCATTER ACCUMULATION                                                       *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    selectScatter                                                 *
+ * -------------------------------------------------------------------------- *
+ * description: returns the strategy of the plan, or the one chosen from the  *
+ *              mean of nNeigh over the np particles when it is SCATTER_AUTO. *
+ *              Without a grid the colouring is never chosen.                 *
+ * -------------------------------------------------------------------------- *
+ * input:  scatterPlan    *plan     // scatter plan                           *
+ *         cellGrid       *grid     // cell grid of the lists, or NULL        *
+ *         const intArray *nNeigh   // neighbour counts of the kernel's list  *
+ *         const integer   np       // number of particles                    *
+ *         const integer   ncomp    // number of fields                       *
+ * -------------------------------------------------------------------------- *
+ * output: scatterStrategy          // strategy                               *
+ ******************************************************************************/
+scatterStrategy selectScatter(scatterPlan *plan, cellGrid *grid,
+    const intArray *nNeigh, const integer np, const integer ncomp);
+
+/******************************************************************************
+ * Function:    scatterParticles                                              *
+ * -------------------------------------------------------------------------- *
+ * description: calls kernel(arg, i, acc) for every particle i < par->np and  *
+ *              accumulates what it adds through scatterAdd into the fields,  *
+ *              on top of their values. The kernel must only add to i and to  *
+ *              particles j < par->np of its neighbour list: the buffers hold *
+ *              par->np values, so ghost neighbours are never targets. With   *
+ *              the colouring, the grid must be the one of that list and its  *
+ *              cell edge at least the list radius.                           *
+ * -------------------------------------------------------------------------- *
+ * input:  scatterPlan    *plan        // scatter plan                        *
+ *         cellGrid       *grid        // cell grid, or NULL                  *
+ *         parameters     *par         // simulation parameters               *
+ *         const intArray *nNeigh      // neighbour counts of the kernel      *
+ *         scatterKernel   kernel      // pair kernel of a particle           *
+ *         void           *arg         // argument of the kernel              *
+ *         real          **field       // ncomp arrays of par->np values      *
+ *         const integer   ncomp       // number of fields, at most           *
+ *                                     // SCATTER_MAXCOMP                     *
+ * -------------------------------------------------------------------------- *
+ * output: scatterStrategy             // strategy used                       *
+ ******************************************************************************/
+scatterStrategy scatterParticles(scatterPlan *plan, cellGrid *grid,
+    parameters *par, const intArray *nNeigh, scatterKernel kernel, void *arg,
+    real **field, const integer ncomp);
+
+#endif
@@ -0,0 +1,265 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                             SMALLMATRIX.C                                  *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "smallmatrix.h"
+#include "neighbours.h"
+
+#include <stdio.h>  /*input and output variable manipulation*/
+#include <stdlib.h> /*address and memory manipulation*/
+#include <math.h>   /*mathematical functions*/
+
+/******************************************************************************
+ * CONSTRUCTOR AND DESTRUCTOR                                                 *
+ ******************************************************************************/
+
+symMatrix3 *makeSymMatrix3(const integer size)
+{
+    const integer align  = ALIGN_BYTES / sizeof(real);
+    const integer stride = ((size + align - 1) / align) * align;
+
+    symMatrix3 *self = (symMatrix3 *) malloc(sizeof(symMatrix3));
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the object\n");
+        exit (EXIT_FAILURE);
+    }
+
+    real *block = (real *) aligned_alloc(ALIGN_BYTES,
+        6 * (stride > 0 ? stride : align) * sizeof(real));
+
+    if (block == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the matrices\n");
+        exit (EXIT_FAILURE);
+    }
+
+    self->size = size;
+    self->xx   = block;
+    self->xy   = block +     stride;
+    self->xz   = block + 2 * stride;
+    self->yy   = block + 3 * stride;
+    self->yz   = block + 4 * stride;
+    self->zz   = block + 5 * stride;
+
+    return self;
+}
+
+void freeSymMatrix3(symMatrix3 *self)
+{
+    free(self->xx);
+    free(self);
+}
+
+/******************************************************************************
+ * BATCHED KERNELS                                                            *
+ ******************************************************************************/
+
+static inline void buildMomentMatricesDim(fluid *particles, parameters *par,
+    symMatrix3 *M, const integer dim)
+{
+    register integer i; /*particle  counter loop*/
+    register integer k; /*neighbour counter loop*/
+
+    const real inv = 1.0 / par->n0L;
+
+    #pragma omp parallel for private(k) schedule(static)
+    for (i = 0; i < par->np; i++)
+    {
+        const integer *nb = particles->neighL.arr + particles->startL.arr[i];
+        const real    *d  = particles->dNeighL.x  + particles->startL.arr[i];
+        const integer  nL = particles->nNeighL.arr[i];
+
+        real xx = 0.0, xy = 0.0, xz = 0.0, yy = 0.0, yz = 0.0, zz = 0.0;
+
+        for (k = 0; k < nL; k++)
+        {
+            if (d[k] <= 0.0)
+            {
+                continue;
+            }
+
+            const integer j  = nb[k];
+            const real    f  = weight(d[k], par->reL) / (d[k] * d[k]);
+            const real    dx = particles->r.x[j] - particles->r.x[i];
+            const real    dy = particles->r.y[j] - particles->r.y[i];
+
+            xx += f * dx * dx;
+            xy += f * dx * dy;
+            yy += f * dy * dy;
+
+            if (dim == 3)
+            {
+                const real dz = particles->r.z[j] - particles->r.z[i];
+
+                xz += f * dx * dz;
+                yz += f * dy * dz;
+                zz += f * dz * dz;
+            }
+        }
+
+        M->xx[i] = inv * xx;
+        M->xy[i] = inv * xy;
+        M->yy[i] = inv * yy;
+
+        if (dim == 3)
+        {
+            M->xz[i] = inv * xz;
+            M->yz[i] = inv * yz;
+            M->zz[i] = inv * zz;
+        }
+        else
+        {
+            M->xz[i] = 0.0;
+            M->yz[i] = 0.0;
+            M->zz[i] = 1.0;
+        }
+    }
+}
+
+void buildMomentMatrices(fluid *particles, parameters *par, symMatrix3 *M)
+{
+    DIM_DISPATCH(par->dim, buildMomentMatricesDim, particles, par, M);
+}
+
+integer invertSymMatrix3(symMatrix3 *src, symMatrix3 *dst, const integer dim,
+    const real tol)
+{
+    register integer i;
+
+    const integer n    = src->size;
+    const real    diag = (real) dim;
+    integer singular   = 0;
+
+    const real *restrict axx = src->xx, *restrict axy = src->xy;
+    const real *restrict axz = src->xz, *restrict ayy = src->yy;
+    const real *restrict ayz = src->yz, *restrict azz = src->zz;
+
+    real *bxx = dst->xx, *bxy = dst->xy, *bxz = dst->xz;
+    real *byy = dst->yy, *byz = dst->yz, *bzz = dst->zz;
+
+    /*branch-free body: the singular matrices are selected, not skipped*/
+    #pragma omp parallel for simd reduction(+:singular) schedule(static)
+    for (i = 0; i < n; i++)
+    {
+        const real a = axx[i], b = axy[i], c = axz[i];
+        const real d = ayy[i], e = ayz[i], f = azz[i];
+
+        /*cofactors*/
+        const real cxx = d*f - e*e;
+        const real cxy = c*e - b*f;
+        const real cxz = b*e - c*d;
+        const real cyy = a*f - c*c;
+        const real cyz = b*c - a*e;
+        const real czz = a*d - b*b;
+
+        const real det   = a*cxx + b*cxy + c*cxz;
+        const real scale = fmax(a, fmax(d, f));
+        const int  bad   = !(fabs(det) > tol * scale * scale * scale) ||
+                           !(scale > 0.0);
+        const real r     = bad ? 0.0 : 1.0 / det;
+
+        bxx[i] = bad ? diag : r * cxx;
+        bxy[i] = r * cxy;
+        bxz[i] = r * cxz;
+        byy[i] = bad ? diag : r * cyy;
+        byz[i] = r * cyz;
+        bzz[i] = bad ? diag : r * czz;
+
+        singular += (integer) bad;
+    }
+
+    return singular;
+}
+
+void applySymMatrix3(symMatrix3 *M, vector3D *v)
+{
+    register integer i;
+
+    const integer n = M->size;
+
+    const real *restrict mxx = M->xx, *restrict mxy = M->xy;
+    const real *restrict mxz = M->xz, *restrict myy = M->yy;
+    const real *restrict myz = M->yz, *restrict mzz = M->zz;
+
+    real *vx = v->x, *vy = v->y, *vz = v->z;
+
+    #pragma omp parallel for simd schedule(static)
+    for (i = 0; i < n; i++)
+    {
+        const real x = vx[i], y = vy[i], z = vz[i];
+
+        vx[i] = mxx[i]*x + mxy[i]*y + mxz[i]*z;
+        vy[i] = mxy[i]*x + myy[i]*y + myz[i]*z;
+        vz[i] = mxz[i]*x + myz[i]*y + mzz[i]*z;
+    }
+}
+
+static inline void correctedGradientDim(fluid *particles, parameters *par,
+    symMatrix3 *C, const real *phi, vector3D *grad, const integer dim)
+{
+    register integer i; /*particle  counter loop*/
+    register integer k; /*neighbour counter loop*/
+
+    const real inv = 1.0 / par->n0L;
+
+    /*raw moments of the field, then one batched product*/
+    #pragma omp parallel for private(k) schedule(static)
+    for (i = 0; i < par->np; i++)
+    {
+        const integer *nb = particles->neighL.arr + particles->startL.arr[i];
+        const real    *d  = particles->dNeighL.x  + particles->startL.arr[i];
+        const integer  nL = particles->nNeighL.arr[i];
+
+        real gx = 0.0, gy = 0.0, gz = 0.0;
+
+        for (k = 0; k < nL; k++)
+        {
+            if (d[k] <= 0.0)
+            {
+                continue;
+            }
+
+            const integer j = nb[k];
+            const real    f = (phi[j] - phi[i]) * weight(d[k], par->reL) /
+                (d[k] * d[k]);
+
+            gx += f * (particles->r.x[j] - particles->r.x[i]);
+            gy += f * (particles->r.y[j] - particles->r.y[i]);
+
+            if (dim == 3)
+            {
+                gz += f * (particles->r.z[j] - particles->r.z[i]);
+            }
+        }
+
+        grad->x[i] = inv * gx;
+        grad->y[i] = inv * gy;
+        grad->z[i] = inv * gz;
+    }
+
+    applySymMatrix3(C, grad);
+}
+
+void correctedGradient(fluid *particles, parameters *par, symMatrix3 *C,
+    const real *phi, vector3D *grad)
+{
+    DIM_DISPATCH(par->dim, correctedGradientDim, particles, par, C, phi,
+        grad);
+}
@@ -0,0 +1,143 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                             SMALLMATRIX.H                                  *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Batches of symmetric 3x3 matrices, one per particle, for the corrected     *
+ * MPS gradient. The batch is stored as six component arrays (xx, xy, xz, yy, *
+ * yz, zz) in one aligned block, so that every kernel is a loop over the      *
+ * particles on contiguous arrays that the compiler vectorises, instead of    *
+ * one heap-allocated Matrix and scalar 3x3 arithmetic per particle. The      *
+ * moment matrix M = 1/n0 sum w r x r / |r|^2 is symmetric, and so is its     *
+ * inverse, so six components are enough for the whole pipeline.              *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __SMALLMATRIX_H__
+#define __SMALLMATRIX_H__
+
+#include "structures.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+typedef struct symMatrix3
+{
+    integer  size;               /* number of matrices                        */
+    real    *xx, *xy, *xz;       /* first  row                                */
+    real         *yy, *yz;       /* second row, upper part                    */
+    real              *zz;       /* third  row, upper part                    */
+
+} symMatrix3;
+
+/******************************************************************************
+ * CONSTRUCTOR AND DESTRUCTOR                                                 *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    makeSymMatrix3                                                *
+ * -------------------------------------------------------------------------- *
+ * description: allocates a batch of symmetric 3x3 matrices in one aligned    *
+ *              block, the six component arrays each starting on a cache      *
+ *              line.                                                         *
+ * -------------------------------------------------------------------------- *
+ * input:  const integer size   // number of matrices                         *
+ * -------------------------------------------------------------------------- *
+ * output: symMatrix3 *self                                                   *
+ ******************************************************************************/
+symMatrix3 *makeSymMatrix3(const integer size);
+
+/******************************************************************************
+ * Function:    freeSymMatrix3                                                *
+ * -------------------------------------------------------------------------- *
+ * description: deallocates the component arrays and the object itself.       *
+ * -------------------------------------------------------------------------- *
+ * input:  symMatrix3 *self   // batch of matrices                            *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void freeSymMatrix3(symMatrix3 *self);
+
+/******************************************************************************
+ * BATCHED KERNELS                                                            *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    buildMomentMatrices                                           *
+ * -------------------------------------------------------------------------- *
+ * description: builds M_i = 1/n0L sum_j w(r_ij) r_ij x r_ij / |r_ij|^2 from  *
+ *              the large-radius neighbour lists. In two dimensions zz is set *
+ *              to one, so the inverse leaves the z component unchanged.      *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ *         symMatrix3 *M           // moment matrices, size par->np           *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void buildMomentMatrices(fluid *particles, parameters *par, symMatrix3 *M);
+
+/******************************************************************************
+ * Function:    invertSymMatrix3                                              *
+ * -------------------------------------------------------------------------- *
+ * description: inverts every matrix of the batch by its cofactors. A matrix  *
+ *              whose determinant is below tol times the cube of its largest  *
+ *              diagonal entry (too few neighbours, e.g. near the surface) is *
+ *              replaced by dim times the identity, i.e. the standard MPS     *
+ *              gradient. src and dst may be the same batch.                  *
+ * -------------------------------------------------------------------------- *
+ * input:  symMatrix3    *src   // matrices to invert                         *
+ *         symMatrix3    *dst   // inverses                                   *
+ *         const integer  dim   // spatial dimension, 2 or 3                  *
+ *         const real     tol   // relative determinant threshold             *
+ * -------------------------------------------------------------------------- *
+ * output: integer              // number of singular matrices                *
+ ******************************************************************************/
+integer invertSymMatrix3(symMatrix3 *src, symMatrix3 *dst, const integer dim,
+    const real tol);
+
+/******************************************************************************
+ * Function:    applySymMatrix3                                               *
+ * -------------------------------------------------------------------------- *
+ * description: computes v_i = M_i v_i for every particle, in place.          *
+ * -------------------------------------------------------------------------- *
+ * input:  symMatrix3 *M   // batch of matrices                               *
+ *         vector3D   *v   // vectors, one per matrix                         *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void applySymMatrix3(symMatrix3 *M, vector3D *v);
+
+/******************************************************************************
+ * Function:    correctedGradient                                             *
+ * -------------------------------------------------------------------------- *
+ * description: corrected MPS gradient of a scalar field,                     *
+ *              grad_i = C_i 1/n0L sum_j (phi_j - phi_i) w r_ij / |r_ij|^2,   *
+ *              with C_i the inverse moment matrices of invertSymMatrix3.     *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ *         symMatrix3 *C           // inverse moment matrices                 *
+ *         const real *phi         // scalar field, size par->np              *
+ *         vector3D   *grad        // gradient, size par->np                  *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void correctedGradient(fluid *particles, parameters *par, symMatrix3 *C,
+    const real *phi, vector3D *grad);
+
+#endif
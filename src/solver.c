@@ -0,0 +1,477 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                                SOLVER.C                                    *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "solver.h"
+
+#include <stdio.h>  /*input and output variable manipulation*/
+#include <stdlib.h> /*address and memory manipulation*/
+#include <math.h>   /*mathematical functions*/
+
+/******************************************************************************
+ * AUXILIARY FUNCTIONS                                                        *
+ ******************************************************************************/
+
+static real dot(const real *v, const real *w, const integer size)
+{
+    register integer i;
+    real sum = 0.0;
+
+    for (i = 0; i < size; i++)
+    {
+        sum += v[i] * w[i];
+    }
+
+    return sum;
+}
+
+/* single precision vectors, accumulated in double precision */
+static real dot32(const real32 *v, const real32 *w, const integer size)
+{
+    register integer i;
+    real sum = 0.0;
+
+    for (i = 0; i < size; i++)
+    {
+        sum += (real) v[i] * (real) w[i];
+    }
+
+    return sum;
+}
+
+static real32 *makeArray32(const integer size)
+{
+    real32 *self = (real32 *) malloc(size * sizeof(real32));
+
+    if (size > 0 && self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the array\n");
+        exit (EXIT_FAILURE);
+    }
+
+    return self;
+}
+
+/* Jacobi preconditioned CG in single precision, with x = 0 as initial guess */
+static integer pcgSolve32(sparseMatrix *A, const real32 *b, real32 *x,
+    const real32 *dinv, real32 *r, real32 *z, real32 *p, real32 *q,
+    const real tol, const integer maxIter)
+{
+    register integer i;  /*element   counter loop*/
+    register integer it; /*iteration counter loop*/
+
+    const integer n = A->csr->nrows;
+
+    for (i = 0; i < n; i++)
+    {
+        x[i] = 0.0f;
+        r[i] = b[i];
+        z[i] = dinv[i] * r[i];
+        p[i] = z[i];
+    }
+
+    real bnorm = sqrt(dot32(b, b, n));
+    real rz    = dot32(r, z, n);
+    real rnorm = bnorm;
+
+    bnorm = (bnorm > 0.0) ? bnorm : 1.0;
+
+    for (it = 0; it < maxIter && rnorm > tol * bnorm; it++)
+    {
+        spmv32(A, p, q);
+
+        const real32 alpha = (real32) (rz / dot32(p, q, n));
+        real rr = 0.0;
+
+        for (i = 0; i < n; i++)
+        {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * q[i];
+            z[i]  = dinv[i] * r[i];
+            rr   += (real) r[i] * (real) r[i];
+        }
+
+        const real   rzNew = dot32(r, z, n);
+        const real32 beta  = (real32) (rzNew / rz);
+
+        for (i = 0; i < n; i++)
+        {
+            p[i] = z[i] + beta * p[i];
+        }
+
+        rz    = rzNew;
+        rnorm = sqrt(rr);
+    }
+
+    return it;
+}
+
+/* state of one conjugate gradient, used to run two of them in lockstep */
+typedef struct pcgState
+{
+    vector1D *x, *b;
+    vector1D *r, *z, *p, *q, *dinv;
+    real      rz, rnorm, bnorm;
+    integer   it;
+
+} pcgState;
+
+static void startPcg(pcgState *s, sparseMatrix *A, vector1D *b, vector1D *x)
+{
+    register integer i;
+
+    const integer n = A->csr->nrows;
+
+    s->x    = x;
+    s->b    = b;
+    s->r    = makeVector1D(n);
+    s->z    = makeVector1D(n);
+    s->p    = makeVector1D(n);
+    s->q    = makeVector1D(n);
+    s->dinv = makeVector1D(n);
+    s->it   = 0;
+
+    diagonalCsr(A->csr, s->dinv);
+    spmv(A, x, s->q);
+
+    for (i = 0; i < n; i++)
+    {
+        s->dinv->x[i] = (s->dinv->x[i] != 0.0) ? 1.0 / s->dinv->x[i] : 1.0;
+        s->r->x[i]    = b->x[i] - s->q->x[i];
+        s->z->x[i]    = s->dinv->x[i] * s->r->x[i];
+        s->p->x[i]    = s->z->x[i];
+    }
+
+    s->bnorm = sqrt(dot(b->x, b->x, n));
+    s->bnorm = (s->bnorm > 0.0) ? s->bnorm : 1.0;
+    s->rz    = dot(s->r->x, s->z->x, n);
+    s->rnorm = sqrt(dot(s->r->x, s->r->x, n));
+}
+
+/* one iteration, with q = A p already computed */
+static void stepPcg(pcgState *s, const integer n)
+{
+    register integer i;
+
+    const real alpha = s->rz / dot(s->p->x, s->q->x, n);
+    real rr = 0.0;
+
+    for (i = 0; i < n; i++)
+    {
+        s->x->x[i] += alpha * s->p->x[i];
+        s->r->x[i] -= alpha * s->q->x[i];
+        s->z->x[i]  = s->dinv->x[i] * s->r->x[i];
+        rr         += s->r->x[i] * s->r->x[i];
+    }
+
+    const real rzNew = dot(s->r->x, s->z->x, n);
+    const real beta  = rzNew / s->rz;
+
+    for (i = 0; i < n; i++)
+    {
+        s->p->x[i] = s->z->x[i] + beta * s->p->x[i];
+    }
+
+    s->rz    = rzNew;
+    s->rnorm = sqrt(rr);
+    s->it++;
+}
+
+static void endPcg(pcgState *s)
+{
+    freeVector1D(s->r);
+    freeVector1D(s->z);
+    freeVector1D(s->p);
+    freeVector1D(s->q);
+    freeVector1D(s->dinv);
+}
+
+/******************************************************************************
+ * GENERAL PURPOSE METHODS                                                    *
+ ******************************************************************************/
+
+void initSolverConfig(solverConfig *cfg)
+{
+    cfg->mode       = SOLVER_DOUBLE;
+    cfg->format     = SPARSE_CSR;
+    cfg->maxIter    = 1000;
+    cfg->tol        = 1e-09;
+    cfg->innerTol   = 1e-04;
+    cfg->maxRefine  = 10;
+    cfg->iterations = 0;
+    cfg->residual   = 0.0;
+}
+
+/******************************************************************************
+ * SOLVERS                                                                    *
+ ******************************************************************************/
+
+integer pcgSolve(sparseMatrix *A, vector1D *b, vector1D *x, solverConfig *cfg)
+{
+    register integer i;  /*element   counter loop*/
+    register integer it; /*iteration counter loop*/
+
+    const integer n = A->csr->nrows;
+
+    selectSparseFormat(A, cfg->format);
+
+    vector1D *r    = makeVector1D(n); /*residual                */
+    vector1D *z    = makeVector1D(n); /*preconditioned residual */
+    vector1D *p    = makeVector1D(n); /*search direction        */
+    vector1D *q    = makeVector1D(n); /*A p                     */
+    vector1D *dinv = makeVector1D(n); /*inverse of the diagonal */
+
+    diagonalCsr(A->csr, dinv);
+
+    for (i = 0; i < n; i++)
+    {
+        dinv->x[i] = (dinv->x[i] != 0.0) ? 1.0 / dinv->x[i] : 1.0;
+    }
+
+    /*r = b - A x*/
+    spmv(A, x, q);
+
+    for (i = 0; i < n; i++)
+    {
+        r->x[i] = b->x[i] - q->x[i];
+        z->x[i] = dinv->x[i] * r->x[i];
+        p->x[i] = z->x[i];
+    }
+
+    real bnorm = sqrt(dot(b->x, b->x, n));
+    real rz    = dot(r->x, z->x, n);
+    real rnorm = sqrt(dot(r->x, r->x, n));
+
+    bnorm = (bnorm > 0.0) ? bnorm : 1.0;
+
+    for (it = 0; it < cfg->maxIter && rnorm > cfg->tol * bnorm; it++)
+    {
+        spmv(A, p, q);
+
+        const real alpha = rz / dot(p->x, q->x, n);
+        real rr = 0.0;
+
+        for (i = 0; i < n; i++)
+        {
+            x->x[i] += alpha * p->x[i];
+            r->x[i] -= alpha * q->x[i];
+            z->x[i]  = dinv->x[i] * r->x[i];
+            rr      += r->x[i] * r->x[i];
+        }
+
+        const real rzNew = dot(r->x, z->x, n);
+        const real beta  = rzNew / rz;
+
+        for (i = 0; i < n; i++)
+        {
+            p->x[i] = z->x[i] + beta * p->x[i];
+        }
+
+        rz    = rzNew;
+        rnorm = sqrt(rr);
+    }
+
+    cfg->iterations = it;
+    cfg->residual   = rnorm / bnorm;
+
+    freeVector1D(r);
+    freeVector1D(z);
+    freeVector1D(p);
+    freeVector1D(q);
+    freeVector1D(dinv);
+
+    return it;
+}
+
+integer pcgSolvePair(sparseMatrix *A1, vector1D *b1, vector1D *x1,
+    sparseMatrix *A2, vector1D *b2, vector1D *x2, solverConfig *cfg)
+{
+    const integer n = A1->csr->nrows;
+    pcgState s1, s2;
+
+    selectSparseFormat(A1, cfg->format);
+    selectSparseFormat(A2, cfg->format);
+
+    /*the fused product only exists for the CSR storage*/
+    const int fused = cfg->format == SPARSE_CSR;
+
+    startPcg(&s1, A1, b1, x1);
+    startPcg(&s2, A2, b2, x2);
+
+    while (s1.it < cfg->maxIter || s2.it < cfg->maxIter)
+    {
+        const int run1 = s1.it < cfg->maxIter && s1.rnorm > cfg->tol * s1.bnorm;
+        const int run2 = s2.it < cfg->maxIter && s2.rnorm > cfg->tol * s2.bnorm;
+
+        if (!run1 && !run2)
+        {
+            break;
+        }
+
+        if (run1 && run2 && fused)
+        {
+            spmvCsrPair(A1->csr, A2->csr, s1.p, s2.p, s1.q, s2.q);
+        }
+        else
+        {
+            if (run1)
+            {
+                spmv(A1, s1.p, s1.q);
+            }
+
+            if (run2)
+            {
+                spmv(A2, s2.p, s2.q);
+            }
+        }
+
+        if (run1)
+        {
+            stepPcg(&s1, n);
+        }
+
+        if (run2)
+        {
+            stepPcg(&s2, n);
+        }
+    }
+
+    cfg->iterations = (s1.it > s2.it) ? s1.it : s2.it;
+    cfg->residual   = fmax(s1.rnorm / s1.bnorm, s2.rnorm / s2.bnorm);
+
+    endPcg(&s1);
+    endPcg(&s2);
+
+    return cfg->iterations;
+}
+
+integer mixedSolve(sparseMatrix *A, vector1D *b, vector1D *x, solverConfig *cfg)
+{
+    register integer i; /*element    counter loop*/
+    register integer k; /*refinement counter loop*/
+
+    const integer n = A->csr->nrows;
+    integer total   = 0;
+
+    selectSparseFormat(A, cfg->format);
+    updateSingleValues(A);
+
+    vector1D *r    = makeVector1D(n); /*double precision residual */
+    vector1D *q    = makeVector1D(n); /*A x                       */
+    real32   *r32  = makeArray32(n);  /*scaled residual           */
+    real32   *d32  = makeArray32(n);  /*correction                */
+    real32   *dinv = makeArray32(n);  /*inverse of the diagonal   */
+    real32   *w1   = makeArray32(n);  /*work arrays of the inner CG*/
+    real32   *w2   = makeArray32(n);
+    real32   *w3   = makeArray32(n);
+    real32   *w4   = makeArray32(n);
+
+    diagonalCsr(A->csr, q);
+
+    for (i = 0; i < n; i++)
+    {
+        dinv[i] = (q->x[i] != 0.0) ? (real32) (1.0 / q->x[i]) : 1.0f;
+    }
+
+    real bnorm = sqrt(dot(b->x, b->x, n));
+    real rnorm = 0.0;
+
+    bnorm = (bnorm > 0.0) ? bnorm : 1.0;
+
+    for (k = 0; k <= cfg->maxRefine; k++)
+    {
+        /*residual in double precision*/
+        spmv(A, x, q);
+
+        for (i = 0; i < n; i++)
+        {
+            r->x[i] = b->x[i] - q->x[i];
+        }
+
+        rnorm = sqrt(dot(r->x, r->x, n));
+
+        if (rnorm <= cfg->tol * bnorm || k == cfg->maxRefine)
+        {
+            break;
+        }
+
+        /*the residual is normalized to stay inside the float range*/
+        for (i = 0; i < n; i++)
+        {
+            r32[i] = (real32) (r->x[i] / rnorm);
+        }
+
+        total += pcgSolve32(A, r32, d32, dinv, w1, w2, w3, w4, cfg->innerTol,
+            cfg->maxIter);
+
+        /*correction in double precision*/
+        for (i = 0; i < n; i++)
+        {
+            x->x[i] += rnorm * (real) d32[i];
+        }
+    }
+
+    cfg->iterations = total;
+    cfg->residual   = rnorm / bnorm;
+
+    freeVector1D(r);
+    freeVector1D(q);
+    free(r32);
+    free(d32);
+    free(dinv);
+    free(w1);
+    free(w2);
+    free(w3);
+    free(w4);
+
+    return total;
+}
+
+integer solvePressure(fluid *particles, const integer *rows, sparseMatrix *A,
+    vector1D *b, solverConfig *cfg)
+{
+    register integer k;
+
+    if (rows == NULL)
+    {
+        return (cfg->mode == SOLVER_MIXED) ?
+            mixedSolve(A, b, &particles->pressure, cfg) :
+            pcgSolve(A, b, &particles->pressure, cfg);
+    }
+
+    const integer n = A->csr->nrows;
+    vector1D     *x = makeVector1D(n);
+
+    /*gather the unknowns, solve and scatter them back*/
+    for (k = 0; k < n; k++)
+    {
+        x->x[k] = particles->pressure.x[rows[k]];
+    }
+
+    const integer it = (cfg->mode == SOLVER_MIXED) ? mixedSolve(A, b, x, cfg)
+                                                   : pcgSolve(A, b, x, cfg);
+
+    for (k = 0; k < n; k++)
+    {
+        particles->pressure.x[rows[k]] = x->x[k];
+    }
+
+    freeVector1D(x);
+
+    return it;
+}
@@ -0,0 +1,160 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                                SOLVER.H                                    *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Iterative solver for the symmetric positive definite systems of the MPS    *
+ * method, such as the pressure Poisson equation. The conjugate gradient is   *
+ * preconditioned with the diagonal (Jacobi) of the matrix, and the sparse    *
+ * storage used by its matrix-vector product is chosen in the configuration.  *
+ * In the mixed precision mode the conjugate gradient runs in single          *
+ * precision, and its solution is corrected by iterative refinement with the  *
+ * residual computed in double precision.                                     *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __SOLVER_H__
+#define __SOLVER_H__
+
+#include "structures.h"
+#include "sparse.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+typedef enum solverMode
+{
+    SOLVER_DOUBLE = 0,        /* conjugate gradient in double precision       */
+    SOLVER_MIXED  = 1         /* single precision CG with double refinement   */
+
+} solverMode;
+
+typedef struct solverConfig
+{
+    solverMode   mode;        /* precision of the conjugate gradient          */
+    sparseFormat format;      /* storage used by the matrix-vector product    */
+    integer      maxIter;     /* maximum number of iterations                 */
+    real         tol;         /* relative tolerance on the residual norm      */
+    real         innerTol;    /* relative tolerance of the single precision CG*/
+    integer      maxRefine;   /* maximum number of refinement steps           */
+    integer      iterations;  /* iterations done by the last solve            */
+    real         residual;    /* relative residual reached by the last solve  */
+
+} solverConfig;
+
+/******************************************************************************
+ * GENERAL PURPOSE METHODS                                                    *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    initSolverConfig                                              *
+ * -------------------------------------------------------------------------- *
+ * description: fills a configuration with the default values: double         *
+ *              precision, CSR storage, 1000 iterations and relative          *
+ *              tolerance of 1e-9. The mixed precision mode uses an inner     *
+ *              tolerance of 1e-4 and at most 10 refinement steps.            *
+ * -------------------------------------------------------------------------- *
+ * input:  solverConfig *cfg   // solver configuration                        *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void initSolverConfig(solverConfig *cfg);
+
+/******************************************************************************
+ * SOLVERS                                                                    *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    pcgSolve                                                      *
+ * -------------------------------------------------------------------------- *
+ * description: solves A x = b with the Jacobi preconditioned conjugate       *
+ *              gradient, using x as initial guess. The storage selected in   *
+ *              cfg->format is built in A when it does not exist yet. The     *
+ *              number of iterations and the final residual are written back  *
+ *              into cfg.                                                     *
+ * -------------------------------------------------------------------------- *
+ * input:  sparseMatrix *A     // symmetric positive definite matrix          *
+ *         vector1D     *b     // right-hand side                             *
+ *         vector1D     *x     // initial guess and solution                  *
+ *         solverConfig *cfg   // solver configuration                        *
+ * -------------------------------------------------------------------------- *
+ * output: integer             // number of iterations                        *
+ ******************************************************************************/
+integer pcgSolve(sparseMatrix *A, vector1D *b, vector1D *x, solverConfig *cfg);
+
+/******************************************************************************
+ * Function:    pcgSolvePair                                                  *
+ * -------------------------------------------------------------------------- *
+ * description: solves A1 x1 = b1 and A2 x2 = b2 with two Jacobi              *
+ *              preconditioned conjugate gradients run in lockstep. The       *
+ *              matrices must share their sparsity pattern (sameSparsity).    *
+ *              With cfg->format = SPARSE_CSR each iteration streams the CSR  *
+ *              indices once for both products; with SPARSE_SELL the two      *
+ *              products use the SELL-C-sigma storage, built when missing.    *
+ *              The largest iteration count and residual of the two systems   *
+ *              are written back into cfg.                                    *
+ * -------------------------------------------------------------------------- *
+ * input:  sparseMatrix *A1, *A2   // matrices with the same pattern          *
+ *         vector1D     *b1, *b2   // right-hand sides                        *
+ *         vector1D     *x1, *x2   // initial guesses and solutions           *
+ *         solverConfig *cfg       // solver configuration                    *
+ * -------------------------------------------------------------------------- *
+ * output: integer                 // number of iterations                    *
+ ******************************************************************************/
+integer pcgSolvePair(sparseMatrix *A1, vector1D *b1, vector1D *x1,
+    sparseMatrix *A2, vector1D *b2, vector1D *x2, solverConfig *cfg);
+
+/******************************************************************************
+ * Function:    mixedSolve                                                    *
+ * -------------------------------------------------------------------------- *
+ * description: solves A x = b by iterative refinement: the residual and the  *
+ *              solution are updated in double precision, while each          *
+ *              correction is computed by the Jacobi preconditioned conjugate *
+ *              gradient in single precision (float values and vectors) up to *
+ *              cfg->innerTol. The total number of inner iterations and the   *
+ *              final residual are written back into cfg.                     *
+ * -------------------------------------------------------------------------- *
+ * input:  sparseMatrix *A     // symmetric positive definite matrix          *
+ *         vector1D     *b     // right-hand side                             *
+ *         vector1D     *x     // initial guess and solution                  *
+ *         solverConfig *cfg   // solver configuration                        *
+ * -------------------------------------------------------------------------- *
+ * output: integer             // number of inner iterations                  *
+ ******************************************************************************/
+integer mixedSolve(sparseMatrix *A, vector1D *b, vector1D *x, solverConfig *cfg);
+
+/******************************************************************************
+ * Function:    solvePressure                                                 *
+ * -------------------------------------------------------------------------- *
+ * description: solves the pressure Poisson equation into fluid.pressure,     *
+ *              which is also the initial guess, with the solver selected in  *
+ *              cfg->mode. When rows is not NULL, the k-th unknown of the     *
+ *              system is the pressure of the particle rows[k]; otherwise the *
+ *              unknowns are the particles themselves.                        *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid         *particles   // fluid particles                      *
+ *         const integer *rows        // particle of each row, or NULL        *
+ *         sparseMatrix  *A           // pressure Poisson matrix              *
+ *         vector1D      *b           // right-hand side                      *
+ *         solverConfig  *cfg         // solver configuration                 *
+ * -------------------------------------------------------------------------- *
+ * output: integer                    // number of iterations                 *
+ ******************************************************************************/
+integer solvePressure(fluid *particles, const integer *rows, sparseMatrix *A,
+    vector1D *b, solverConfig *cfg);
+
+#endif
@@ -0,0 +1,595 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                                SPARSE.C                                    *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "sparse.h"
+#include "cmps_include.h"
+#include "threadpool.h"
+
+#include <stdio.h>  /*input and output variable manipulation*/
+#include <stdlib.h> /*address and memory manipulation*/
+#include <string.h>
+
+/******************************************************************************
+ * AUXILIARY FUNCTIONS                                                        *
+ ******************************************************************************/
+
+/* row length and row index, used to sort the rows inside a sigma window */
+typedef struct rowKey
+{
+    integer len;
+    integer row;
+
+} rowKey;
+
+static int compareRowKey(const void *a, const void *b)
+{
+    const rowKey *ka = (const rowKey *) a;
+    const rowKey *kb = (const rowKey *) b;
+
+    /*longest rows first, original order between rows of the same length*/
+    if (ka->len != kb->len)
+    {
+        return (ka->len < kb->len) ? 1 : -1;
+    }
+
+    return (ka->row > kb->row) - (ka->row < kb->row);
+}
+
+static void fillSell(sellMatrix *self, csrMatrix *src)
+{
+    register integer c; /*chunk  counter loop*/
+    register integer r; /*row    counter loop inside the chunk*/
+    register integer j; /*column counter loop inside the row  */
+
+    for (c = 0; c < self->nchunks; c++)
+    {
+        for (r = 0; r < SELL_CHUNK; r++)
+        {
+            const integer row = self->perm[c*SELL_CHUNK + r];
+            integer start = 0;
+            integer len   = 0;
+
+            if (row < self->nrows)
+            {
+                start = src->rowPtr[row];
+                len   = src->rowPtr[row + 1] - start;
+            }
+
+            for (j = 0; j < self->chunkLen[c]; j++)
+            {
+                const integer k = self->chunkPtr[c] + j*SELL_CHUNK + r;
+
+                if (j < len)
+                {
+                    self->colInd[k] = src->colInd[start + j];
+                    self->val[k]    = src->val[start + j];
+                }
+                else /*padding: valid address, null contribution*/
+                {
+                    self->colInd[k] = 0;
+                    self->val[k]    = 0.0;
+                }
+            }
+        }
+    }
+}
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+csrMatrix *makeCsrMatrix(const integer nrows, const integer nnz)
+{
+    csrMatrix *self = (csrMatrix *) malloc(sizeof(csrMatrix));
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the object\n");
+        exit (EXIT_FAILURE);
+    }
+
+    self->nrows  = nrows;
+    self->nnz    = nnz;
+    self->rowPtr = (integer *)   calloc(nrows + 1, sizeof(integer));
+    self->colInd = (integer32 *) malloc(nnz * sizeof(integer32));
+    self->val    = (real *)      malloc(nnz * sizeof(real));
+    self->val32  = NULL;
+
+    if (self->rowPtr == NULL || self->colInd == NULL || self->val == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the CSR matrix\n");
+        exit (EXIT_FAILURE);
+    }
+
+    return self;
+}
+
+sellMatrix *makeSellMatrix(csrMatrix *src, const integer sigma)
+{
+    register integer c; /*chunk counter loop*/
+    register integer k; /*slot  counter loop*/
+
+    sellMatrix *self = (sellMatrix *) malloc(sizeof(sellMatrix));
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the object\n");
+        exit (EXIT_FAILURE);
+    }
+
+    const integer n    = src->nrows;
+    const integer npad = ((n + SELL_CHUNK - 1) / SELL_CHUNK) * SELL_CHUNK;
+
+    self->nrows    = n;
+    self->nchunks  = npad / SELL_CHUNK;
+    /*the window must hold whole chunks*/
+    self->sigma    = (sigma < SELL_CHUNK) ? SELL_CHUNK :
+                     (sigma / SELL_CHUNK) * SELL_CHUNK;
+    self->perm     = (integer *) malloc(npad * sizeof(integer));
+    self->chunkPtr = (integer *) malloc((self->nchunks + 1) * sizeof(integer));
+    self->chunkLen = (integer *) malloc(self->nchunks * sizeof(integer));
+
+    rowKey *keys = (rowKey *) malloc(npad * sizeof(rowKey));
+
+    if (self->perm == NULL || self->chunkPtr == NULL ||
+        self->chunkLen == NULL || keys == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the SELL matrix\n");
+        exit (EXIT_FAILURE);
+    }
+
+    /*sort the rows by length inside each sigma window*/
+    for (k = 0; k < n; k++)
+    {
+        keys[k].len = src->rowPtr[k + 1] - src->rowPtr[k];
+        keys[k].row = k;
+    }
+
+    for (k = 0; k < n; k += self->sigma)
+    {
+        const integer w = (k + self->sigma > n) ? n - k : self->sigma;
+        qsort(keys + k, w, sizeof(rowKey), compareRowKey);
+    }
+
+    /*padding slots point past the last row*/
+    for (k = 0; k < npad; k++)
+    {
+        self->perm[k] = (k < n) ? keys[k].row : n;
+    }
+
+    /*chunk widths and offsets*/
+    self->chunkPtr[0] = 0;
+
+    for (c = 0; c < self->nchunks; c++)
+    {
+        integer width = 0;
+
+        for (k = c*SELL_CHUNK; k < (c + 1)*SELL_CHUNK && k < n; k++)
+        {
+            width = (keys[k].len > width) ? keys[k].len : width;
+        }
+
+        self->chunkLen[c]     = width;
+        self->chunkPtr[c + 1] = self->chunkPtr[c] + width * SELL_CHUNK;
+    }
+
+    free(keys);
+
+    self->nnz    = self->chunkPtr[self->nchunks];
+    self->colInd = (integer32 *) malloc(self->nnz * sizeof(integer32));
+    self->val    = (real *)      malloc(self->nnz * sizeof(real));
+    self->val32  = NULL;
+
+    if (self->nnz > 0 && (self->colInd == NULL || self->val == NULL))
+    {
+        printf ("ERROR: no free space in RAM to allocate the SELL matrix\n");
+        exit (EXIT_FAILURE);
+    }
+
+    fillSell(self, src);
+
+    return self;
+}
+
+sparseMatrix *makeSparseMatrix(csrMatrix *csr, const sparseFormat format)
+{
+    sparseMatrix *self = (sparseMatrix *) malloc(sizeof(sparseMatrix));
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the object\n");
+        exit (EXIT_FAILURE);
+    }
+
+    self->format = SPARSE_CSR;
+    self->csr    = csr;
+    self->sell   = NULL;
+
+    selectSparseFormat(self, format);
+
+    return self;
+}
+
+void freeCsrMatrix(csrMatrix *self)
+{
+    free(self->rowPtr);
+    free(self->colInd);
+    free(self->val);
+    free(self->val32);
+    free(self);
+}
+
+void freeSellMatrix(sellMatrix *self)
+{
+    free(self->chunkPtr);
+    free(self->chunkLen);
+    free(self->colInd);
+    free(self->val);
+    free(self->val32);
+    free(self->perm);
+    free(self);
+}
+
+void freeSparseMatrix(sparseMatrix *self)
+{
+    if (self->sell != NULL)
+    {
+        freeSellMatrix(self->sell);
+    }
+
+    freeCsrMatrix(self->csr);
+    free(self);
+}
+
+/******************************************************************************
+ * GENERAL PURPOSE METHODS                                                    *
+ ******************************************************************************/
+
+void selectSparseFormat(sparseMatrix *self, const sparseFormat format)
+{
+    if (format == SPARSE_SELL && self->sell == NULL)
+    {
+        self->sell = makeSellMatrix(self->csr, SELL_SIGMA);
+    }
+
+    self->format = format;
+}
+
+void updateSellValues(sparseMatrix *self)
+{
+    if (self->sell != NULL)
+    {
+        fillSell(self->sell, self->csr);
+    }
+}
+
+void updateSingleValues(sparseMatrix *self)
+{
+    register integer k;
+
+    const integer nnz = (self->format == SPARSE_SELL) ? self->sell->nnz :
+                                                        self->csr->nnz;
+    const real   *val = (self->format == SPARSE_SELL) ? self->sell->val :
+                                                        self->csr->val;
+    real32      **dst = (self->format == SPARSE_SELL) ? &self->sell->val32 :
+                                                        &self->csr->val32;
+
+    if (*dst == NULL)
+    {
+        *dst = (real32 *) malloc(nnz * sizeof(real32));
+
+        if (nnz > 0 && *dst == NULL)
+        {
+            printf ("ERROR: no free space in RAM to allocate val32\n");
+            exit (EXIT_FAILURE);
+        }
+    }
+
+    for (k = 0; k < nnz; k++)
+    {
+        (*dst)[k] = (real32) val[k];
+    }
+}
+
+int sameSparsity(csrMatrix *A, csrMatrix *B)
+{
+    if (A->nrows != B->nrows || A->nnz != B->nnz)
+    {
+        return 0;
+    }
+
+    return memcmp(A->rowPtr, B->rowPtr, (A->nrows + 1) * sizeof(integer)) == 0
+        && memcmp(A->colInd, B->colInd, A->nnz * sizeof(integer32)) == 0;
+}
+
+void diagonalCsr(csrMatrix *src, vector1D *dst)
+{
+    register integer i; /*row     counter loop*/
+    register integer k; /*element counter loop*/
+
+    for (i = 0; i < src->nrows; i++)
+    {
+        dst->x[i] = 0.0;
+
+        for (k = src->rowPtr[i]; k < src->rowPtr[i + 1]; k++)
+        {
+            if (src->colInd[k] == i)
+            {
+                dst->x[i] = src->val[k];
+                break;
+            }
+        }
+    }
+}
+
+/******************************************************************************
+ * MATRIX-VECTOR PRODUCT                                                      *
+ ******************************************************************************/
+
+void spmvCsr(csrMatrix *A, vector1D *x, vector1D *y)
+{
+    spmvCsrRange(A, x, y, 0, A->nrows);
+}
+
+void spmvCsrRange(csrMatrix *A, vector1D *x, vector1D *y, const integer begin,
+    const integer end)
+{
+    register integer i; /*row     counter loop*/
+    register integer k; /*element counter loop*/
+
+    for (i = begin; i < end; i++)
+    {
+        real sum = 0.0;
+
+        for (k = A->rowPtr[i]; k < A->rowPtr[i + 1]; k++)
+        {
+            sum += A->val[k] * x->x[A->colInd[k]];
+        }
+
+        y->x[i] = sum;
+    }
+}
+
+typedef struct spmvRange
+{
+    csrMatrix *A;   /* sparse matrix */
+    vector1D  *x;   /* input  vector */
+    vector1D  *y;   /* output vector */
+
+} spmvRange;
+
+static void spmvRangeTask(void *arg, const integer begin, const integer end)
+{
+    spmvRange *r = (spmvRange *) arg;
+
+    spmvCsrRange(r->A, r->x, r->y, begin, end);
+}
+
+void spmvCsrPool(threadPool *pool, csrMatrix *A, vector1D *x, vector1D *y)
+{
+    spmvRange r = {A, x, y};
+
+    parallelFor(pool, 0, A->nrows, 0, spmvRangeTask, &r);
+}
+
+void spmvCsrPair(csrMatrix *A1, csrMatrix *A2, vector1D *x1, vector1D *x2,
+    vector1D *y1, vector1D *y2)
+{
+    register integer i; /*row     counter loop*/
+    register integer k; /*element counter loop*/
+
+    for (i = 0; i < A1->nrows; i++)
+    {
+        real sum1 = 0.0;
+        real sum2 = 0.0;
+
+        for (k = A1->rowPtr[i]; k < A1->rowPtr[i + 1]; k++)
+        {
+            const integer32 j = A1->colInd[k];
+
+            sum1 += A1->val[k] * x1->x[j];
+            sum2 += A2->val[k] * x2->x[j];
+        }
+
+        y1->x[i] = sum1;
+        y2->x[i] = sum2;
+    }
+}
+
+void spmvSell(sellMatrix *A, vector1D *x, vector1D *y)
+{
+    register integer c; /*chunk  counter loop*/
+    register integer j; /*column counter loop inside the chunk*/
+    register integer r; /*row    counter loop inside the chunk*/
+
+    const real *xv = x->x;
+
+    for (c = 0; c < A->nchunks; c++)
+    {
+        const real      *val = A->val    + A->chunkPtr[c];
+        const integer32 *col = A->colInd + A->chunkPtr[c];
+        const integer    len = A->chunkLen[c];
+
+        real acc[SELL_CHUNK]; /*one SIMD register of row sums*/
+
+#if CMPS_X86_INSTR_SET >= CMPS_X86_AVX512_VERSION
+        __m512d sum = _mm512_setzero_pd();
+
+        for (j = 0; j < len; j++)
+        {
+            const __m256i idx = _mm256_loadu_si256(
+                (const __m256i *) (col + j*SELL_CHUNK));
+
+            sum = _mm512_fmadd_pd(_mm512_loadu_pd(val + j*SELL_CHUNK),
+                _mm512_i32gather_pd(idx, xv, sizeof(real)), sum);
+        }
+
+        _mm512_storeu_pd(acc, sum);
+#elif CMPS_X86_INSTR_SET >= CMPS_X86_AVX2_VERSION
+        __m256d sum = _mm256_setzero_pd();
+
+        for (j = 0; j < len; j++)
+        {
+            const __m128i idx = _mm_loadu_si128(
+                (const __m128i *) (col + j*SELL_CHUNK));
+
+            sum = _mm256_add_pd(sum, _mm256_mul_pd(
+                _mm256_loadu_pd(val + j*SELL_CHUNK),
+                _mm256_i32gather_pd(xv, idx, sizeof(real))));
+        }
+
+        _mm256_storeu_pd(acc, sum);
+#else
+        for (r = 0; r < SELL_CHUNK; r++)
+        {
+            acc[r] = 0.0;
+        }
+
+        for (j = 0; j < len; j++)
+        {
+            for (r = 0; r < SELL_CHUNK; r++)
+            {
+                acc[r] += val[j*SELL_CHUNK + r] * xv[col[j*SELL_CHUNK + r]];
+            }
+        }
+#endif
+
+        /*scatter the sums back to the original row order*/
+        for (r = 0; r < SELL_CHUNK; r++)
+        {
+            const integer row = A->perm[c*SELL_CHUNK + r];
+
+            if (row < A->nrows)
+            {
+                y->x[row] = acc[r];
+            }
+        }
+    }
+}
+
+void spmv(sparseMatrix *A, vector1D *x, vector1D *y)
+{
+    if (A->format == SPARSE_SELL)
+    {
+        spmvSell(A->sell, x, y);
+    }
+    else
+    {
+        spmvCsr(A->csr, x, y);
+    }
+}
+
+void spmvCsr32(csrMatrix *A, const real32 *x, real32 *y)
+{
+    register integer i; /*row     counter loop*/
+    register integer k; /*element counter loop*/
+
+    for (i = 0; i < A->nrows; i++)
+    {
+        real32 sum = 0.0f;
+
+        for (k = A->rowPtr[i]; k < A->rowPtr[i + 1]; k++)
+        {
+            sum += A->val32[k] * x[A->colInd[k]];
+        }
+
+        y[i] = sum;
+    }
+}
+
+void spmvSell32(sellMatrix *A, const real32 *x, real32 *y)
+{
+    register integer c; /*chunk  counter loop*/
+    register integer j; /*column counter loop inside the chunk*/
+    register integer r; /*row    counter loop inside the chunk*/
+
+    for (c = 0; c < A->nchunks; c++)
+    {
+        const real32    *val = A->val32  + A->chunkPtr[c];
+        const integer32 *col = A->colInd + A->chunkPtr[c];
+        const integer    len = A->chunkLen[c];
+
+        real32 acc[SELL_CHUNK]; /*half a SIMD register of row sums*/
+
+#if CMPS_X86_INSTR_SET >= CMPS_X86_AVX512_VERSION
+        __m256 sum = _mm256_setzero_ps();
+
+        for (j = 0; j < len; j++)
+        {
+            const __m256i idx = _mm256_loadu_si256(
+                (const __m256i *) (col + j*SELL_CHUNK));
+
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(
+                _mm256_loadu_ps(val + j*SELL_CHUNK),
+                _mm256_i32gather_ps(x, idx, sizeof(real32))));
+        }
+
+        _mm256_storeu_ps(acc, sum);
+#elif CMPS_X86_INSTR_SET >= CMPS_X86_AVX2_VERSION
+        __m128 sum = _mm_setzero_ps();
+
+        for (j = 0; j < len; j++)
+        {
+            const __m128i idx = _mm_loadu_si128(
+                (const __m128i *) (col + j*SELL_CHUNK));
+
+            sum = _mm_add_ps(sum, _mm_mul_ps(
+                _mm_loadu_ps(val + j*SELL_CHUNK),
+                _mm_i32gather_ps(x, idx, sizeof(real32))));
+        }
+
+        _mm_storeu_ps(acc, sum);
+#else
+        for (r = 0; r < SELL_CHUNK; r++)
+        {
+            acc[r] = 0.0f;
+        }
+
+        for (j = 0; j < len; j++)
+        {
+            for (r = 0; r < SELL_CHUNK; r++)
+            {
+                acc[r] += val[j*SELL_CHUNK + r] * x[col[j*SELL_CHUNK + r]];
+            }
+        }
+#endif
+
+        for (r = 0; r < SELL_CHUNK; r++)
+        {
+            const integer row = A->perm[c*SELL_CHUNK + r];
+
+            if (row < A->nrows)
+            {
+                y[row] = acc[r];
+            }
+        }
+    }
+}
+
+void spmv32(sparseMatrix *A, const real32 *x, real32 *y)
+{
+    if (A->format == SPARSE_SELL)
+    {
+        spmvSell32(A->sell, x, y);
+    }
+    else
+    {
+        spmvCsr32(A->csr, x, y);
+    }
+}
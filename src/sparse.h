@@ -0,0 +1,316 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                                SPARSE.H                                    *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Sparse matrix objects for the pressure Poisson equation. Two storages are  *
+ * available: the compressed sparse row (CSR), used for the assembly, and the *
+ * sliced ELLPACK (SELL-C-sigma), used by the SIMD matrix-vector product. In  *
+ * the SELL-C-sigma format the rows are sorted by length inside windows of    *
+ * sigma rows and packed in chunks of C rows stored column by column, so one  *
+ * SIMD register holds the same column slot of C consecutive rows.            *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __SPARSE_H__
+#define __SPARSE_H__
+
+#include "vectors.h"
+#include "arrays.h"
+#include "cmps_instruction_set.h"
+
+/******************************************************************************
+ * SELL-C-SIGMA PARAMETERS                                                    *
+ ******************************************************************************/
+
+/* Chunk height C: number of doubles held by one SIMD register */
+
+#if CMPS_X86_INSTR_SET >= CMPS_X86_AVX512_VERSION
+    #define SELL_CHUNK 8
+#elif CMPS_X86_INSTR_SET >= CMPS_X86_AVX_VERSION
+    #define SELL_CHUNK 4
+#elif CMPS_X86_INSTR_SET >= CMPS_X86_SSE2_VERSION
+    #define SELL_CHUNK 2
+#elif CMPS_ARM_INSTR_SET >= CMPS_ARM8_64_NEON_VERSION
+    #define SELL_CHUNK 2
+#else
+    #define SELL_CHUNK 4
+#endif
+
+/* Sorting window sigma: rows are only reordered inside this window, which    */
+/* keeps the access to the vector x local while removing most of the padding. */
+
+#define SELL_SIGMA      (32 * SELL_CHUNK)
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+typedef struct csrMatrix
+{
+    integer    nrows;     /* number of rows                                   */
+    integer    nnz;       /* number of non-zero elements                      */
+    integer   *rowPtr;    /* first element of each row, size nrows + 1        */
+    integer32 *colInd;    /* column index of each element                     */
+    real      *val;       /* value of each element                            */
+    real32    *val32;     /* single precision copy of val, NULL if unused     */
+
+} csrMatrix;
+
+typedef struct sellMatrix
+{
+    integer    nrows;     /* number of rows                                   */
+    integer    nchunks;   /* number of chunks of SELL_CHUNK rows              */
+    integer    sigma;     /* sorting window                                   */
+    integer    nnz;       /* stored elements, padding included                */
+    integer   *chunkPtr;  /* first element of each chunk, size nchunks + 1    */
+    integer   *chunkLen;  /* width (longest row) of each chunk                */
+    integer32 *colInd;    /* column index of each element                     */
+    real      *val;       /* value of each element, zero on padding           */
+    real32    *val32;     /* single precision copy of val, NULL if unused     */
+    integer   *perm;      /* original row stored in each slot                 */
+
+} sellMatrix;
+
+typedef enum sparseFormat
+{
+    SPARSE_CSR  = 0,
+    SPARSE_SELL = 1
+
+} sparseFormat;
+
+/* Sparse matrix with the storage selected for the matrix-vector product: */
+/* the CSR storage is always kept, since it is the one built by assembly. */
+
+typedef struct sparseMatrix
+{
+    sparseFormat format;
+    csrMatrix   *csr;
+    sellMatrix  *sell;
+
+} sparseMatrix;
+
+/* defined in threadpool.h, which includes this header through structures.h */
+typedef struct threadPool threadPool;
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    makeCsrMatrix                                                 *
+ * -------------------------------------------------------------------------- *
+ * description: creates a CSR matrix with room for nnz elements. The row      *
+ *              pointers are set to zero.                                     *
+ * -------------------------------------------------------------------------- *
+ * input:  const integer nrows   // total number of rows                      *
+ *         const integer nnz     // total number of non-zero elements         *
+ * -------------------------------------------------------------------------- *
+ * output: csrMatrix *self                                                    *
+ ******************************************************************************/
+csrMatrix *makeCsrMatrix(const integer nrows, const integer nnz);
+
+/******************************************************************************
+ * Function:    makeSellMatrix                                                *
+ * -------------------------------------------------------------------------- *
+ * description: converts a CSR matrix into the SELL-C-sigma format with       *
+ *              C = SELL_CHUNK and the given sorting window.                  *
+ * -------------------------------------------------------------------------- *
+ * input:  csrMatrix    *src     // source matrix                             *
+ *         const integer sigma   // sorting window, multiple of SELL_CHUNK    *
+ * -------------------------------------------------------------------------- *
+ * output: sellMatrix *self                                                   *
+ ******************************************************************************/
+sellMatrix *makeSellMatrix(csrMatrix *src, const integer sigma);
+
+/******************************************************************************
+ * Function:    makeSparseMatrix                                              *
+ * -------------------------------------------------------------------------- *
+ * description: wraps a CSR matrix and builds the storage of the requested    *
+ *              format. The CSR matrix is owned by the new object.            *
+ * -------------------------------------------------------------------------- *
+ * input:  csrMatrix         *csr      // assembled matrix                    *
+ *         const sparseFormat format   // storage used by spmv                *
+ * -------------------------------------------------------------------------- *
+ * output: sparseMatrix *self                                                 *
+ ******************************************************************************/
+sparseMatrix *makeSparseMatrix(csrMatrix *csr, const sparseFormat format);
+
+/******************************************************************************
+ * Function:    freeXXXMatrix                                                 *
+ * -------------------------------------------------------------------------- *
+ * description: deallocates the matrix storage and the object itself.         *
+ * -------------------------------------------------------------------------- *
+ * input:  XXXMatrix *self   // sparse matrix object                          *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void freeCsrMatrix(csrMatrix *self);
+void freeSellMatrix(sellMatrix *self);
+void freeSparseMatrix(sparseMatrix *self);
+
+/******************************************************************************
+ * GENERAL PURPOSE METHODS                                                    *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    selectSparseFormat                                            *
+ * -------------------------------------------------------------------------- *
+ * description: switches the storage used by spmv, building the SELL-C-sigma  *
+ *              storage from the CSR one when it does not exist yet.          *
+ * -------------------------------------------------------------------------- *
+ * input:  sparseMatrix      *self     // sparse matrix object                *
+ *         const sparseFormat format   // storage used by spmv                *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void selectSparseFormat(sparseMatrix *self, const sparseFormat format);
+
+/******************************************************************************
+ * Function:    updateSellValues                                              *
+ * -------------------------------------------------------------------------- *
+ * description: copies the values of the CSR storage into the SELL-C-sigma    *
+ *              storage, when the sparsity pattern did not change.            *
+ * -------------------------------------------------------------------------- *
+ * input:  sparseMatrix *self   // sparse matrix object                       *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void updateSellValues(sparseMatrix *self);
+
+/******************************************************************************
+ * Function:    updateSingleValues                                            *
+ * -------------------------------------------------------------------------- *
+ * description: copies the values of the active storage into its single       *
+ *              precision copy, allocating it on the first call. It must be   *
+ *              called after every assembly before using spmv32.              *
+ * -------------------------------------------------------------------------- *
+ * input:  sparseMatrix *self   // sparse matrix object                       *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void updateSingleValues(sparseMatrix *self);
+
+/******************************************************************************
+ * Function:    sameSparsity                                                  *
+ * -------------------------------------------------------------------------- *
+ * description: compares the row pointers and column indices of two CSR       *
+ *              matrices.                                                     *
+ * -------------------------------------------------------------------------- *
+ * input:  csrMatrix *A   // first  matrix                                    *
+ *         csrMatrix *B   // second matrix                                    *
+ * -------------------------------------------------------------------------- *
+ * output: int            // 1 if the sparsity patterns are equal, else 0     *
+ ******************************************************************************/
+int sameSparsity(csrMatrix *A, csrMatrix *B);
+
+/******************************************************************************
+ * Function:    diagonalCsr                                                   *
+ * -------------------------------------------------------------------------- *
+ * description: copies the main diagonal of a CSR matrix into a vector.       *
+ * -------------------------------------------------------------------------- *
+ * input:  csrMatrix *src   // source  matrix                                 *
+ *         vector1D  *dst   // destine vector                                 *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void diagonalCsr(csrMatrix *src, vector1D *dst);
+
+/******************************************************************************
+ * MATRIX-VECTOR PRODUCT                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    spmvXXX                                                       *
+ * -------------------------------------------------------------------------- *
+ * description: computes y = A x. spmv dispatches to the storage selected in  *
+ *              the sparseMatrix object.                                      *
+ * -------------------------------------------------------------------------- *
+ * input:  XXXMatrix *A   // sparse matrix                                    *
+ *         vector1D  *x   // input  vector                                    *
+ *         vector1D  *y   // output vector                                    *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void spmvCsr(csrMatrix *A, vector1D *x, vector1D *y);
+void spmvSell(sellMatrix *A, vector1D *x, vector1D *y);
+void spmv(sparseMatrix *A, vector1D *x, vector1D *y);
+
+/******************************************************************************
+ * Function:    spmvCsrRange                                                  *
+ * -------------------------------------------------------------------------- *
+ * description: computes the rows [begin, end) of y = A x, e.g. as the body   *
+ *              of a parallel loop of the thread pool.                        *
+ * -------------------------------------------------------------------------- *
+ * input:  csrMatrix    *A       // sparse matrix                             *
+ *         vector1D     *x       // input  vector                             *
+ *         vector1D     *y       // output vector                             *
+ *         const integer begin   // first row of the range                    *
+ *         const integer end     // one past the last row                     *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void spmvCsrRange(csrMatrix *A, vector1D *x, vector1D *y, const integer begin,
+    const integer end);
+
+/******************************************************************************
+ * Function:    spmvCsrPool                                                   *
+ * -------------------------------------------------------------------------- *
+ * description: computes y = A x with spmvCsrRange run on the ranges of rows  *
+ *              of a parallelFor of the pool.                                 *
+ * -------------------------------------------------------------------------- *
+ * input:  threadPool *pool   // thread pool                                  *
+ *         csrMatrix  *A      // sparse matrix                                *
+ *         vector1D   *x      // input  vector                                *
+ *         vector1D   *y      // output vector                                *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void spmvCsrPool(threadPool *pool, csrMatrix *A, vector1D *x, vector1D *y);
+
+/******************************************************************************
+ * Function:    spmvCsrPair                                                   *
+ * -------------------------------------------------------------------------- *
+ * description: computes y1 = A1 x1 and y2 = A2 x2 for two matrices with the  *
+ *              same sparsity pattern, streaming the indices of A1 once.      *
+ * -------------------------------------------------------------------------- *
+ * input:  csrMatrix *A1, *A2   // matrices with the same pattern             *
+ *         vector1D  *x1, *x2   // input  vectors                             *
+ *         vector1D  *y1, *y2   // output vectors                             *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void spmvCsrPair(csrMatrix *A1, csrMatrix *A2, vector1D *x1, vector1D *x2,
+    vector1D *y1, vector1D *y2);
+
+/******************************************************************************
+ * Function:    spmvXXX32                                                     *
+ * -------------------------------------------------------------------------- *
+ * description: computes y = A x in single precision, with the values copied  *
+ *              by updateSingleValues. The indices are shared with the double *
+ *              precision storage, so only the values and vectors shrink.     *
+ * -------------------------------------------------------------------------- *
+ * input:  XXXMatrix *A   // sparse matrix                                    *
+ *         real32    *x   // input  array                                     *
+ *         real32    *y   // output array                                     *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void spmvCsr32(csrMatrix *A, const real32 *x, real32 *y);
+void spmvSell32(sellMatrix *A, const real32 *x, real32 *y);
+void spmv32(sparseMatrix *A, const real32 *x, real32 *y);
+
+#endif
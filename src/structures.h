@@ -6,7 +6,7 @@
  * E-mail: almeriopamplona@gmail.com                                          *
  ******************************************************************************
  * Creation date    : 27.01.2021                                              *
- * Modification date: 07.02.2021                                              *
+ * Modification date: 19.10.2026                                              *
  ******************************************************************************
  * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
  *                                                                            *
@@ -33,16 +33,32 @@
  ******************************************************************************/
 
 #define PI 3.141592653589793238462643383279502884197169399375105820974944592308
-#define DTMAX    5e-03    // maximum  time step
-#define DTMIN    5e-11    // minimum  time step
+#define DTMAX    5e-03    // default maximum time step
+#define DTMIN    5e-11    // default minimum time step
 #define DTIMP    1e-02    // printing time step
-#define NCXMAX   500      // maximum number of cells in x-direction
-#define NCYMAX   500      // maximum number of cells in y-direction
-#define NCZMAX   500      // maximum number of cells in z-direction
-#define PNMAX    2e+04    // maximum number of particles in simulation
-#define DNMAX    5e+03    // maximum number of dummy     in simulation
-#define WNMAX    1e+03    // maximum number of wall      in simulation
 #define MAXIT    50       // maximum iteration number
+#define GROWTH   1.5      // capacity growth factor of the resizable objects
+#define REACH_ALL (~(integer) 0) // neighbour bound that leaves none out
+
+/******************************************************************************
+ * SPATIAL DIMENSION                                                          *
+ ******************************************************************************/
+
+/* CMPS_DIM = 2 or 3 builds the particle kernels for that dimension only; the */
+/* default 0 builds both variants and selects one with par->dim at run time.  */
+/* The kernels take the dimension as a last constant argument, so that each   */
+/* variant is compiled with the z work and the z cells folded away.           */
+
+#ifndef CMPS_DIM
+#define CMPS_DIM 0
+#endif
+
+#if CMPS_DIM == 2 || CMPS_DIM == 3
+#define DIM_DISPATCH(dim, kernel, ...) kernel(__VA_ARGS__, CMPS_DIM)
+#else
+#define DIM_DISPATCH(dim, kernel, ...) \
+    (((dim) == 2) ? kernel(__VA_ARGS__, 2) : kernel(__VA_ARGS__, 3))
+#endif
 
 /******************************************************************************
  * STRUCTURES                                                                 *
@@ -56,12 +72,60 @@ typedef enum boolean {
 
 } boolean;
 
+/* Pressure computation: */
+typedef enum pressureMode {
+
+    PRESSURE_IMPLICIT = 0,  /* pressure Poisson equation (MPS)                */
+    PRESSURE_EXPLICIT = 1   /* equation of state on pndS (EMPS)               */
+
+} pressureMode;
+
+/* Particle type: */
+typedef enum particleType {
+
+    PARTICLE_FLUID = 0,     /* fluid particle                                 */
+    PARTICLE_WALL  = 1,     /* wall particle: fixed, pressure from the fluid  */
+    PARTICLE_DUMMY = 2,     /* dummy particle: fixed, only completes the pnd  */
+    PARTICLE_TYPES = 3      /* number of particle types                       */
+
+} particleType;
+
+/* Simulation parameters: */
+typedef struct parameters {
+    integer      np;       /* number of particles                             */
+    integer      dim;      /* number of dimensions: 2 or 3                    */
+    real         l0;       /* initial distance between particles              */
+    real         reS;      /* small effective radius                          */
+    real         reL;      /* large effective radius                          */
+    real         n0S;      /* initial particle number density, small radius   */
+    real         n0L;      /* initial particle number density, large radius   */
+    real         lambda;   /* Laplacian model coefficient                     */
+    real         rho;      /* fluid density                                   */
+    real         nu;       /* kinematic viscosity                             */
+    real         kappa;    /* thermal diffusivity                             */
+    real         c0;       /* numerical speed of sound for the EMPS           */
+    real         beta;     /* free-surface threshold on pndS / n0S            */
+    real         dt;       /* time step                                       */
+    real         g[3];     /* gravity acceleration                            */
+    pressureMode pressure; /* implicit or explicit pressure                   */
+
+} parameters;
+
 /* Fluid particle: */
+/* the neighbour lists are packed one particle after the other: the k-th     */
+/* neighbour of the particle i is neighX.arr[startX.arr[i] + k], with         */
+/* k < nNeighX.arr[i], and its distance to i is dNeighX.x[startX.arr[i] + k]. */
+/* The search sizes the lists from the neighbours actually found.             */
 typedef struct fluid {
     intArray index;        /* material index                                  */
     intArray idMat;        /* material id                                     */
+    intArray type;         /* particle type, a particleType                   */
     intArray neighS;       /* neighbour's id list for small radius            */
     intArray neighL;       /* neighbour's id list for large radius            */
+    intArray nNeighS;      /* number of neighbours for small radius           */
+    intArray nNeighL;      /* number of neighbours for large radius           */
+    intArray startS;       /* first list slot of each particle, small radius  */
+    intArray startL;       /* first list slot of each particle, large radius  */
     vector1D pressure;     /* pressure                                        */
     vector1D pressurek0;   /* pressure variation                              */
     vector1D temperature;  /* temperature                                     */
@@ -69,8 +133,8 @@ typedef struct fluid {
     vector1D pndL;         /* particle number of density for large radius     */
     vector1D pndB;         /* particle number of density for boundaries       */
     vector1D pndMat;       /* particle number of density per material         */
-    vector1D dNeighS;
-    vector1D dNeighL;
+    vector1D dNeighS;      /* neighbour's distance list for small radius      */
+    vector1D dNeighL;      /* neighbour's distance list for large radius      */
     vector3D r;
     vector3D rn;
     vector3D dr;
@@ -78,6 +142,7 @@ typedef struct fluid {
     vector3D un;
     vector3D du;
     vector3D normal;      /* normal vector for solid wall particles           */ 
+    integer  capacity;    /* number of particles the fields can hold          */
 
 } fluid;
 
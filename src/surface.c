@@ -0,0 +1,266 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                               SURFACE.C                                    *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "surface.h"
+#include "neighbours.h"
+
+#include <stdio.h>  /*input and output variable manipulation*/
+#include <stdlib.h> /*address and memory manipulation*/
+
+/******************************************************************************
+ * AUXILIARY FUNCTIONS                                                        *
+ ******************************************************************************/
+
+static void *growArray(void *old, const integer size)
+{
+    void *self = realloc(old, size);
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the surface list\n");
+        exit (EXIT_FAILURE);
+    }
+
+    return self;
+}
+
+/* the lists are rebuilt on every detection: their content is not kept */
+static void reserveSurfaceList(surfaceList *self, const integer np)
+{
+    if (np <= self->capacity)
+    {
+        return;
+    }
+
+    const integer grown = (integer) (GROWTH * self->capacity);
+    const integer n     = (grown > np) ? grown : np;
+
+    self->surface  = (integer *) growArray(self->surface,  n*sizeof(integer));
+    self->interior = (integer *) growArray(self->interior, n*sizeof(integer));
+    self->row      = (integer *) growArray(self->row,      n*sizeof(integer));
+    self->flag     = (unsigned char *) growArray(self->flag, n);
+    self->capacity = n;
+}
+
+/* weighted normal of each particle, flagging the ones above the tolerance */
+static inline void surfaceNormalDim(fluid *particles, parameters *par,
+    unsigned char *flag, const real tol2, const integer dim)
+{
+    long i; /*particle counter loop, signed for OpenMP*/
+
+    const long np = (long) par->np;
+
+    #pragma omp parallel for schedule(static)
+    for (i = 0; i < np; i++)
+    {
+        const integer  o  = particles->startS.arr[i];
+        const integer *nb = particles->neighS.arr + o;
+        const real    *d  = particles->dNeighS.x  + o;
+        const integer  nS = particles->nNeighS.arr[i];
+        integer k;
+
+        real nx = 0.0, ny = 0.0, nz = 0.0;
+
+        for (k = 0; k < nS; k++)
+        {
+            const integer j = nb[k];
+            const real    w = weight(d[k], par->reS);
+
+            nx += w * (particles->r.x[i] - particles->r.x[j]);
+            ny += w * (particles->r.y[i] - particles->r.y[j]);
+
+            if (dim == 3)
+            {
+                nz += w * (particles->r.z[i] - particles->r.z[j]);
+            }
+        }
+
+        nx /= par->n0S;
+        ny /= par->n0S;
+        nz /= par->n0S;
+
+        particles->normal.x[i] = nx;
+        particles->normal.y[i] = ny;
+
+        if (dim == 3)
+        {
+            particles->normal.z[i] = nz;
+        }
+
+        flag[i] |= (unsigned char) (nx*nx + ny*ny + nz*nz > tol2);
+    }
+}
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+surfaceList *makeSurfaceList(const integer np)
+{
+    surfaceList *self = (surfaceList *) malloc(sizeof(surfaceList));
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the object\n");
+        exit (EXIT_FAILURE);
+    }
+
+    const integer n = (np > 0) ? np : 1;
+
+    self->capacity  = np;
+    self->nSurface  = 0;
+    self->nInterior = 0;
+    self->surface   = (integer *) malloc(n * sizeof(integer));
+    self->interior  = (integer *) malloc(n * sizeof(integer));
+    self->row       = (integer *) malloc(n * sizeof(integer));
+    self->flag      = (unsigned char *) malloc(n * sizeof(unsigned char));
+
+    if (self->surface == NULL || self->interior == NULL || self->row == NULL
+        || self->flag == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the surface list\n");
+        exit (EXIT_FAILURE);
+    }
+
+    return self;
+}
+
+void freeSurfaceList(surfaceList *self)
+{
+    free(self->surface);
+    free(self->interior);
+    free(self->row);
+    free(self->flag);
+    free(self);
+}
+
+/******************************************************************************
+ * FREE-SURFACE DETECTION                                                     *
+ ******************************************************************************/
+
+void initSurfaceConfig(surfaceConfig *cfg)
+{
+    cfg->minNeigh  = 0;
+    cfg->useNormal = false;
+    cfg->normalTol = 0.2;
+}
+
+void detectFreeSurface(fluid *particles, parameters *par, surfaceConfig *cfg,
+    surfaceList *surf)
+{
+    long i; /*particle counter loop, signed for OpenMP*/
+    long b; /*block    counter loop, signed for OpenMP*/
+
+    const long    np      = (long) par->np;
+    const long    nblocks = (np + SURFACE_BLOCK - 1) / SURFACE_BLOCK;
+    const real    nSurf   = par->beta * par->n0S;
+    const real   *pnd     = particles->pndS.x;
+
+    reserveSurfaceList(surf, par->np);
+
+    unsigned char *flag = surf->flag;
+
+    /*particle number density criterion*/
+    #pragma omp parallel for simd schedule(static)
+    for (i = 0; i < np; i++)
+    {
+        flag[i] = (unsigned char) (pnd[i] < nSurf);
+    }
+
+    /*neighbour count criterion*/
+    if (cfg->minNeigh > 0)
+    {
+        const integer *nL = particles->nNeighL.arr;
+
+        #pragma omp parallel for simd schedule(static)
+        for (i = 0; i < np; i++)
+        {
+            flag[i] |= (unsigned char) (nL[i] < cfg->minNeigh);
+        }
+    }
+
+    /*normal vector criterion*/
+    if (cfg->useNormal)
+    {
+        const real tol2 = cfg->normalTol * par->l0 * cfg->normalTol * par->l0;
+
+        DIM_DISPATCH(par->dim, surfaceNormalDim, particles, par, flag, tol2);
+    }
+
+    /*compaction: surface particles per block, prefix sum, scatter*/
+    integer *offset = (integer *) malloc((nblocks + 1) * sizeof(integer));
+
+    if (offset == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the block offsets\n");
+        exit (EXIT_FAILURE);
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (b = 0; b < nblocks; b++)
+    {
+        const long end = (b + 1) * SURFACE_BLOCK < np ? (b + 1) * SURFACE_BLOCK
+                                                      : np;
+        integer count = 0;
+        long k;
+
+        for (k = b * SURFACE_BLOCK; k < end; k++)
+        {
+            count += flag[k];
+        }
+
+        offset[b + 1] = count;
+    }
+
+    offset[0] = 0;
+
+    for (b = 0; b < nblocks; b++)
+    {
+        offset[b + 1] += offset[b];
+    }
+
+    #pragma omp parallel for schedule(static)
+    for (b = 0; b < nblocks; b++)
+    {
+        const long end = (b + 1) * SURFACE_BLOCK < np ? (b + 1) * SURFACE_BLOCK
+                                                      : np;
+        integer s = offset[b];
+        integer t = b * SURFACE_BLOCK - offset[b];
+        long k;
+
+        for (k = b * SURFACE_BLOCK; k < end; k++)
+        {
+            if (flag[k])
+            {
+                surf->surface[s++] = k;
+                surf->row[k]       = SURFACE_NONE;
+            }
+            else
+            {
+                surf->interior[t] = k;
+                surf->row[k]      = t++;
+            }
+        }
+    }
+
+    surf->nSurface  = offset[nblocks];
+    surf->nInterior = par->np - surf->nSurface;
+
+    free(offset);
+}
@@ -0,0 +1,123 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                               SURFACE.H                                    *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Free-surface detection. A particle is on the free surface when its pndS is *
+ * below beta n0S or, optionally, when it has too few neighbours or when its  *
+ * normal vector, the weighted mean of the directions to its neighbours, is   *
+ * too long. The result is kept as compact index lists of surface and         *
+ * interior particles, so the following stages iterate over the list they     *
+ * need instead of testing a flag per particle.                               *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __SURFACE_H__
+#define __SURFACE_H__
+
+#include "structures.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+#define SURFACE_BLOCK   4096            /* particles per compaction block     */
+#define SURFACE_NONE    ((integer) -1)  /* row of a free-surface particle     */
+
+typedef struct surfaceConfig
+{
+    integer minNeigh;   /* surface below this number of neighbours, 0 = off   */
+    boolean useNormal;  /* use the normal vector criterion                    */
+    real    normalTol;  /* surface when |normal| > normalTol l0               */
+
+} surfaceConfig;
+
+typedef struct surfaceList
+{
+    integer        capacity;   /* number of particles, grown when exceeded    */
+    integer        nSurface;   /* number of free-surface particles            */
+    integer        nInterior;  /* number of interior particles                */
+    integer       *surface;    /* indices of the free-surface particles       */
+    integer       *interior;   /* indices of the interior particles           */
+    integer       *row;        /* position in interior, SURFACE_NONE if none  */
+    unsigned char *flag;       /* 1 for free-surface particles                */
+
+} surfaceList;
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    makeSurfaceList                                               *
+ * -------------------------------------------------------------------------- *
+ * description: creates empty surface and interior lists for np particles.    *
+ *              They grow on detection when the case has more particles.      *
+ * -------------------------------------------------------------------------- *
+ * input:  const integer np   // initial number of particles                  *
+ * -------------------------------------------------------------------------- *
+ * output: surfaceList *self                                                  *
+ ******************************************************************************/
+surfaceList *makeSurfaceList(const integer np);
+
+/******************************************************************************
+ * Function:    freeSurfaceList                                               *
+ * -------------------------------------------------------------------------- *
+ * description: deallocates the lists and the object itself.                  *
+ * -------------------------------------------------------------------------- *
+ * input:  surfaceList *self   // surface lists                               *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void freeSurfaceList(surfaceList *self);
+
+/******************************************************************************
+ * FREE-SURFACE DETECTION                                                     *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    initSurfaceConfig                                             *
+ * -------------------------------------------------------------------------- *
+ * description: fills the configuration with the default values: only the     *
+ *              pndS criterion, normal tolerance 0.2 when enabled.            *
+ * -------------------------------------------------------------------------- *
+ * input:  surfaceConfig *cfg   // detection configuration                    *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void initSurfaceConfig(surfaceConfig *cfg);
+
+/******************************************************************************
+ * Function:    detectFreeSurface                                             *
+ * -------------------------------------------------------------------------- *
+ * description: flags the free-surface particles and compacts them into the   *
+ *              surface and interior lists, both in increasing index order.   *
+ *              The flags are computed by branch-free loops over contiguous   *
+ *              arrays and the compaction runs by blocks of SURFACE_BLOCK     *
+ *              particles with a prefix sum, both threaded with OpenMP when   *
+ *              enabled. With the normal criterion, fluid.normal is updated.  *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid         *particles   // fluid particles                      *
+ *         parameters    *par         // simulation parameters                *
+ *         surfaceConfig *cfg         // detection configuration              *
+ *         surfaceList   *surf        // surface and interior lists           *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void detectFreeSurface(fluid *particles, parameters *par, surfaceConfig *cfg,
+    surfaceList *surf);
+
+#endif
@@ -0,0 +1,389 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                              TASKGRAPH.C                                   *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "taskgraph.h"
+#include "prediction.h"
+#include "pressure.h"
+#include "timestep.h"
+
+#include <stdio.h>     /*input and output variable manipulation*/
+#include <stdlib.h>    /*address and memory manipulation*/
+#include <string.h>    /*memory copies*/
+#include <stdatomic.h> /*dependency counters*/
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+typedef struct stepPhase
+{
+    const char   *name;         /* name of the phase                          */
+    taskFunction  run;          /* phase                                      */
+    void         *arg;          /* argument of the phase                      */
+    unsigned      reads;        /* stepField flags read                       */
+    unsigned      writes;       /* stepField flags written                    */
+    integer      *next;         /* phases waiting for this one                */
+    integer       nnext;        /* number of phases waiting                   */
+    integer       ndeps;        /* number of phases waited for                */
+    atomic_ulong  waiting;      /* phases still to complete in this replay    */
+    stepGraph    *graph;        /* owner of the phase                         */
+
+} stepPhase;
+
+struct stepGraph
+{
+    stepPhase  *phases;         /* phases in insertion order                  */
+    integer     nphases;        /* number of phases                           */
+    integer     capacity;       /* slots in phases                            */
+    threadPool *pool;           /* pool of the current replay                 */
+};
+
+/******************************************************************************
+ * AUXILIARY FUNCTIONS                                                        *
+ ******************************************************************************/
+
+static void *growArray(void *old, const integer size)
+{
+    void *self = realloc(old, size > 0 ? size : 1);
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the step graph\n");
+        exit (EXIT_FAILURE);
+    }
+
+    return self;
+}
+
+static int conflicts(const stepPhase *before, const unsigned reads,
+    const unsigned writes)
+{
+    return (before->writes & (reads | writes)) || (before->reads & writes);
+}
+
+static void runPhase(void *arg)
+{
+    register integer k;
+
+    stepPhase *phase = (stepPhase *) arg;
+    stepGraph *graph = phase->graph;
+
+    phase->run(phase->arg);
+
+    /*the last predecessor to complete spawns the phase*/
+    for (k = 0; k < phase->nnext; k++)
+    {
+        stepPhase *next = graph->phases + phase->next[k];
+
+        if (atomic_fetch_sub(&next->waiting, 1) == 1)
+        {
+            spawnTask(graph->pool, runPhase, next);
+        }
+    }
+}
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+stepGraph *makeStepGraph(void)
+{
+    stepGraph *self = (stepGraph *) malloc(sizeof(stepGraph));
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the object\n");
+        exit (EXIT_FAILURE);
+    }
+
+    self->phases   = NULL;
+    self->nphases  = 0;
+    self->capacity = 0;
+    self->pool     = NULL;
+
+    return self;
+}
+
+void freeStepGraph(stepGraph *self)
+{
+    register integer k;
+
+    for (k = 0; k < self->nphases; k++)
+    {
+        free(self->phases[k].next);
+    }
+
+    free(self->phases);
+    free(self);
+}
+
+/******************************************************************************
+ * GRAPH CONSTRUCTION AND REPLAY                                              *
+ ******************************************************************************/
+
+integer addPhase(stepGraph *graph, const char *name, taskFunction run,
+    void *arg, const unsigned reads, const unsigned writes)
+{
+    register integer k;
+
+    if (graph->nphases == graph->capacity)
+    {
+        graph->capacity = (graph->capacity > 0) ? 2 * graph->capacity : 16;
+        graph->phases   = (stepPhase *) growArray(graph->phases,
+            graph->capacity * sizeof(stepPhase));
+    }
+
+    const integer id    = graph->nphases++;
+    stepPhase    *phase = graph->phases + id;
+
+    phase->name   = name;
+    phase->run    = run;
+    phase->arg    = arg;
+    phase->reads  = reads;
+    phase->writes = writes;
+    phase->next   = NULL;
+    phase->nnext  = 0;
+    phase->ndeps  = 0;
+
+    for (k = 0; k < id; k++)
+    {
+        stepPhase *before = graph->phases + k;
+
+        if (conflicts(before, reads, writes))
+        {
+            before->next = (integer *) growArray(before->next,
+                (before->nnext + 1) * sizeof(integer));
+            before->next[before->nnext++] = id;
+            phase->ndeps++;
+        }
+    }
+
+    return id;
+}
+
+void runStepGraph(stepGraph *graph, threadPool *pool)
+{
+    register integer k;
+
+    if (pool == NULL)
+    {
+        for (k = 0; k < graph->nphases; k++)
+        {
+            graph->phases[k].run(graph->phases[k].arg);
+        }
+
+        return;
+    }
+
+    /*the phases array is stable during a replay: no phase is added*/
+    graph->pool = pool;
+
+    for (k = 0; k < graph->nphases; k++)
+    {
+        graph->phases[k].graph = graph;
+        atomic_store(&graph->phases[k].waiting, graph->phases[k].ndeps);
+    }
+
+    for (k = 0; k < graph->nphases; k++)
+    {
+        if (graph->phases[k].ndeps == 0)
+        {
+            spawnTask(pool, runPhase, graph->phases + k);
+        }
+    }
+
+    waitTasks(pool);
+}
+
+void transverseGraph(stepGraph *graph)
+{
+    register integer i, k, j;
+
+    for (i = 0; i < graph->nphases; i++)
+    {
+        printf("%lu %s <-", i, graph->phases[i].name);
+
+        for (j = 0; j < i; j++)
+        {
+            for (k = 0; k < graph->phases[j].nnext; k++)
+            {
+                if (graph->phases[j].next[k] == i)
+                {
+                    printf(" %s", graph->phases[j].name);
+                }
+            }
+        }
+
+        printf("\n");
+    }
+}
+
+/******************************************************************************
+ * MPS TIME STEP                                                              *
+ ******************************************************************************/
+
+static void storePhase(void *arg)
+{
+    mpsStep *s  = (mpsStep *) arg;
+    fluid   *f  = s->particles;
+    const integer bytes = s->par->np * sizeof(real);
+
+    memcpy(f->rn.x, f->r.x, bytes);
+    memcpy(f->rn.y, f->r.y, bytes);
+    memcpy(f->rn.z, f->r.z, bytes);
+    memcpy(f->un.x, f->u.x, bytes);
+    memcpy(f->un.y, f->u.y, bytes);
+    memcpy(f->un.z, f->u.z, bytes);
+}
+
+/* the state of the previous step is read from un and rn */
+static void stagePhase(void *arg)
+{
+    mpsStep *s  = (mpsStep *) arg;
+    fluid   *f  = s->particles;
+    const integer bytes = s->par->np * sizeof(real);
+
+    memcpy(s->outR->x, f->rn.x, bytes);
+    memcpy(s->outR->y, f->rn.y, bytes);
+    memcpy(s->outR->z, f->rn.z, bytes);
+    memcpy(s->outU->x, f->un.x, bytes);
+    memcpy(s->outU->y, f->un.y, bytes);
+    memcpy(s->outU->z, f->un.z, bytes);
+    memcpy(s->outP->x, f->pressure.x,    bytes);
+    memcpy(s->outT->x, f->temperature.x, bytes);
+}
+
+static void predictPhase(void *arg)
+{
+    mpsStep *s = (mpsStep *) arg;
+
+    predictionStep(s->particles, s->par);
+}
+
+static void neighbourPhase(void *arg)
+{
+    mpsStep *s = (mpsStep *) arg;
+
+    searchNeighbours(s->grid, s->particles, s->par);
+}
+
+static void pndPhase(void *arg)
+{
+    mpsStep *s = (mpsStep *) arg;
+
+    computePnd(s->particles, s->par);
+}
+
+static void surfacePhase(void *arg)
+{
+    mpsStep *s = (mpsStep *) arg;
+
+    detectFreeSurface(s->particles, s->par, s->surfCfg, s->surf);
+}
+
+static void temperaturePhase(void *arg)
+{
+    mpsStep *s = (mpsStep *) arg;
+
+    computeTemperature(s->particles, s->par, s->thermal, s->thermalCfg);
+}
+
+static void assemblePhase(void *arg)
+{
+    mpsStep *s = (mpsStep *) arg;
+
+    if (s->par->pressure == PRESSURE_EXPLICIT)
+    {
+        return;
+    }
+
+    s->b = makeVector1D(s->surf->nInterior);
+    s->A = makeSparseMatrix(assemblePressurePoisson(s->particles, s->par,
+        s->surf, s->b), s->pressureCfg->format);
+}
+
+static void solvePhase(void *arg)
+{
+    mpsStep *s = (mpsStep *) arg;
+
+    if (s->par->pressure == PRESSURE_EXPLICIT)
+    {
+        explicitPressure(s->particles, s->par);
+        return;
+    }
+
+    solvePressure(s->particles, s->surf->interior, s->A, s->b,
+        s->pressureCfg);
+    applyPressureBoundary(s->particles, s->surf);
+
+    freeSparseMatrix(s->A);
+    freeVector1D(s->b);
+
+    s->A = NULL;
+    s->b = NULL;
+}
+
+static void correctPhase(void *arg)
+{
+    mpsStep *s = (mpsStep *) arg;
+
+    s->uMax = correctVelocity(s->particles, s->par);
+}
+
+void buildMpsStepGraph(stepGraph *graph, mpsStep *step)
+{
+    step->A    = NULL;
+    step->b    = NULL;
+    step->uMax = 0.0;
+
+    addPhase(graph, "store", storePhase, step,
+        FIELD_R | FIELD_U, FIELD_RN | FIELD_UN);
+
+    if (step->outR != NULL)
+    {
+        addPhase(graph, "stage", stagePhase, step,
+            FIELD_RN | FIELD_UN | FIELD_PRESSURE | FIELD_TEMPERATURE,
+            FIELD_OUTPUT);
+    }
+
+    addPhase(graph, "predict", predictPhase, step,
+        FIELD_RN | FIELD_UN | FIELD_NEIGH, FIELD_R | FIELD_U | FIELD_DR);
+    addPhase(graph, "neighbours", neighbourPhase, step,
+        FIELD_R, FIELD_NEIGH);
+    addPhase(graph, "pnd", pndPhase, step,
+        FIELD_NEIGH, FIELD_PND);
+    /*the normal criterion reads the positions and writes the normals*/
+    addPhase(graph, "surface", surfacePhase, step,
+        FIELD_NEIGH | FIELD_PND | FIELD_R, FIELD_SURFACE | FIELD_NORMAL);
+
+    if (step->thermalCfg != NULL)
+    {
+        addPhase(graph, "temperature", temperaturePhase, step,
+            FIELD_NEIGH | FIELD_TEMPERATURE, FIELD_TEMPERATURE);
+    }
+
+    addPhase(graph, "assemble", assemblePhase, step,
+        FIELD_NEIGH | FIELD_PND | FIELD_SURFACE, FIELD_SYSTEM);
+    addPhase(graph, "solve", solvePhase, step,
+        FIELD_SYSTEM | FIELD_SURFACE | FIELD_PND | FIELD_PRESSURE,
+        FIELD_SYSTEM | FIELD_PRESSURE);
+    addPhase(graph, "correct", correctPhase, step,
+        FIELD_NEIGH | FIELD_PRESSURE | FIELD_R | FIELD_U,
+        FIELD_R | FIELD_U | FIELD_DU);
+}
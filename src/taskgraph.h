@@ -0,0 +1,185 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                              TASKGRAPH.H                                   *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Dependency graph of the phases of one time step. Every phase declares the  *
+ * fields it reads and writes as a set of stepField flags; a phase depends on *
+ * each earlier phase that writes what it reads (read after write), reads or  *
+ * writes what it writes (write after read, write after write). The graph is  *
+ * built once and replayed every step on the thread pool: a phase is spawned  *
+ * as soon as all the phases it depends on have completed, so independent     *
+ * phases run concurrently. Without a pool the phases run in the order they   *
+ * were added, which is always a valid order.                                 *
+ *                                                                            *
+ * buildMpsStepGraph adds the phases of a semi-implicit MPS step. With these  *
+ * declarations the output staging of the previous state runs alongside the   *
+ * prediction and the neighbour search, and the temperature update alongside  *
+ * the pressure assembly, solve and correction.                               *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __TASKGRAPH_H__
+#define __TASKGRAPH_H__
+
+#include "structures.h"
+#include "threadpool.h"
+#include "neighbours.h"
+#include "surface.h"
+#include "solver.h"
+#include "thermal.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+typedef enum stepField
+{
+    FIELD_R           = 1 << 0,   /* positions                                */
+    FIELD_RN          = 1 << 1,   /* positions at the start of the step       */
+    FIELD_DR          = 1 << 2,   /* displacements                            */
+    FIELD_U           = 1 << 3,   /* velocities                               */
+    FIELD_UN          = 1 << 4,   /* velocities at the start of the step      */
+    FIELD_DU          = 1 << 5,   /* velocity corrections                     */
+    FIELD_NEIGH       = 1 << 6,   /* cell grid, neighbour lists and distances */
+    FIELD_PND         = 1 << 7,   /* particle number densities                */
+    FIELD_SURFACE     = 1 << 8,   /* free-surface and interior lists          */
+    FIELD_SYSTEM      = 1 << 9,   /* assembled pressure Poisson equation      */
+    FIELD_PRESSURE    = 1 << 10,  /* pressures                                */
+    FIELD_TEMPERATURE = 1 << 11,  /* temperatures                             */
+    FIELD_OUTPUT      = 1 << 12,  /* output staging buffers                   */
+    FIELD_NORMAL      = 1 << 13   /* free-surface normals                     */
+
+} stepField;
+
+typedef struct stepGraph stepGraph;
+
+typedef struct mpsStep
+{
+    fluid         *particles;   /* fluid particles                            */
+    parameters    *par;         /* simulation parameters                      */
+    cellGrid      *grid;        /* cell grid of the neighbour search          */
+    surfaceList   *surf;        /* free-surface and interior lists            */
+    surfaceConfig *surfCfg;     /* free-surface criteria                      */
+    solverConfig  *pressureCfg; /* pressure solver                            */
+    solverConfig  *thermalCfg;  /* heat equation solver, NULL without heat    */
+    thermalMode    thermal;     /* temperature update                         */
+    vector3D      *outR;        /* staged positions, NULL without staging     */
+    vector3D      *outU;        /* staged velocities                          */
+    vector1D      *outP;        /* staged pressures                           */
+    vector1D      *outT;        /* staged temperatures                        */
+    sparseMatrix  *A;           /* pressure matrix between assembly and solve */
+    vector1D      *b;           /* right-hand side between assembly and solve */
+    real           uMax;        /* maximum velocity after the correction      */
+
+} mpsStep;
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    makeStepGraph                                                 *
+ * -------------------------------------------------------------------------- *
+ * description: creates an empty graph.                                       *
+ * -------------------------------------------------------------------------- *
+ * input:  void                                                               *
+ * -------------------------------------------------------------------------- *
+ * output: stepGraph *self                                                    *
+ ******************************************************************************/
+stepGraph *makeStepGraph(void);
+
+/******************************************************************************
+ * Function:    freeStepGraph                                                 *
+ * -------------------------------------------------------------------------- *
+ * description: deallocates the graph. The phase arguments are not freed.     *
+ * -------------------------------------------------------------------------- *
+ * input:  stepGraph *self   // step graph                                    *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void freeStepGraph(stepGraph *self);
+
+/******************************************************************************
+ * GRAPH CONSTRUCTION AND REPLAY                                              *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    addPhase                                                      *
+ * -------------------------------------------------------------------------- *
+ * description: appends the phase run(arg) and links it to every earlier      *
+ *              phase whose field sets conflict with reads and writes.        *
+ * -------------------------------------------------------------------------- *
+ * input:  stepGraph    *graph    // step graph                               *
+ *         const char   *name     // name of the phase, for transverseGraph   *
+ *         taskFunction  run      // phase                                    *
+ *         void         *arg      // argument of the phase                    *
+ *         const unsigned reads   // stepField flags read by the phase        *
+ *         const unsigned writes  // stepField flags written by the phase     *
+ * -------------------------------------------------------------------------- *
+ * output: integer                // index of the phase                       *
+ ******************************************************************************/
+integer addPhase(stepGraph *graph, const char *name, taskFunction run,
+    void *arg, const unsigned reads, const unsigned writes);
+
+/******************************************************************************
+ * Function:    runStepGraph                                                  *
+ * -------------------------------------------------------------------------- *
+ * description: runs every phase once, each after the phases it depends on,   *
+ *              and returns when all have completed. With pool = NULL the     *
+ *              phases run serially in the order they were added.             *
+ * -------------------------------------------------------------------------- *
+ * input:  stepGraph  *graph   // step graph                                  *
+ *         threadPool *pool    // thread pool, NULL to run serially           *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void runStepGraph(stepGraph *graph, threadPool *pool);
+
+/******************************************************************************
+ * Function:    transverseGraph                                               *
+ * -------------------------------------------------------------------------- *
+ * description: prints every phase with the phases it waits for.              *
+ * -------------------------------------------------------------------------- *
+ * input:  stepGraph *graph   // step graph                                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void transverseGraph(stepGraph *graph);
+
+/******************************************************************************
+ * MPS TIME STEP                                                              *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    buildMpsStepGraph                                             *
+ * -------------------------------------------------------------------------- *
+ * description: adds the phases of one MPS step on the data of step: store    *
+ *              of un and rn, output staging (if outR is set), prediction,    *
+ *              neighbour search, particle number density, free-surface       *
+ *              detection, temperature (if thermalCfg is set), pressure       *
+ *              assembly, pressure solve (or equation of state) and velocity  *
+ *              correction. The time step par->dt is chosen between two       *
+ *              replays, e.g. with nextTimeStep and step->uMax.               *
+ * -------------------------------------------------------------------------- *
+ * input:  stepGraph *graph   // empty step graph                             *
+ *         mpsStep   *step    // data of the step, kept alive by the caller   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void buildMpsStepGraph(stepGraph *graph, mpsStep *step);
+
+#endif
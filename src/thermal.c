@@ -0,0 +1,317 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                               THERMAL.C                                    *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "thermal.h"
+#include "pressure.h"
+#include "neighbours.h"
+
+#include <stdio.h>  /*input and output variable manipulation*/
+#include <stdlib.h> /*address and memory manipulation*/
+
+/******************************************************************************
+ * THERMAL METHODS                                                            *
+ ******************************************************************************/
+
+void explicitTemperature(fluid *particles, parameters *par)
+{
+    register integer i; /*particle counter loop*/
+
+    vector1D *dT = makeVector1D(par->np);
+
+    temperatureRateRange(particles, par, dT, 0, par->np);
+
+    for (i = 0; i < par->np; i++)
+    {
+        particles->temperature.x[i] += dT->x[i];
+    }
+
+    freeVector1D(dT);
+}
+
+csrMatrix *assembleHeatEquation(fluid *particles, parameters *par,
+    vector1D *b)
+{
+    register integer i; /*particle  counter loop*/
+    register integer k; /*neighbour counter loop*/
+
+    const real coef = par->dt * par->kappa * 2.0 * par->dim /
+        (par->lambda * par->n0L);
+
+    integer nnz = par->np;
+
+    for (i = 0; i < par->np; i++)
+    {
+        nnz += particles->nNeighL.arr[i];
+    }
+
+    csrMatrix *A = makeCsrMatrix(par->np, nnz);
+
+    nnz = 0;
+
+    for (i = 0; i < par->np; i++)
+    {
+        const integer *nb   = particles->neighL.arr + particles->startL.arr[i];
+        const real    *d    = particles->dNeighL.x  + particles->startL.arr[i];
+        const integer  diag = nnz++;
+
+        real sumW = 0.0;
+
+        A->rowPtr[i] = diag;
+
+        for (k = 0; k < particles->nNeighL.arr[i]; k++)
+        {
+            const real w = coef * weight(d[k], par->reL);
+
+            sumW += w;
+
+            A->colInd[nnz] = (integer32) nb[k];
+            A->val[nnz++]  = -w;
+        }
+
+        A->colInd[diag] = (integer32) i;
+        A->val[diag]    = 1.0 + sumW;
+        b->x[i]         = particles->temperature.x[i];
+    }
+
+    A->rowPtr[par->np] = nnz;
+    A->nnz             = nnz;
+
+    return A;
+}
+
+void assemblePressureHeat(fluid *particles, parameters *par, surfaceList *surf,
+    vector1D *bp, vector1D *bt, csrMatrix **Ap, csrMatrix **At)
+{
+    register integer i; /*particle  counter loop*/
+    register integer k; /*neighbour counter loop*/
+
+    const real    coef   = 2.0 * par->dim / (par->lambda * par->n0L);
+    const real    heat   = par->dt * par->kappa;
+    const real    source = par->rho / (par->dt * par->dt * par->n0S);
+    const integer n      = surf->nInterior;
+
+    integer nnzP = n;
+    integer nnzT = par->np;
+
+    for (i = 0; i < par->np; i++)
+    {
+        nnzT += particles->nNeighL.arr[i];
+
+        if (surf->row[i] != SURFACE_NONE)
+        {
+            nnzP += particles->nNeighL.arr[i];
+        }
+    }
+
+    csrMatrix *P = makeCsrMatrix(n, nnzP);
+    csrMatrix *T = makeCsrMatrix(par->np, nnzT);
+
+    nnzP = 0;
+    nnzT = 0;
+
+    /*the interior rows are in increasing particle order*/
+    for (i = 0; i < par->np; i++)
+    {
+        const integer *nb    = particles->neighL.arr + particles->startL.arr[i];
+        const real    *d     = particles->dNeighL.x  + particles->startL.arr[i];
+        const integer  r     = surf->row[i];
+        const integer  diagT = nnzT++;
+        const integer  diagP = (r != SURFACE_NONE) ? nnzP++ : 0;
+
+        real sumW = 0.0;
+
+        T->rowPtr[i] = diagT;
+
+        if (r != SURFACE_NONE)
+        {
+            P->rowPtr[r] = diagP;
+        }
+
+        for (k = 0; k < particles->nNeighL.arr[i]; k++)
+        {
+            const real w = coef * weight(d[k], par->reL);
+
+            sumW += w;
+
+            T->colInd[nnzT] = (integer32) nb[k];
+            T->val[nnzT++]  = -heat * w;
+
+            if (r != SURFACE_NONE && surf->row[nb[k]] != SURFACE_NONE)
+            {
+                P->colInd[nnzP] = (integer32) surf->row[nb[k]];
+                P->val[nnzP++]  = -w;
+            }
+        }
+
+        T->colInd[diagT] = (integer32) i;
+        T->val[diagT]    = 1.0 + heat * sumW;
+        bt->x[i]         = particles->temperature.x[i];
+
+        if (r != SURFACE_NONE)
+        {
+            P->colInd[diagP] = (integer32) r;
+            P->val[diagP]    = sumW;
+            bp->x[r]         = source * (particles->pndS.x[i] - par->n0S);
+        }
+    }
+
+    P->rowPtr[n]       = nnzP;
+    P->nnz             = nnzP;
+    T->rowPtr[par->np] = nnzT;
+    T->nnz             = nnzT;
+
+    *Ap = P;
+    *At = T;
+}
+
+void temperatureRateRange(fluid *particles, parameters *par, vector1D *dT,
+    const integer begin, const integer end)
+{
+    register integer i; /*particle  counter loop*/
+    register integer k; /*neighbour counter loop*/
+
+    const real coef = par->dt * par->kappa * 2.0 * par->dim /
+        (par->lambda * par->n0L);
+
+    for (i = begin; i < end; i++)
+    {
+        const integer *nb = particles->neighL.arr + particles->startL.arr[i];
+        const real    *d  = particles->dNeighL.x  + particles->startL.arr[i];
+        const real     Ti = particles->temperature.x[i];
+
+        real lap = 0.0;
+
+        for (k = 0; k < particles->nNeighL.arr[i]; k++)
+        {
+            lap += (particles->temperature.x[nb[k]] - Ti) *
+                weight(d[k], par->reL);
+        }
+
+        dT->x[i] = coef * lap;
+    }
+}
+
+void assembleHeatRange(fluid *particles, parameters *par, csrMatrix *A,
+    vector1D *b, const integer begin, const integer end)
+{
+    register integer i; /*particle  counter loop*/
+    register integer k; /*neighbour counter loop*/
+
+    if (par->kappa <= 0.0)
+    {
+        printf ("ERROR: the thermal diffusivity must be positive\n");
+        exit (EXIT_FAILURE);
+    }
+
+    const real coef = par->dt * 2.0 * par->dim / (par->lambda * par->n0L);
+
+    for (i = begin; i < end; i++)
+    {
+        const integer *nb   = particles->neighL.arr + particles->startL.arr[i];
+        const real    *d    = particles->dNeighL.x  + particles->startL.arr[i];
+        const integer  diag = A->rowPtr[i];
+
+        integer nnz  = diag + 1;
+        real    sumW = 0.0;
+
+        for (k = 0; k < particles->nNeighL.arr[i]; k++)
+        {
+            const real w = coef * weight(d[k], par->reL);
+
+            sumW += w;
+
+            A->colInd[nnz] = (integer32) nb[k];
+            A->val[nnz++]  = -w;
+        }
+
+        /*the row divided by kappa_i keeps the matrix symmetric*/
+        A->colInd[diag] = (integer32) i;
+        A->val[diag]    = 1.0 / par->kappa + sumW;
+        b->x[i]         = particles->temperature.x[i] / par->kappa;
+    }
+}
+
+integer computeTemperature(fluid *particles, parameters *par,
+    thermalMode mode, solverConfig *cfg)
+{
+    if (mode == THERMAL_EXPLICIT)
+    {
+        explicitTemperature(particles, par);
+        return 0;
+    }
+
+    vector1D     *b = makeVector1D(par->np);
+    sparseMatrix *A = makeSparseMatrix(
+        assembleHeatEquation(particles, par, b), cfg->format);
+
+    const integer it = (cfg->mode == SOLVER_MIXED) ?
+        mixedSolve(A, b, &particles->temperature, cfg) :
+        pcgSolve(A, b, &particles->temperature, cfg);
+
+    freeSparseMatrix(A);
+    freeVector1D(b);
+
+    return it;
+}
+
+integer computePressureTemperature(fluid *particles, parameters *par,
+    surfaceList *surf, solverConfig *cfg)
+{
+    csrMatrix *P, *T;
+    vector1D  *bp = makeVector1D(surf->nInterior);
+    vector1D  *bt = makeVector1D(par->np);
+    integer    it;
+
+    assemblePressureHeat(particles, par, surf, bp, bt, &P, &T);
+
+    const int paired = cfg->mode == SOLVER_DOUBLE && sameSparsity(P, T);
+
+    sparseMatrix *Ap = makeSparseMatrix(P, cfg->format);
+    sparseMatrix *At = makeSparseMatrix(T, cfg->format);
+
+    if (paired)
+    {
+        /*no free surface: the interior rows are the particles themselves*/
+        it = pcgSolvePair(Ap, bp, &particles->pressure,
+                          At, bt, &particles->temperature, cfg);
+    }
+    else
+    {
+        /*the pressure is solved last, its statistics are left in cfg*/
+        if (cfg->mode == SOLVER_MIXED)
+        {
+            mixedSolve(At, bt, &particles->temperature, cfg);
+        }
+        else
+        {
+            pcgSolve(At, bt, &particles->temperature, cfg);
+        }
+
+        it = solvePressure(particles, surf->interior, Ap, bp, cfg);
+    }
+
+    applyPressureBoundary(particles, surf);
+
+    freeSparseMatrix(Ap);
+    freeSparseMatrix(At);
+    freeVector1D(bp);
+    freeVector1D(bt);
+
+    return it;
+}
@@ -0,0 +1,175 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                               THERMAL.H                                    *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Heat conduction, dT/dt = kappa lap(T), with the MPS Laplacian model on the *
+ * large-radius neighbour lists and their cached distances. The explicit mode *
+ * is a forward Euler update; the implicit mode solves the backward Euler     *
+ * system (I - dt kappa L) T = T^n over every particle with the sparse        *
+ * solver. Together with the implicit pressure, both systems are assembled in *
+ * a single traversal of the neighbour lists and, when their sparsity         *
+ * patterns coincide (no free surface), solved in lockstep.                   *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __THERMAL_H__
+#define __THERMAL_H__
+
+#include "structures.h"
+#include "solver.h"
+#include "surface.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+typedef enum thermalMode
+{
+    THERMAL_EXPLICIT = 0,    /* forward Euler, no system is solved            */
+    THERMAL_IMPLICIT = 1     /* backward Euler with the sparse solver         */
+
+} thermalMode;
+
+/******************************************************************************
+ * THERMAL METHODS                                                            *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    explicitTemperature                                           *
+ * -------------------------------------------------------------------------- *
+ * description: forward Euler update T += dt kappa lap(T). It is stable for   *
+ *              dt kappa / l0^2 below about 1 / (2 dim).                      *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void explicitTemperature(fluid *particles, parameters *par);
+
+/******************************************************************************
+ * Function:    assembleHeatEquation                                          *
+ * -------------------------------------------------------------------------- *
+ * description: assembles the backward Euler system (I - dt kappa L) T = T^n  *
+ *              with one row per particle.                                    *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ *         vector1D   *b           // right-hand side, size par->np           *
+ * -------------------------------------------------------------------------- *
+ * output: csrMatrix *A            // symmetric positive definite matrix      *
+ ******************************************************************************/
+csrMatrix *assembleHeatEquation(fluid *particles, parameters *par,
+    vector1D *b);
+
+/******************************************************************************
+ * Function:    assemblePressureHeat                                          *
+ * -------------------------------------------------------------------------- *
+ * description: assembles the pressure Poisson equation of                    *
+ *              assemblePressurePoisson and the heat equation of              *
+ *              assembleHeatEquation in one pass over the neighbour lists,    *
+ *              each weight being evaluated once for both matrices.           *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid       *particles   // fluid particles                        *
+ *         parameters  *par         // simulation parameters                  *
+ *         surfaceList *surf        // free-surface and interior lists        *
+ *         vector1D    *bp          // pressure rhs, size surf->nInterior     *
+ *         vector1D    *bt          // heat rhs, size par->np                 *
+ *         csrMatrix  **Ap          // pressure Poisson matrix                *
+ *         csrMatrix  **At          // heat equation matrix                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void assemblePressureHeat(fluid *particles, parameters *par, surfaceList *surf,
+    vector1D *bp, vector1D *bt, csrMatrix **Ap, csrMatrix **At);
+
+/******************************************************************************
+ * Function:    temperatureRateRange                                          *
+ * -------------------------------------------------------------------------- *
+ * description: explicit increment dT = dt kappa L(T) of the particles        *
+ *              [begin, end) with the kappa of par, without updating T, so    *
+ *              that every range reads the temperatures of the step start.    *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // simulation parameters                 *
+ *         vector1D     *dT          // increments, size par->np              *
+ *         const integer begin       // first particle of the range           *
+ *         const integer end         // one past the last particle            *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void temperatureRateRange(fluid *particles, parameters *par, vector1D *dT,
+    const integer begin, const integer end);
+
+/******************************************************************************
+ * Function:    assembleHeatRange                                             *
+ * -------------------------------------------------------------------------- *
+ * description: fills the rows [begin, end) of the backward Euler system      *
+ *              divided by the kappa of par, (I / kappa - dt L) T = T^n /     *
+ *              kappa, which stays symmetric when kappa changes between the   *
+ *              ranges. A->rowPtr must hold the row starts of the layout of   *
+ *              assembleHeatEquation: the diagonal, then the neighbours.      *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // simulation parameters                 *
+ *         csrMatrix    *A           // matrix with its row starts            *
+ *         vector1D     *b           // right-hand side, size par->np         *
+ *         const integer begin       // first particle of the range           *
+ *         const integer end         // one past the last particle            *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void assembleHeatRange(fluid *particles, parameters *par, csrMatrix *A,
+    vector1D *b, const integer begin, const integer end);
+
+/******************************************************************************
+ * Function:    computeTemperature                                            *
+ * -------------------------------------------------------------------------- *
+ * description: advances fluid.temperature by one time step with the given    *
+ *              mode. The large-radius neighbour lists must be up to date.    *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // simulation parameters                 *
+ *         thermalMode   mode        // explicit or implicit update           *
+ *         solverConfig *cfg         // solver used in the implicit mode      *
+ * -------------------------------------------------------------------------- *
+ * output: integer                   // solver iterations, 0 if explicit      *
+ ******************************************************************************/
+integer computeTemperature(fluid *particles, parameters *par,
+    thermalMode mode, solverConfig *cfg);
+
+/******************************************************************************
+ * Function:    computePressureTemperature                                    *
+ * -------------------------------------------------------------------------- *
+ * description: implicit pressure and implicit temperature of one time step.  *
+ *              Both systems come from assemblePressureHeat; they are solved  *
+ *              in lockstep by pcgSolvePair when they share their sparsity    *
+ *              pattern and the solver is in double precision, otherwise one  *
+ *              after the other, the pressure last. The pressure boundary     *
+ *              condition is applied with applyPressureBoundary.              *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // simulation parameters                 *
+ *         surfaceList  *surf        // free-surface and interior lists       *
+ *         solverConfig *cfg         // solver configuration                  *
+ * -------------------------------------------------------------------------- *
+ * output: integer                   // pressure solver iterations            *
+ ******************************************************************************/
+integer computePressureTemperature(fluid *particles, parameters *par,
+    surfaceList *surf, solverConfig *cfg);
+
+#endif
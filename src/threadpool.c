@@ -0,0 +1,476 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                              THREADPOOL.C                                  *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L /*sysconf in strict C11*/
+
+#include "threadpool.h"
+#include "parallel.h"
+
+#include <stdio.h>     /*input and output variable manipulation*/
+#include <stdlib.h>    /*address and memory manipulation*/
+#include <stdatomic.h> /*task counters*/
+#include <pthread.h>   /*threads, locks and condition variables*/
+#include <sched.h>     /*sched_yield*/
+#include <unistd.h>    /*number of online processors*/
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+#define DEQUE_INIT  64  // initial capacity of a task deque
+#define SPLIT_RATIO 8   // automatic grain: ranges per worker
+#define IDLE_SPINS  64  // failed steal rounds before a worker sleeps
+
+typedef struct taskGroup
+{
+    atomic_ulong pending;       /* tasks spawned and not yet completed        */
+
+} taskGroup;
+
+typedef struct task
+{
+    taskFunction  func;         /* single task, NULL for a range              */
+    rangeFunction range;        /* loop body, NULL for a single task          */
+    void         *arg;          /* argument of func or range                  */
+    integer       begin, end;   /* range still to be run                      */
+    integer       grain;        /* largest range run without splitting        */
+    taskGroup    *group;        /* completion counter                         */
+
+} task;
+
+typedef struct taskDeque
+{
+    _Alignas(CACHE_LINE)
+    pthread_mutex_t lock;       /* owner and thieves take the lock            */
+    task           *items;      /* ring buffer of tasks                       */
+    integer         head;       /* top: stolen by the other workers           */
+    integer         tail;       /* bottom: pushed and popped by the owner     */
+    integer         capacity;   /* size of the ring buffer                    */
+
+} taskDeque;
+
+struct threadPool
+{
+    integer         nthreads;   /* workers, the driving thread included       */
+    pthread_t      *threads;    /* workers 1 to nthreads - 1                  */
+    taskDeque      *deques;     /* one deque per worker                       */
+    taskGroup       spawned;    /* tasks of spawnTask                         */
+    atomic_ulong    queued;     /* tasks sitting in the deques                */
+    atomic_ulong    sleepers;   /* workers waiting on wake                    */
+    atomic_int      stop;       /* set when the pool is freed                 */
+    pthread_mutex_t lock;       /* protects the sleep of the workers          */
+    pthread_cond_t  wake;       /* signalled when tasks are queued            */
+};
+
+typedef struct workerArg
+{
+    threadPool *pool;
+    integer     id;
+
+} workerArg;
+
+/* worker running on this thread; other threads act as the worker 0 */
+static _Thread_local threadPool *currentPool = NULL;
+static _Thread_local integer     currentId   = 0;
+static _Thread_local unsigned    stealSeed   = 0;
+
+/******************************************************************************
+ * AUXILIARY FUNCTIONS                                                        *
+ ******************************************************************************/
+
+static integer workerOf(threadPool *pool)
+{
+    return (currentPool == pool) ? currentId : 0;
+}
+
+static void initDeque(taskDeque *d)
+{
+    d->items    = (task *) malloc(DEQUE_INIT * sizeof(task));
+    d->head     = 0;
+    d->tail     = 0;
+    d->capacity = DEQUE_INIT;
+
+    if (d->items == NULL || pthread_mutex_init(&d->lock, NULL) != 0)
+    {
+        printf ("ERROR: no free space in RAM to allocate the task deques\n");
+        exit (EXIT_FAILURE);
+    }
+}
+
+static void pushDeque(taskDeque *d, const task *t)
+{
+    pthread_mutex_lock(&d->lock);
+
+    if (d->tail - d->head == d->capacity)
+    {
+        register integer k;
+
+        task *items = (task *) malloc(2 * d->capacity * sizeof(task));
+
+        if (items == NULL)
+        {
+            printf ("ERROR: no free space in RAM to grow a task deque\n");
+            exit (EXIT_FAILURE);
+        }
+
+        for (k = d->head; k < d->tail; k++)
+        {
+            items[k % (2 * d->capacity)] = d->items[k % d->capacity];
+        }
+
+        free(d->items);
+
+        d->items     = items;
+        d->capacity *= 2;
+    }
+
+    d->items[d->tail % d->capacity] = *t;
+    d->tail++;
+
+    pthread_mutex_unlock(&d->lock);
+}
+
+/* the owner takes its most recent task: the smallest, hot in cache */
+static int popDeque(taskDeque *d, task *t)
+{
+    int found = 0;
+
+    pthread_mutex_lock(&d->lock);
+
+    if (d->tail > d->head)
+    {
+        d->tail--;
+        *t    = d->items[d->tail % d->capacity];
+        found = 1;
+    }
+
+    pthread_mutex_unlock(&d->lock);
+
+    return found;
+}
+
+/* a thief takes the oldest task: the largest piece of a split range */
+static int stealDeque(taskDeque *d, task *t)
+{
+    int found = 0;
+
+    if (pthread_mutex_trylock(&d->lock) != 0)
+    {
+        return 0;
+    }
+
+    if (d->tail > d->head)
+    {
+        *t    = d->items[d->head % d->capacity];
+        d->head++;
+        found = 1;
+    }
+
+    pthread_mutex_unlock(&d->lock);
+
+    return found;
+}
+
+static void pushTask(threadPool *pool, const integer id, const task *t)
+{
+    /*counted first, so a thief never sees more tasks taken than queued*/
+    atomic_fetch_add(&pool->queued, 1);
+    pushDeque(pool->deques + id, t);
+
+    if (atomic_load(&pool->sleepers) > 0)
+    {
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_broadcast(&pool->wake);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+static int findTask(threadPool *pool, const integer id, task *t)
+{
+    register integer k;
+
+    int found = popDeque(pool->deques + id, t);
+
+    /*victims visited from a random worker, so thieves do not collide*/
+    if (!found && pool->nthreads > 1)
+    {
+        stealSeed = stealSeed * 1103515245u + 12345u + (unsigned) id;
+
+        const integer first = (stealSeed >> 8) % pool->nthreads;
+
+        for (k = 0; k < pool->nthreads && !found; k++)
+        {
+            const integer victim = (first + k) % pool->nthreads;
+
+            if (victim != id)
+            {
+                found = stealDeque(pool->deques + victim, t);
+            }
+        }
+    }
+
+    if (found)
+    {
+        atomic_fetch_sub(&pool->queued, 1);
+    }
+
+    return found;
+}
+
+static void runTask(threadPool *pool, const integer id, task t)
+{
+    if (t.range != NULL)
+    {
+        /*keep the lower half, offer the upper half to the thieves*/
+        while (t.end - t.begin > t.grain)
+        {
+            task upper = t;
+
+            upper.begin = t.begin + (t.end - t.begin) / 2;
+            t.end       = upper.begin;
+
+            atomic_fetch_add(&t.group->pending, 1);
+            pushTask(pool, id, &upper);
+        }
+
+        t.range(t.arg, t.begin, t.end);
+    }
+    else
+    {
+        t.func(t.arg);
+    }
+
+    atomic_fetch_sub_explicit(&t.group->pending, 1, memory_order_release);
+}
+
+/* runs and steals tasks until the group completes */
+static void helpUntil(threadPool *pool, const integer id, taskGroup *group)
+{
+    task t;
+
+    while (atomic_load_explicit(&group->pending, memory_order_acquire) > 0)
+    {
+        if (findTask(pool, id, &t))
+        {
+            runTask(pool, id, t);
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+}
+
+static void *workerLoop(void *arg)
+{
+    threadPool   *pool = ((workerArg *) arg)->pool;
+    const integer id   = ((workerArg *) arg)->id;
+    integer       idle = 0;
+    task          t;
+
+    free(arg);
+
+    currentPool = pool;
+    currentId   = id;
+    stealSeed   = (unsigned) id;
+
+    while (!atomic_load(&pool->stop))
+    {
+        if (findTask(pool, id, &t))
+        {
+            runTask(pool, id, t);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < IDLE_SPINS)
+        {
+            sched_yield();
+            continue;
+        }
+
+        /*sleepers is raised before queued is read, and the pushers raise  */
+        /*queued before reading sleepers: a wake-up cannot be missed       */
+        pthread_mutex_lock(&pool->lock);
+        atomic_fetch_add(&pool->sleepers, 1);
+
+        while (atomic_load(&pool->queued) == 0 && !atomic_load(&pool->stop))
+        {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+
+        atomic_fetch_sub(&pool->sleepers, 1);
+        pthread_mutex_unlock(&pool->lock);
+
+        idle = 0;
+    }
+
+    return NULL;
+}
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+threadPool *makeThreadPool(const integer nthreads)
+{
+    register integer k;
+
+    threadPool *self = (threadPool *) malloc(sizeof(threadPool));
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the object\n");
+        exit (EXIT_FAILURE);
+    }
+
+    const long online = sysconf(_SC_NPROCESSORS_ONLN);
+
+    self->nthreads = (nthreads > 0) ? nthreads :
+        (online > 0 ? (integer) online : 1);
+    self->threads  = (pthread_t *) malloc(self->nthreads * sizeof(pthread_t));
+    self->deques   = (taskDeque *) aligned_alloc(CACHE_LINE,
+        self->nthreads * sizeof(taskDeque));
+
+    if (self->threads == NULL || self->deques == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the thread pool\n");
+        exit (EXIT_FAILURE);
+    }
+
+    atomic_init(&self->spawned.pending, 0);
+    atomic_init(&self->queued, 0);
+    atomic_init(&self->sleepers, 0);
+    atomic_init(&self->stop, 0);
+    pthread_mutex_init(&self->lock, NULL);
+    pthread_cond_init(&self->wake, NULL);
+
+    for (k = 0; k < self->nthreads; k++)
+    {
+        initDeque(self->deques + k);
+    }
+
+    for (k = 1; k < self->nthreads; k++)
+    {
+        workerArg *arg = (workerArg *) malloc(sizeof(workerArg));
+
+        if (arg == NULL)
+        {
+            printf ("ERROR: no free space in RAM to start the thread pool\n");
+            exit (EXIT_FAILURE);
+        }
+
+        arg->pool = self;
+        arg->id   = k;
+
+        if (pthread_create(self->threads + k, NULL, workerLoop, arg) != 0)
+        {
+            printf ("ERROR: the thread pool could not start a thread\n");
+            exit (EXIT_FAILURE);
+        }
+    }
+
+    return self;
+}
+
+void freeThreadPool(threadPool *self)
+{
+    register integer k;
+
+    waitTasks(self);
+
+    pthread_mutex_lock(&self->lock);
+    atomic_store(&self->stop, 1);
+    pthread_cond_broadcast(&self->wake);
+    pthread_mutex_unlock(&self->lock);
+
+    for (k = 1; k < self->nthreads; k++)
+    {
+        pthread_join(self->threads[k], NULL);
+    }
+
+    for (k = 0; k < self->nthreads; k++)
+    {
+        pthread_mutex_destroy(&self->deques[k].lock);
+        free(self->deques[k].items);
+    }
+
+    pthread_cond_destroy(&self->wake);
+    pthread_mutex_destroy(&self->lock);
+
+    free(self->deques);
+    free(self->threads);
+    free(self);
+}
+
+/******************************************************************************
+ * TASKS                                                                      *
+ ******************************************************************************/
+
+integer threadPoolSize(threadPool *pool)
+{
+    return pool->nthreads;
+}
+
+integer threadPoolWorker(threadPool *pool)
+{
+    return workerOf(pool);
+}
+
+void spawnTask(threadPool *pool, taskFunction f, void *arg)
+{
+    const task t = {f, NULL, arg, 0, 0, 0, &pool->spawned};
+
+    atomic_fetch_add(&pool->spawned.pending, 1);
+    pushTask(pool, workerOf(pool), &t);
+}
+
+void waitTasks(threadPool *pool)
+{
+    helpUntil(pool, workerOf(pool), &pool->spawned);
+}
+
+void parallelFor(threadPool *pool, const integer begin, const integer end,
+    const integer grain, rangeFunction f, void *arg)
+{
+    if (end <= begin)
+    {
+        return;
+    }
+
+    if (pool->nthreads == 1)
+    {
+        f(arg, begin, end);
+        return;
+    }
+
+    const integer n    = end - begin;
+    const integer share = n / (SPLIT_RATIO * pool->nthreads);
+    const integer id   = workerOf(pool);
+
+    taskGroup group;
+    task      t = {NULL, f, arg, begin, end, 0, &group};
+
+    t.grain = (grain > 0) ? grain : (share > 0 ? share : 1);
+
+    atomic_init(&group.pending, 1);
+
+    runTask(pool, id, t);
+    helpUntil(pool, id, &group);
+}
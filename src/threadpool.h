@@ -0,0 +1,158 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                              THREADPOOL.H                                  *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Persistent thread pool with work stealing. The threads are created once    *
+ * and sleep between jobs, so a time step can issue many parallel loops       *
+ * without creating a thread team for each. Every thread owns a deque of      *
+ * tasks: it pushes and pops at the bottom, and an idle thread steals from    *
+ * the top of another deque, i.e. the largest pending piece of work.          *
+ *                                                                            *
+ * A parallel loop is split lazily in halves: the thread running a range      *
+ * keeps the lower half and pushes the upper half, down to the grain size.    *
+ * Ranges of dense fluid cells therefore end up spread over the threads       *
+ * while sparse splash regions cost little, without any static partition.     *
+ *                                                                            *
+ * The thread calling parallelFor or waitTasks is the worker 0 of the pool    *
+ * and runs tasks while it waits. A pool must be driven by one thread at a    *
+ * time, but the tasks themselves may spawn tasks and run parallel loops.     *
+ *                                                                            *
+ * The range form of a stage is called from a rangeFunction whose argument    *
+ * carries the operands, as in searchNeighboursPool, computePndPool and       *
+ * spmvCsrPool.                                                               *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __THREADPOOL_H__
+#define __THREADPOOL_H__
+
+#include "structures.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+typedef void (*taskFunction)(void *arg);
+typedef void (*rangeFunction)(void *arg, const integer begin,
+    const integer end);
+
+typedef struct threadPool threadPool;
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    makeThreadPool                                                *
+ * -------------------------------------------------------------------------- *
+ * description: creates a pool of nthreads workers, the calling thread being  *
+ *              the worker 0, so nthreads - 1 threads are started. With       *
+ *              nthreads = 0 the number of online processors is used.         *
+ * -------------------------------------------------------------------------- *
+ * input:  const integer nthreads   // number of workers, 0 for all cores     *
+ * -------------------------------------------------------------------------- *
+ * output: threadPool *self                                                   *
+ ******************************************************************************/
+threadPool *makeThreadPool(const integer nthreads);
+
+/******************************************************************************
+ * Function:    freeThreadPool                                                *
+ * -------------------------------------------------------------------------- *
+ * description: waits for the pending tasks, stops and joins the threads and  *
+ *              deallocates the pool.                                         *
+ * -------------------------------------------------------------------------- *
+ * input:  threadPool *self   // thread pool                                  *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void freeThreadPool(threadPool *self);
+
+/******************************************************************************
+ * TASKS                                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    threadPoolSize                                                *
+ * -------------------------------------------------------------------------- *
+ * description: returns the number of workers, the calling thread included.   *
+ * -------------------------------------------------------------------------- *
+ * input:  threadPool *pool   // thread pool                                  *
+ * -------------------------------------------------------------------------- *
+ * output: integer            // number of workers                            *
+ ******************************************************************************/
+integer threadPoolSize(threadPool *pool);
+
+/******************************************************************************
+ * Function:    threadPoolWorker                                              *
+ * -------------------------------------------------------------------------- *
+ * description: returns the worker running the calling task, in               *
+ *              [0, threadPoolSize), e.g. to index per-thread buffers.        *
+ * -------------------------------------------------------------------------- *
+ * input:  threadPool *pool   // thread pool                                  *
+ * -------------------------------------------------------------------------- *
+ * output: integer            // worker index, 0 outside of the pool          *
+ ******************************************************************************/
+integer threadPoolWorker(threadPool *pool);
+
+/******************************************************************************
+ * Function:    spawnTask                                                     *
+ * -------------------------------------------------------------------------- *
+ * description: queues f(arg) on the deque of the calling worker. The task    *
+ *              may run on any worker; waitTasks waits for it.                *
+ * -------------------------------------------------------------------------- *
+ * input:  threadPool  *pool   // thread pool                                 *
+ *         taskFunction f      // task                                        *
+ *         void        *arg    // argument of the task                        *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void spawnTask(threadPool *pool, taskFunction f, void *arg);
+
+/******************************************************************************
+ * Function:    waitTasks                                                     *
+ * -------------------------------------------------------------------------- *
+ * description: runs and steals tasks until every task spawned with spawnTask *
+ *              has completed.                                                *
+ * -------------------------------------------------------------------------- *
+ * input:  threadPool *pool   // thread pool                                  *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void waitTasks(threadPool *pool);
+
+/******************************************************************************
+ * Function:    parallelFor                                                   *
+ * -------------------------------------------------------------------------- *
+ * description: calls f(arg, b, e) on disjoint ranges covering [begin, end),  *
+ *              each of at most grain elements, and returns once all ranges   *
+ *              are done. The ranges are split lazily and balanced by work    *
+ *              stealing; with grain = 0 a grain is chosen from the size of   *
+ *              the pool.                                                     *
+ * -------------------------------------------------------------------------- *
+ * input:  threadPool   *pool    // thread pool                               *
+ *         const integer begin   // first index                               *
+ *         const integer end     // one past the last index                   *
+ *         const integer grain   // largest range, 0 for automatic            *
+ *         rangeFunction f       // loop body over a range                    *
+ *         void         *arg     // argument of the loop body                 *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void parallelFor(threadPool *pool, const integer begin, const integer end,
+    const integer grain, rangeFunction f, void *arg);
+
+#endif
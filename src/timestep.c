@@ -0,0 +1,219 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                               TIMESTEP.C                                   *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "timestep.h"
+#include "neighbours.h"
+
+#include <math.h>   /*mathematical functions*/
+
+/******************************************************************************
+ * GENERAL PURPOSE METHODS                                                    *
+ ******************************************************************************/
+
+void initTimeStepper(timeStepper *ts)
+{
+    ts->dtMin      = DTMIN;
+    ts->dtMax      = DTMAX;
+    ts->courant    = 0.2;
+    ts->diffusion  = 0.2;
+    ts->growth     = 1.2;
+    ts->targetIter = 100;
+}
+
+static inline real pressureGradientDim(fluid *particles, parameters *par,
+    const integer begin, const integer end, const integer reach,
+    const integer dim)
+{
+    register integer i; /*particle  counter loop*/
+    register integer k; /*neighbour counter loop*/
+
+    const real coef = -par->dt * dim / (par->rho * par->n0L);
+    real du2Max = 0.0;
+
+    for (i = begin; i < end; i++)
+    {
+        const integer *nb = particles->neighL.arr + particles->startL.arr[i];
+        const real    *d  = particles->dNeighL.x  + particles->startL.arr[i];
+        const integer  nL = particles->nNeighL.arr[i];
+
+        /*the minimum neighbour pressure keeps the gradient repulsive*/
+        real pMin = particles->pressure.x[i];
+
+        for (k = 0; k < nL; k++)
+        {
+            if (nb[k] < reach)
+            {
+                pMin = fmin(pMin, particles->pressure.x[nb[k]]);
+            }
+        }
+
+        real gx = 0.0, gy = 0.0, gz = 0.0;
+
+        for (k = 0; k < nL; k++)
+        {
+            if (d[k] <= 0.0 || nb[k] >= reach)
+            {
+                continue;
+            }
+
+            const integer j = nb[k];
+            const real    f = (particles->pressure.x[j] - pMin) *
+                weight(d[k], par->reL) / (d[k] * d[k]);
+
+            gx += f * (particles->r.x[j] - particles->r.x[i]);
+            gy += f * (particles->r.y[j] - particles->r.y[i]);
+
+            if (dim == 3)
+            {
+                gz += f * (particles->r.z[j] - particles->r.z[i]);
+            }
+        }
+
+        particles->du.x[i] = coef * gx;
+        particles->du.y[i] = coef * gy;
+
+        if (dim == 3)
+        {
+            particles->du.z[i] = coef * gz;
+        }
+
+        du2Max = fmax(du2Max, coef * coef * (gx*gx + gy*gy + gz*gz));
+    }
+
+    return sqrt(du2Max);
+}
+
+static inline real applyCorrectionDim(fluid *particles, parameters *par,
+    const integer begin, const integer end, const integer dim)
+{
+    register integer i; /*particle counter loop*/
+
+    real u2Max = 0.0;
+
+    for (i = begin; i < end; i++)
+    {
+        const real ux = particles->u.x[i] + particles->du.x[i];
+        const real uy = particles->u.y[i] + particles->du.y[i];
+        const real uz = (dim == 3) ?
+            particles->u.z[i] + particles->du.z[i] : 0.0;
+
+        particles->u.x[i]  = ux;
+        particles->u.y[i]  = uy;
+        particles->r.x[i] += par->dt * particles->du.x[i];
+        particles->r.y[i] += par->dt * particles->du.y[i];
+
+        if (dim == 3)
+        {
+            particles->u.z[i]  = uz;
+            particles->r.z[i] += par->dt * particles->du.z[i];
+        }
+
+        u2Max = fmax(u2Max, ux*ux + uy*uy + uz*uz);
+    }
+
+    return sqrt(u2Max);
+}
+
+static inline real correctVelocityDim(fluid *particles, parameters *par,
+    const integer begin, const integer end, const integer reach,
+    const integer dim)
+{
+    pressureGradientDim(particles, par, begin, end, reach, dim);
+
+    /*the positions are only moved once every gradient is computed*/
+    return applyCorrectionDim(particles, par, begin, end, dim);
+}
+
+real correctVelocity(fluid *particles, parameters *par)
+{
+    return DIM_DISPATCH(par->dim, correctVelocityDim, particles, par, 0,
+        par->np, REACH_ALL);
+}
+
+real correctVelocityReach(fluid *particles, parameters *par,
+    const integer begin, const integer end, const integer reach)
+{
+    return DIM_DISPATCH(par->dim, correctVelocityDim, particles, par, begin,
+        end, reach);
+}
+
+real pressureGradientRange(fluid *particles, parameters *par,
+    const integer begin, const integer end)
+{
+    return DIM_DISPATCH(par->dim, pressureGradientDim, particles, par, begin,
+        end, REACH_ALL);
+}
+
+real applyCorrectionRange(fluid *particles, parameters *par,
+    const integer begin, const integer end)
+{
+    return DIM_DISPATCH(par->dim, applyCorrectionDim, particles, par, begin,
+        end);
+}
+
+real nextTimeStep(timeStepper *ts, parameters *par, const real uMax,
+    solverConfig *cfg)
+{
+    const real prev = par->dt;
+    real speed = uMax;
+    real dt    = ts->dtMax;
+
+    /*Courant limit, with the acoustic speed in the explicit mode*/
+    if (par->pressure == PRESSURE_EXPLICIT)
+    {
+        speed += par->c0;
+    }
+
+    if (speed > 0.0)
+    {
+        dt = fmin(dt, ts->courant * par->l0 / speed);
+    }
+
+    /*viscous and thermal diffusion limit*/
+    const real nu = fmax(par->nu, par->kappa);
+
+    if (nu > 0.0)
+    {
+        dt = fmin(dt, ts->diffusion * par->l0 * par->l0 / nu);
+    }
+
+    /*convergence history of the pressure solve*/
+    if (cfg != NULL && cfg->iterations > 0)
+    {
+        if (cfg->residual > cfg->tol)
+        {
+            dt = fmin(dt, 0.5 * prev);
+        }
+        else if (cfg->iterations > ts->targetIter)
+        {
+            dt = fmin(dt, prev * ts->targetIter / cfg->iterations);
+        }
+    }
+
+    if (prev > 0.0)
+    {
+        dt = fmin(dt, ts->growth * prev);
+    }
+
+    dt = fmax(ts->dtMin, fmin(ts->dtMax, dt));
+
+    par->dt = dt;
+
+    return dt;
+}
@@ -0,0 +1,152 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                               TIMESTEP.H                                   *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Adaptive time step. The velocity correction by the pressure gradient       *
+ * returns the maximum velocity, reduced in the same pass over the particles, *
+ * and the controller chooses the next step from the Courant number, the      *
+ * viscous and thermal diffusion numbers and the convergence of the last      *
+ * pressure solve, clamped between configurable bounds.                       *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __TIMESTEP_H__
+#define __TIMESTEP_H__
+
+#include "structures.h"
+#include "solver.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+typedef struct timeStepper
+{
+    real    dtMin;       /* minimum time step                                 */
+    real    dtMax;       /* maximum time step                                 */
+    real    courant;     /* maximum Courant number u dt / l0                  */
+    real    diffusion;   /* maximum diffusion number nu dt / l0^2             */
+    real    growth;      /* maximum growth factor between two steps           */
+    integer targetIter;  /* solver iterations above which the step shrinks    */
+
+} timeStepper;
+
+/******************************************************************************
+ * GENERAL PURPOSE METHODS                                                    *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    initTimeStepper                                               *
+ * -------------------------------------------------------------------------- *
+ * description: fills the controller with the default values: bounds DTMIN    *
+ *              and DTMAX, Courant number 0.2, diffusion number 0.2, growth   *
+ *              factor 1.2 and 100 target solver iterations.                  *
+ * -------------------------------------------------------------------------- *
+ * input:  timeStepper *ts   // time step controller                          *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void initTimeStepper(timeStepper *ts);
+
+/******************************************************************************
+ * Function:    correctVelocity                                               *
+ * -------------------------------------------------------------------------- *
+ * description: corrects the velocity and the position with the MPS pressure  *
+ *              gradient, du = -dt/rho grad(p), u += du and r += dt du. The   *
+ *              maximum velocity norm is reduced in the same pass.            *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ * -------------------------------------------------------------------------- *
+ * output: real                    // maximum velocity norm                   *
+ ******************************************************************************/
+real correctVelocity(fluid *particles, parameters *par);
+
+/******************************************************************************
+ * Function:    correctVelocityReach                                          *
+ * -------------------------------------------------------------------------- *
+ * description: correctVelocity restricted to the particles [begin, end),     *
+ *              where the neighbours of index reach or more are left out of   *
+ *              the gradient and of its minimum pressure, e.g. the dummy      *
+ *              particles of the type-partitioned layout.                     *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // simulation parameters                 *
+ *         const integer begin       // first particle of the range           *
+ *         const integer end         // one past the last particle            *
+ *         const integer reach       // first neighbour index left out        *
+ * -------------------------------------------------------------------------- *
+ * output: real                      // maximum velocity norm of the range    *
+ ******************************************************************************/
+real correctVelocityReach(fluid *particles, parameters *par,
+    const integer begin, const integer end, const integer reach);
+
+/******************************************************************************
+ * Function:    pressureGradientRange                                         *
+ * -------------------------------------------------------------------------- *
+ * description: first half of correctVelocity on the particles [begin, end):  *
+ *              stores du = -dt/rho grad(p) with the rho of par, without      *
+ *              moving any particle. A materialKernel.                        *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // simulation parameters                 *
+ *         const integer begin       // first particle of the range           *
+ *         const integer end         // one past the last particle            *
+ * -------------------------------------------------------------------------- *
+ * output: real                      // maximum norm of du in the range       *
+ ******************************************************************************/
+real pressureGradientRange(fluid *particles, parameters *par,
+    const integer begin, const integer end);
+
+/******************************************************************************
+ * Function:    applyCorrectionRange                                          *
+ * -------------------------------------------------------------------------- *
+ * description: second half of correctVelocity on the particles [begin, end): *
+ *              u += du and r += dt du. It must only run once every gradient  *
+ *              is stored. A materialKernel.                                  *
+ * -------------------------------------------------------------------------- *
+ * input:  fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // simulation parameters                 *
+ *         const integer begin       // first particle of the range           *
+ *         const integer end         // one past the last particle            *
+ * -------------------------------------------------------------------------- *
+ * output: real                      // maximum velocity norm of the range    *
+ ******************************************************************************/
+real applyCorrectionRange(fluid *particles, parameters *par,
+    const integer begin, const integer end);
+
+/******************************************************************************
+ * Function:    nextTimeStep                                                  *
+ * -------------------------------------------------------------------------- *
+ * description: computes the next time step into par->dt. It is the minimum   *
+ *              of the Courant limit (with the speed of sound in the explicit *
+ *              pressure mode) and of the viscous and thermal diffusion       *
+ *              limits. It shrinks when the last solve needed more than       *
+ *              targetIter iterations or did not converge, grows at most by   *
+ *              the growth factor and is clamped to [dtMin, dtMax].           *
+ * -------------------------------------------------------------------------- *
+ * input:  timeStepper  *ts     // time step controller                       *
+ *         parameters   *par    // simulation parameters                      *
+ *         const real    uMax   // maximum velocity norm                      *
+ *         solverConfig *cfg    // last pressure solve, NULL if none          *
+ * -------------------------------------------------------------------------- *
+ * output: real                 // new time step                              *
+ ******************************************************************************/
+real nextTimeStep(timeStepper *ts, parameters *par, const real uMax,
+    solverConfig *cfg);
+
+#endif
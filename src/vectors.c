@@ -12,18 +12,73 @@
  * The full license is in the file LICENSE, distributed with this software.   *
  ******************************************************************************
  * Creation date    : 28.01.2021                                              *
- * Modification date: 07.02.2021                                              *
+ * Modification date: 19.10.2026                                              *
  ******************************************************************************
  * LIBRARIES:                                                                 *
  ******************************************************************************/
 
 #include "vectors.h"
+#include "parallel.h"
 
 #include <stdio.h>  /*input and output variable manipulation*/
 #include <stdlib.h> /*address and memory manipulation*/
 #include <string.h>
 #include <math.h>   /*mathematical functions*/
 
+/******************************************************************************
+ * AUXILIARY FUNCTIONS                                                        *
+ ******************************************************************************/
+
+/* zeroes n reals with the static schedule of the kernels (first touch) */
+static void zeroReal(real *x, const integer n)
+{
+    register integer i;
+
+    #pragma omp parallel for PARALLEL_CHUNKS(n, sizeof(real))
+    for (i = 0; i < n; i++)
+    {
+        x[i] = 0.0;
+    }
+}
+
+static void copyReal(real* __restrict dst, const real* __restrict src,
+    const integer n)
+{
+    register integer i;
+
+    if (n < getParallelThreshold())
+    {
+        memcpy(dst, src, n * sizeof(real));
+        return;
+    }
+
+    #pragma omp parallel for PARALLEL_CHUNKS(n, sizeof(real))
+    for (i = 0; i < n; i++)
+    {
+        dst[i] = src[i];
+    }
+}
+
+/* cache-line aligned storage, so the chunks of two threads share no line */
+static real *allocReal(const integer n)
+{
+    const integer bytes = ((n * sizeof(real) + CACHE_LINE - 1) / CACHE_LINE)
+        * CACHE_LINE;
+
+    real *self = (real *) aligned_alloc(CACHE_LINE, bytes > 0 ? bytes :
+        CACHE_LINE);
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the vector\n");
+        exit (EXIT_FAILURE);
+    }
+
+    zeroReal(self, n);
+
+    return self;
+}
+
 /******************************************************************************
  * CONSTRUCTORS AND DISTRUCTORS                                               *
  ******************************************************************************/
@@ -32,17 +87,18 @@ vector1D* makeVector1D(const integer size)
 {
     /*initialize object's memory block*/
     vector1D *self = (vector1D *) malloc(sizeof(vector1D));
-    /*vector's size*/
-    self->size = size;
-    /*vector initialization in the object's memory block*/
-    self->x    = (real *)malloc(size * sizeof(real));
 
     if (self == NULL) 
     {
-        printf ("ERROR: no free space in RAM to allocate x\n");
+        printf ("ERROR: no free space in RAM to allocate the object\n");
         exit (EXIT_FAILURE);
     }
 
+    /*vector's size*/
+    self->size = size;
+    /*vector initialization in the object's memory block*/
+    self->x    = allocReal(size);
+
     return self;
 }
 
@@ -56,17 +112,20 @@ vector2D* makeVector2D(const integer size)
 {
     /*initialize object's memory block*/
     vector2D *self = (vector2D *)malloc(sizeof(vector2D));
-    /*vector's size*/
-    self->size = size;
-    /*vector initialization in the object's memory block*/
-    self->x    = (real *)malloc(size * sizeof(real));
-    self->y    = (real *)malloc(size * sizeof(real));
 
     if (self == NULL) 
     {
-        printf ("ERROR: no free space in RAM to allocate x or y\n");
+        printf ("ERROR: no free space in RAM to allocate the object\n");
         exit (EXIT_FAILURE);
     }
+
+    /*vector's size*/
+    self->size = size;
+    /*vector initialization in the object's memory block*/
+    self->x    = allocReal(size);
+    self->y    = allocReal(size);
+
+    return self;
 }
 
 void freeVector2D(vector2D *self)
@@ -80,18 +139,21 @@ vector3D* makeVector3D(const integer size)
 {
     /*initialize object's memory block*/
     vector3D *self = (vector3D *)malloc(sizeof(vector3D));
-    /*vector's size*/
-    self->size = size;
-    /*vector initialization in the object's memory block*/
-    self->x    = (real *)malloc(size * sizeof(real));
-    self->y    = (real *)malloc(size * sizeof(real));
-    self->z    = (real *)malloc(size * sizeof(real));
 
     if (self == NULL) 
     {
-        printf ("ERROR: no free space in RAM to allocate x or y\n");
+        printf ("ERROR: no free space in RAM to allocate the object\n");
         exit (EXIT_FAILURE);
     }
+
+    /*vector's size*/
+    self->size = size;
+    /*vector initialization in the object's memory block*/
+    self->x    = allocReal(size);
+    self->y    = allocReal(size);
+    self->z    = allocReal(size);
+
+    return self;
 }
 
 void freeVector3D(vector3D *self)
@@ -108,20 +170,20 @@ void freeVector3D(vector3D *self)
 
 void copyVector1D(vector1D* __restrict src, vector1D* __restrict dst)
 { 
-   memcpy(dst->x, src->x, src->size * sizeof(real));
+    copyReal(dst->x, src->x, src->size);
 }
 
 void copyVector2D(vector2D* __restrict src, vector2D* __restrict dst)
 {
-    memcpy(dst->x, src->x, src->size * sizeof(real));
-    memcpy(dst->y, src->y, src->size * sizeof(real));    
+    copyReal(dst->x, src->x, src->size);
+    copyReal(dst->y, src->y, src->size);
 }
 
 void copyVector3D(vector3D* __restrict src, vector3D* __restrict dst)
 {
-    memcpy(dst->x, src->x, src->size * sizeof(real));
-    memcpy(dst->y, src->y, src->size * sizeof(real));
-    memcpy(dst->z, src->z, src->size * sizeof(real));   
+    copyReal(dst->x, src->x, src->size);
+    copyReal(dst->y, src->y, src->size);
+    copyReal(dst->z, src->z, src->size);
 }
 
 void transverseVector1D(vector1D *self)
@@ -287,36 +349,22 @@ void transverseVector3D(vector3D *self, const unsigned int components)
 
 void zeroVector1D(vector1D *self)
 {
-    register integer i;
-
-    for(i = 0; i < self->size; i++)
-    {
-        self->x[i] = 0;
-    }
+    zeroReal(self->x, self->size);
 }
 
 void zeroVector2D(vector2D *self)
 {
-    register integer i;
-
-    for(i = 0; i < self->size; i++)
-    {
-        self->x[i] = 0;
-        self->y[i] = 0;
-    }
+    zeroReal(self->x, self->size);
+    zeroReal(self->y, self->size);
 }
 
 void zeroVector3D(vector3D *self)
 {
-    register integer i;
-
-    for(i = 0; i < self->size; i++)
-    {
-        self->x[i] = 0;
-        self->y[i] = 0;
-        self->z[i] = 0;
-    }
+    zeroReal(self->x, self->size);
+    zeroReal(self->y, self->size);
+    zeroReal(self->z, self->size);
 }
+
 /******************************************************************************
  * ARITMETHIC                                                                 *
  ******************************************************************************/
@@ -325,6 +373,7 @@ void addVector1D(vector1D *v, vector1D *w, vector1D *s, const integer size)
 {
     register integer i;
 
+    #pragma omp parallel for PARALLEL_CHUNKS(size, sizeof(real))
     for (i = 0; i < size; i++)
     {
         s -> x[i] = v -> x[i] + w -> x[i];
@@ -335,6 +384,7 @@ void addVector2D(vector2D *v, vector2D *w, vector2D *s, const integer size)
 {
     register integer i;
 
+    #pragma omp parallel for PARALLEL_CHUNKS(size, sizeof(real))
     for(i = 0; i < size; i++)
     {
         s -> x[i] = v -> x[i] + w -> x[i];
@@ -346,6 +396,7 @@ void addVector3D(vector3D *v, vector3D *w, vector3D *s, const integer size)
 {
     register integer i;
 
+    #pragma omp parallel for PARALLEL_CHUNKS(size, sizeof(real))
     for(i = 0; i < size; i++)
     {
         s -> x[i] = v -> x[i] + w -> x[i];
@@ -358,6 +409,7 @@ void subVector1D(vector1D *v, vector1D *w, vector1D *s, const integer size)
 {
     register integer i;
 
+    #pragma omp parallel for PARALLEL_CHUNKS(size, sizeof(real))
     for(i = 0; i < size; i++)
     {
         s -> x[i] = v -> x[i] - w -> x[i];
@@ -368,6 +420,7 @@ void subVector2D(vector2D *v, vector2D *w, vector2D *s, const integer size)
 {
     register integer i;
 
+    #pragma omp parallel for PARALLEL_CHUNKS(size, sizeof(real))
     for(i = 0; i < size; i++)
     {
         s -> x[i] = v -> x[i] - w -> x[i];
@@ -379,6 +432,7 @@ void subVector3D(vector3D *v, vector3D *w, vector3D *s, const integer size)
 {
     register integer i;
 
+    #pragma omp parallel for PARALLEL_CHUNKS(size, sizeof(real))
     for(i = 0; i < size; i++)
     {
         s -> x[i] = v -> x[i] - w -> x[i];
@@ -391,6 +445,7 @@ void mulVector1D(vector1D *v, vector1D *w, vector1D *s, const integer size)
 {
     register integer i;
 
+    #pragma omp parallel for PARALLEL_CHUNKS(size, sizeof(real))
     for(i = 0; i < size; i++)
     {
         s -> x[i] = v -> x[i] * w -> x[i];
@@ -402,6 +457,7 @@ void mulVector2D(vector2D *v, vector2D *w, vector2D *s, const integer size)
 {
     register integer i;
 
+    #pragma omp parallel for PARALLEL_CHUNKS(size, sizeof(real))
     for(i = 0; i < size; i++)
     {
         s -> x[i] = v -> x[i] * w -> x[i];
@@ -413,6 +469,7 @@ void mulVector3D(vector3D *v, vector3D *w, vector3D *s, const integer size)
 {
     register integer i;
 
+    #pragma omp parallel for PARALLEL_CHUNKS(size, sizeof(real))
     for(i = 0; i < size; i++)
     {
         s -> x[i] = v -> x[i] * w -> x[i];
@@ -425,6 +482,7 @@ void divVector1D(vector1D *v, vector1D *w, vector1D *s, const integer size)
 {
     register integer i;
 
+    #pragma omp parallel for PARALLEL_CHUNKS(size, sizeof(real))
     for(i = 0; i < size; i++)
     {
         s -> x[i] = v -> x[i] / w -> x[i];
@@ -435,6 +493,7 @@ void divVector2D(vector2D *v, vector2D *w, vector2D *s, const integer size)
 {
     register integer i;
 
+    #pragma omp parallel for PARALLEL_CHUNKS(size, sizeof(real))
     for (i = 0; i < size; i++)
     {
         s -> x[i] = v -> x[i] / w -> x[i];
@@ -446,6 +505,7 @@ void divVector3D(vector3D *v, vector3D *w, vector3D *s, const integer size)
 {
     register integer i;
 
+    #pragma omp parallel for PARALLEL_CHUNKS(size, sizeof(real))
     for(i = 0; i < size; i++)
     {
         s -> x[i] = v -> x[i] / w -> x[i];
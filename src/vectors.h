@@ -12,7 +12,7 @@
  * The full license is in the file LICENSE, distributed with this software.   *
  ******************************************************************************
  * Creation date    : 28.01.2021                                              *
- * Modification date: 07.02.2021                                              *
+ * Modification date: 19.10.2026                                              *
  ******************************************************************************
  * Description:                                                               *
  *                                                                            *
@@ -20,6 +20,9 @@
  * and vector3D.Furthermore, functions for creation, destruction, operations  *
  * and manipulation are defined.                                              *
  *                                                                            *
+ * The copy, zero and arithmetic loops are threaded as described in           *
+ * parallel.h.                                                                *
+ *                                                                            *
  ******************************************************************************/
 
 #ifndef  __VECTORS_H__
@@ -37,6 +40,7 @@
 
 typedef double          real;     /* variables that are in the Real    field */  
 typedef unsigned long   integer;  /* variables that are in the Integer field */
+typedef float           real32;   /* single precision Real, solver storage   */
 
 /* Defining vector objects: */
 
@@ -70,7 +74,9 @@ typedef struct  vector3D
  * -------------------------------------------------------------------------- *
  * description: creates a vector v, attributes the total number of elements,  *
  *              dynamically allocates memory for each of the vector's         * 
- *              components.                                                   *
+ *              components. The components are aligned to cache lines and     *
+ *              zeroed with the static schedule of the threaded kernels, so   *
+ *              their pages are first touched by the threads using them.      *
  * -------------------------------------------------------------------------- *
  * input:  const unsigned long size   // total number of elements             *
  * -------------------------------------------------------------------------- *
@@ -191,7 +197,7 @@ void subVector3D(vector3D *v, vector3D *w, vector3D *s, const integer size);
  * Function:    mulVectorXD                                                   *
  * -------------------------------------------------------------------------- *
  * description: uses lazy computing to multiply vectors w and v into one      *
- *              vector s.                                                 *
+ *              vector s.                                                     *
  * -------------------------------------------------------------------------- *
  * input:  vectorXD *v      // second vector v                                *
  *         vectorXD *w      // first  vector w                                *
@@ -0,0 +1,627 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                                 WALL.C                                     *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "wall.h"
+#include "neighbours.h"
+#include "pressure.h"
+
+#include <math.h>   /*mathematical functions*/
+#include <stdio.h>  /*input and output variable manipulation*/
+#include <stdlib.h> /*address and memory manipulation*/
+
+/******************************************************************************
+ * AUXILIARY FUNCTIONS                                                        *
+ ******************************************************************************/
+
+static void *wallAlloc(const integer n)
+{
+    void *p = malloc(n > 0 ? n : 1);
+
+    if (p == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the walls\n");
+        exit (EXIT_FAILURE);
+    }
+
+    return p;
+}
+
+static inline real dot3(const real *a, const real *b)
+{
+    return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+}
+
+/* closest point c of the segment ab to p, and the left normal of ab */
+static void closestSegment(const real *p, const real *a, const real *b,
+    real *c, real *nf)
+{
+    const real ab[3] = {b[0] - a[0], b[1] - a[1], 0.0};
+    const real ap[3] = {p[0] - a[0], p[1] - a[1], 0.0};
+    const real len2  = dot3(ab, ab);
+
+    real t = (len2 > 0.0) ? dot3(ap, ab) / len2 : 0.0;
+
+    t = (t < 0.0) ? 0.0 : ((t > 1.0) ? 1.0 : t);
+
+    c[0] = a[0] + t * ab[0];
+    c[1] = a[1] + t * ab[1];
+    c[2] = 0.0;
+
+    const real len = sqrt(len2);
+
+    nf[0] = (len > 0.0) ? -ab[1] / len : 0.0;
+    nf[1] = (len > 0.0) ?  ab[0] / len : 0.0;
+    nf[2] = 0.0;
+}
+
+/* closest point c of the triangle abc to p (Ericson, Real-Time Collision    */
+/* Detection, 5.1.5), and the unit normal (b - a) x (c - a)                  */
+static void closestTriangle(const real *p, const real *a, const real *b,
+    const real *t, real *c, real *nf)
+{
+    register integer m;
+
+    real ab[3], ac[3], ap[3], bp[3], cp[3];
+
+    for (m = 0; m < 3; m++)
+    {
+        ab[m] = b[m] - a[m];
+        ac[m] = t[m] - a[m];
+        ap[m] = p[m] - a[m];
+        bp[m] = p[m] - b[m];
+        cp[m] = p[m] - t[m];
+    }
+
+    nf[0] = ab[1]*ac[2] - ab[2]*ac[1];
+    nf[1] = ab[2]*ac[0] - ab[0]*ac[2];
+    nf[2] = ab[0]*ac[1] - ab[1]*ac[0];
+
+    const real len = sqrt(dot3(nf, nf));
+
+    for (m = 0; m < 3; m++)
+    {
+        nf[m] = (len > 0.0) ? nf[m] / len : 0.0;
+    }
+
+    const real d1 = dot3(ab, ap), d2 = dot3(ac, ap);
+    const real d3 = dot3(ab, bp), d4 = dot3(ac, bp);
+    const real d5 = dot3(ab, cp), d6 = dot3(ac, cp);
+    const real vc = d1*d4 - d3*d2;
+    const real vb = d5*d2 - d1*d6;
+    const real va = d3*d6 - d5*d4;
+
+    real v = 0.0, w = 0.0;
+
+    if (d1 <= 0.0 && d2 <= 0.0)
+    {
+        v = 0.0; w = 0.0;                          /*vertex a*/
+    }
+    else if (d3 >= 0.0 && d4 <= d3)
+    {
+        v = 1.0; w = 0.0;                          /*vertex b*/
+    }
+    else if (d6 >= 0.0 && d5 <= d6)
+    {
+        v = 0.0; w = 1.0;                          /*vertex c*/
+    }
+    else if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+    {
+        v = d1 / (d1 - d3); w = 0.0;               /*edge ab*/
+    }
+    else if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+    {
+        v = 0.0; w = d2 / (d2 - d6);               /*edge ac*/
+    }
+    else if (va <= 0.0 && d4 >= d3 && d5 >= d6)
+    {
+        w = (d4 - d3) / ((d4 - d3) + (d5 - d6));   /*edge bc*/
+        v = 1.0 - w;
+    }
+    else
+    {
+        const real den = 1.0 / (va + vb + vc);     /*face*/
+
+        v = vb * den;
+        w = vc * den;
+    }
+
+    for (m = 0; m < 3; m++)
+    {
+        c[m] = a[m] + v * ab[m] + w * ac[m];
+    }
+}
+
+/* signed distance of p to the nearest element and the wall normal at p */
+static real nearestWall(wallModel *wall, const real *p, real *normal)
+{
+    register integer e, m;
+
+    real best = INFINITY;
+    real sign = 1.0;
+    real c[3], nf[3], bestC[3] = {0.0, 0.0, 0.0}, bestN[3] = {0.0, 0.0, 0.0};
+
+    for (e = 0; e < wall->nelem; e++)
+    {
+        const integer *v = wall->element + e * wall->dim;
+
+        if (wall->dim == 3)
+        {
+            closestTriangle(p, wall->vertex + 3*v[0], wall->vertex + 3*v[1],
+                wall->vertex + 3*v[2], c, nf);
+        }
+        else
+        {
+            closestSegment(p, wall->vertex + 3*v[0], wall->vertex + 3*v[1],
+                c, nf);
+        }
+
+        const real pc[3] = {p[0] - c[0], p[1] - c[1], p[2] - c[2]};
+        const real d2    = dot3(pc, pc);
+
+        if (d2 < best)
+        {
+            best = d2;
+            sign = (dot3(pc, nf) < 0.0) ? -1.0 : 1.0;
+
+            for (m = 0; m < 3; m++)
+            {
+                bestC[m] = c[m];
+                bestN[m] = nf[m];
+            }
+        }
+    }
+
+    const real d = sqrt(best);
+
+    /*the distance gradient, or the face normal on the wall itself*/
+    for (m = 0; m < 3; m++)
+    {
+        normal[m] = (d > 1e-12) ? sign * (p[m] - bestC[m]) / d : bestN[m];
+    }
+
+    return sign * d;
+}
+
+static void buildTable(wallTable *table, parameters *par, const real re,
+    const integer nbins)
+{
+    register integer b;
+
+    const int  m  = (int) ceil(re / par->l0) + 1;
+    const int  mz = (par->dim == 3) ? m : 0;
+    const real l0 = par->l0;
+
+    table->re       = re;
+    table->nbins    = nbins;
+    table->weight   = (real *) wallAlloc((nbins + 1) * sizeof(real));
+    table->gradient = (real *) wallAlloc((nbins + 1) * sizeof(real));
+
+    for (b = 0; b <= nbins; b++)
+    {
+        const real d = re * b / nbins;
+
+        real sumW = 0.0;
+        real sumG = 0.0;
+        int  ix, iz, k;
+
+        /*half lattice: layers k l0 behind the wall, the first on it*/
+        for (k = 0;   k <= m;  k++)
+        for (iz = -mz; iz <= mz; iz++)
+        for (ix = -m;  ix <= m;  ix++)
+        {
+            const real n = d + k * l0;
+            const real r = sqrt(n*n + l0*l0 * (real) (ix*ix + iz*iz));
+            const real w = weight(r, re);
+
+            if (w > 0.0)
+            {
+                sumW += w;
+                sumG += w * n / (r * r);
+            }
+        }
+
+        table->weight[b]   = sumW;
+        table->gradient[b] = sumG;
+    }
+}
+
+static void freeTable(wallTable *table)
+{
+    free(table->weight);
+    free(table->gradient);
+
+    table->weight   = NULL;
+    table->gradient = NULL;
+}
+
+/* interpolates f at the wall distance d, zero beyond the radius; closer than */
+/* one bin, where w diverges, the first bin is extrapolated from              */
+static inline real lookupTable(const wallTable *table, const real *f,
+    const real d)
+{
+    if (d >= table->re)
+    {
+        return 0.0;
+    }
+
+    const real h = table->re / table->nbins;
+    const real x = ((d > h) ? d : h) / h;
+
+    integer b = (integer) x;
+
+    b = (b >= table->nbins) ? table->nbins - 1 : b;
+
+    const real t = x - b;
+
+    return (1.0 - t) * f[b] + t * f[b + 1];
+}
+
+/* hydrostatic jump from the particle to its mirror behind the wall */
+static inline real mirrorJump(parameters *par, const real d, const real *n)
+{
+    return -2.0 * d * par->rho * (par->g[0]*n[0] + par->g[1]*n[1] +
+        ((par->dim == 3) ? par->g[2]*n[2] : 0.0));
+}
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+wallModel *makeWallModel(const integer dim, const real *vertex,
+    const integer nvert, const integer *element, const integer nelem)
+{
+    register integer k;
+
+    if (dim != 2 && dim != 3)
+    {
+        printf ("ERROR: the walls are segments in 2D or triangles in 3D\n");
+        exit (EXIT_FAILURE);
+    }
+
+    for (k = 0; k < dim * nelem; k++)
+    {
+        if (element[k] >= nvert)
+        {
+            printf ("ERROR: wall element %lu has no vertex %lu\n",
+                k / dim, element[k]);
+            exit (EXIT_FAILURE);
+        }
+    }
+
+    wallModel *self = (wallModel *) wallAlloc(sizeof(wallModel));
+
+    self->dim     = dim;
+    self->nvert   = nvert;
+    self->nelem   = nelem;
+    self->vertex  = (real *) wallAlloc(3 * nvert * sizeof(real));
+    self->element = (integer *) wallAlloc(dim * nelem * sizeof(integer));
+
+    memcpy(self->vertex, vertex, 3 * nvert * sizeof(real));
+    memcpy(self->element, element, dim * nelem * sizeof(integer));
+
+    self->nx     = 0;
+    self->ny     = 0;
+    self->nz     = 0;
+    self->min[0] = self->min[1] = self->min[2] = 0.0;
+    self->h      = 0.0;
+    self->dist   = NULL;
+    self->normal = NULL;
+
+    self->small.weight   = NULL;
+    self->small.gradient = NULL;
+    self->large.weight   = NULL;
+    self->large.gradient = NULL;
+
+    self->pd       = NULL;
+    self->pn       = NULL;
+    self->capacity = 0;
+
+    return self;
+}
+
+void freeWallModel(wallModel *self)
+{
+    freeTable(&self->small);
+    freeTable(&self->large);
+
+    free(self->vertex);
+    free(self->element);
+    free(self->dist);
+    free(self->normal);
+    free(self->pd);
+    free(self->pn);
+    free(self);
+}
+
+/******************************************************************************
+ * PRECOMPUTATION                                                             *
+ ******************************************************************************/
+
+void buildWallGrid(wallModel *wall, const real min[3], const real max[3],
+    const real h)
+{
+    register long node;
+
+    if (h <= 0.0)
+    {
+        printf ("ERROR: the wall grid spacing must be positive\n");
+        exit (EXIT_FAILURE);
+    }
+
+    wall->h  = h;
+    wall->nx = (integer) ceil((max[0] - min[0]) / h) + 1;
+    wall->ny = (integer) ceil((max[1] - min[1]) / h) + 1;
+    wall->nz = (wall->dim == 3) ? (integer) ceil((max[2] - min[2]) / h) + 1
+                                : 1;
+
+    wall->nx = (wall->nx < 2) ? 2 : wall->nx;
+    wall->ny = (wall->ny < 2) ? 2 : wall->ny;
+    wall->nz = (wall->dim == 3 && wall->nz < 2) ? 2 : wall->nz;
+
+    wall->min[0] = min[0];
+    wall->min[1] = min[1];
+    wall->min[2] = (wall->dim == 3) ? min[2] : 0.0;
+
+    const long nodes = (long) (wall->nx * wall->ny * wall->nz);
+
+    free(wall->dist);
+    free(wall->normal);
+
+    wall->dist   = (real *) wallAlloc(nodes * sizeof(real));
+    wall->normal = (real *) wallAlloc(3 * nodes * sizeof(real));
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (node = 0; node < nodes; node++)
+    {
+        const integer ix = (integer) node % wall->nx;
+        const integer iy = ((integer) node / wall->nx) % wall->ny;
+        const integer iz = (integer) node / (wall->nx * wall->ny);
+        const real    p[3] = {wall->min[0] + ix * h, wall->min[1] + iy * h,
+                              wall->min[2] + iz * h};
+
+        wall->dist[node] = nearestWall(wall, p, wall->normal + 3*node);
+    }
+}
+
+void buildWallTables(wallModel *wall, parameters *par, const integer nbins)
+{
+    if (nbins == 0)
+    {
+        printf ("ERROR: the wall tables need at least one interval\n");
+        exit (EXIT_FAILURE);
+    }
+
+    freeTable(&wall->small);
+    freeTable(&wall->large);
+
+    buildTable(&wall->small, par, par->reS, nbins);
+    buildTable(&wall->large, par, par->reL, nbins);
+}
+
+/******************************************************************************
+ * WALL CONTRIBUTIONS                                                         *
+ ******************************************************************************/
+
+void locateWalls(wallModel *wall, fluid *particles, parameters *par)
+{
+    register long i;
+
+    if (wall->dist == NULL)
+    {
+        printf ("ERROR: the wall grid is not built\n");
+        exit (EXIT_FAILURE);
+    }
+
+    if (par->np > wall->capacity)
+    {
+        const integer cap = (integer) (GROWTH * par->np);
+
+        free(wall->pd);
+        free(wall->pn);
+
+        wall->pd       = (real *) wallAlloc(cap * sizeof(real));
+        wall->pn       = (real *) wallAlloc(3 * cap * sizeof(real));
+        wall->capacity = cap;
+    }
+
+    const long    np = (long) par->np;
+    const integer nx = wall->nx, ny = wall->ny, nz = wall->nz;
+    const integer sy = nx, sz = nx * ny;
+
+    #pragma omp parallel for schedule(static)
+    for (i = 0; i < np; i++)
+    {
+        register integer m;
+
+        const real p[3] = {particles->r.x[i], particles->r.y[i],
+                           (wall->dim == 3) ? particles->r.z[i] : 0.0};
+        const integer n[3] = {nx, ny, nz};
+
+        integer c[3];
+        real    t[3];
+
+        /*cell of the particle, clamped to the grid*/
+        for (m = 0; m < 3; m++)
+        {
+            real x = (p[m] - wall->min[m]) / wall->h;
+
+            if (n[m] == 1)
+            {
+                c[m] = 0;
+                t[m] = 0.0;
+                continue;
+            }
+
+            x    = (x < 0.0) ? 0.0 : ((x > n[m] - 1) ? n[m] - 1 : x);
+            c[m] = (integer) x;
+            c[m] = (c[m] > n[m] - 2) ? n[m] - 2 : c[m];
+            t[m] = x - c[m];
+        }
+
+        const integer base = c[0] + sy * c[1] + sz * c[2];
+        const integer cz   = (nz > 1) ? 2 : 1;
+
+        real d = 0.0, g[3] = {0.0, 0.0, 0.0};
+        integer a, b, e;
+
+        /*bilinear in 2D, trilinear in 3D*/
+        for (e = 0; e < cz; e++)
+        for (b = 0; b < 2;  b++)
+        for (a = 0; a < 2;  a++)
+        {
+            const integer node = base + a + sy * b + sz * e;
+            const real    f    = (a ? t[0] : 1.0 - t[0]) *
+                (b ? t[1] : 1.0 - t[1]) * (e ? t[2] : 1.0 - t[2]);
+
+            d    += f * wall->dist[node];
+            g[0] += f * wall->normal[3*node];
+            g[1] += f * wall->normal[3*node + 1];
+            g[2] += f * wall->normal[3*node + 2];
+        }
+
+        const real len = sqrt(dot3(g, g));
+
+        wall->pd[i] = d;
+
+        for (m = 0; m < 3; m++)
+        {
+            wall->pn[3*i + m] = (len > 0.0) ? g[m] / len : 0.0;
+        }
+    }
+}
+
+void addWallDensity(wallModel *wall, fluid *particles, parameters *par)
+{
+    register long i;
+
+    const long np = (long) par->np;
+
+    #pragma omp parallel for schedule(static)
+    for (i = 0; i < np; i++)
+    {
+        const real d = wall->pd[i];
+
+        if (d < wall->large.re)
+        {
+            particles->pndS.x[i] += lookupTable(&wall->small,
+                wall->small.weight, d);
+            particles->pndL.x[i] += lookupTable(&wall->large,
+                wall->large.weight, d);
+        }
+    }
+}
+
+void addWallSource(wallModel *wall, fluid *particles, parameters *par,
+    surfaceList *surf, vector1D *b)
+{
+    register long r;
+
+    const real coef = 2.0 * par->dim / (par->lambda * par->n0L);
+    const long n    = (long) surf->nInterior;
+
+    (void) particles;
+
+    /*the mirror terms coef w (p_w - p_i) are known: they move to the rhs*/
+    #pragma omp parallel for schedule(static)
+    for (r = 0; r < n; r++)
+    {
+        const integer i = surf->interior[r];
+        const real    d = wall->pd[i];
+
+        if (d < wall->large.re)
+        {
+            b->x[r] += coef * lookupTable(&wall->large, wall->large.weight, d)
+                * mirrorJump(par, (d > 0.0) ? d : 0.0, wall->pn + 3*i);
+        }
+    }
+}
+
+integer computeWallPressure(wallModel *wall, fluid *particles,
+    parameters *par, surfaceList *surf, solverConfig *cfg)
+{
+    if (par->pressure == PRESSURE_EXPLICIT)
+    {
+        explicitPressure(particles, par);
+        return 0;
+    }
+
+    vector1D  *b   = makeVector1D(surf->nInterior);
+    csrMatrix *csr = assemblePressurePoisson(particles, par, surf, b);
+
+    addWallSource(wall, particles, par, surf, b);
+
+    sparseMatrix *A = makeSparseMatrix(csr, cfg->format);
+
+    const integer it = solvePressure(particles, surf->interior, A, b, cfg);
+
+    applyPressureBoundary(particles, surf);
+
+    freeSparseMatrix(A);
+    freeVector1D(b);
+
+    return it;
+}
+
+void correctWallVelocity(wallModel *wall, fluid *particles, parameters *par)
+{
+    register long i;
+
+    const long np   = (long) par->np;
+    const real coef = par->dt * par->dim / (par->rho * par->n0L);
+
+    #pragma omp parallel for schedule(static)
+    for (i = 0; i < np; i++)
+    {
+        register integer k;
+
+        const real d = wall->pd[i];
+
+        if (d >= wall->large.re)
+        {
+            continue;
+        }
+
+        const integer *nb = particles->neighL.arr + particles->startL.arr[i];
+        const real    *n  = wall->pn + 3*i;
+
+        real pMin = particles->pressure.x[i];
+
+        for (k = 0; k < particles->nNeighL.arr[i]; k++)
+        {
+            pMin = fmin(pMin, particles->pressure.x[nb[k]]);
+        }
+
+        const real pw = particles->pressure.x[i] +
+            mirrorJump(par, (d > 0.0) ? d : 0.0, n);
+        const real f  = (pw > pMin) ? coef * (pw - pMin) *
+            lookupTable(&wall->large, wall->large.gradient, d) : 0.0;
+
+        /*the mirrors lie along -n: their gradient term pushes along +n*/
+        particles->u.x[i] += f * n[0];
+        particles->u.y[i] += f * n[1];
+        particles->r.x[i] += par->dt * f * n[0];
+        particles->r.y[i] += par->dt * f * n[1];
+
+        if (par->dim == 3)
+        {
+            particles->u.z[i] += f * n[2];
+            particles->r.z[i] += par->dt * f * n[2];
+        }
+    }
+}
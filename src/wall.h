@@ -0,0 +1,232 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                                 WALL.H                                     *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * Polygon wall boundaries, in place of layers of wall and dummy particles.   *
+ * The walls are segments in 2D and triangles in 3D, oriented so that their   *
+ * normal, the left normal of a segment and the right-hand normal of a        *
+ * triangle, points into the fluid.                                           *
+ *                                                                            *
+ * The signed distance to the walls, positive in the fluid, and its gradient  *
+ * are sampled once on a regular grid and interpolated at the particles.      *
+ * The effect of the missing wall particles is then read from tables of the   *
+ * wall distance d, built by summing the weights of a half lattice of         *
+ * spacing l0 whose first layer lies on the wall:                             *
+ *     Z(d) = sum of w(r) over the lattice              (number density)      *
+ *     G(d) = sum of w(r) (d + k l0) / r^2 over it      (normal gradient)     *
+ * Z is added to pndS and pndL; the wall pressure is the mirror of the        *
+ * particle's with the hydrostatic jump dp = -2 d rho g.n, which puts the     *
+ * term coef Z(d) dp on the right-hand side of the pressure Poisson equation  *
+ * and the repulsive term (p + dp - pmin) G(d) n in the pressure gradient.    *
+ *                                                                            *
+ * Each particle only sees its nearest wall, so the particles in a concave    *
+ * corner miss part of the second wall; the tables assume a flat wall.        *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __WALL_H__
+#define __WALL_H__
+
+#include "structures.h"
+#include "surface.h"
+#include "solver.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+typedef struct wallTable
+{
+    real     re;          /* effective radius of the table                    */
+    integer  nbins;       /* intervals over [0, re]                           */
+    real    *weight;      /* Z at the nbins + 1 distances                     */
+    real    *gradient;    /* G at the nbins + 1 distances                     */
+
+} wallTable;
+
+typedef struct wallModel
+{
+    integer    dim;         /* number of dimensions: 2 or 3                   */
+    integer    nvert;       /* number of vertices                             */
+    integer    nelem;       /* number of segments or triangles                */
+    real      *vertex;      /* 3 coordinates per vertex                       */
+    integer   *element;     /* dim vertices per element                       */
+    integer    nx, ny, nz;  /* number of nodes of the distance grid           */
+    real       min[3];      /* first node of the distance grid                */
+    real       h;           /* node spacing                                   */
+    real      *dist;        /* signed distance at the nodes                   */
+    real      *normal;      /* 3 components of the wall normal at the nodes   */
+    wallTable  small;       /* tables for the small radius                    */
+    wallTable  large;       /* tables for the large radius                    */
+    real      *pd;          /* wall distance of each particle                 */
+    real      *pn;          /* 3 components of the wall normal per particle   */
+    integer    capacity;    /* number of particles of pd and pn               */
+
+} wallModel;
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    makeWallModel                                                 *
+ * -------------------------------------------------------------------------- *
+ * description: creates the walls from a copy of the vertices and elements.   *
+ *              The distance grid and the tables are built afterwards.        *
+ * -------------------------------------------------------------------------- *
+ * input:  const integer  dim       // 2 for segments, 3 for triangles        *
+ *         const real    *vertex    // 3 coordinates per vertex               *
+ *         const integer  nvert     // number of vertices                     *
+ *         const integer *element   // dim vertex indices per element         *
+ *         const integer  nelem     // number of elements                     *
+ * -------------------------------------------------------------------------- *
+ * output: wallModel *self                                                    *
+ ******************************************************************************/
+wallModel *makeWallModel(const integer dim, const real *vertex,
+    const integer nvert, const integer *element, const integer nelem);
+
+/******************************************************************************
+ * Function:    freeWallModel                                                 *
+ * -------------------------------------------------------------------------- *
+ * description: deallocates the walls, the grid, the tables and the object.   *
+ * -------------------------------------------------------------------------- *
+ * input:  wallModel *self   // polygon walls                                 *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void freeWallModel(wallModel *self);
+
+/******************************************************************************
+ * PRECOMPUTATION                                                             *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    buildWallGrid                                                 *
+ * -------------------------------------------------------------------------- *
+ * description: samples the signed distance to the nearest element and the    *
+ *              wall normal on the nodes of spacing h covering [min, max].    *
+ *              Every node visits every element, which is done once per run.  *
+ * -------------------------------------------------------------------------- *
+ * input:  wallModel  *wall     // polygon walls                              *
+ *         const real  min[3]   // lower corner of the domain                 *
+ *         const real  max[3]   // upper corner of the domain                 *
+ *         const real  h        // node spacing, e.g. l0 / 2                  *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void buildWallGrid(wallModel *wall, const real min[3], const real max[3],
+    const real h);
+
+/******************************************************************************
+ * Function:    buildWallTables                                               *
+ * -------------------------------------------------------------------------- *
+ * description: tabulates Z and G over [0, re] for the small and the large    *
+ *              radius with the lattice spacing l0 of the parameters.         *
+ * -------------------------------------------------------------------------- *
+ * input:  wallModel    *wall    // polygon walls                             *
+ *         parameters   *par     // simulation parameters                     *
+ *         const integer nbins   // intervals of each table                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void buildWallTables(wallModel *wall, parameters *par, const integer nbins);
+
+/******************************************************************************
+ * WALL CONTRIBUTIONS                                                         *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    locateWalls                                                   *
+ * -------------------------------------------------------------------------- *
+ * description: interpolates the wall distance and normal of every particle   *
+ *              from the grid, after the particles moved.                     *
+ * -------------------------------------------------------------------------- *
+ * input:  wallModel  *wall        // polygon walls                           *
+ *         fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void locateWalls(wallModel *wall, fluid *particles, parameters *par);
+
+/******************************************************************************
+ * Function:    addWallDensity                                                *
+ * -------------------------------------------------------------------------- *
+ * description: adds Z(d) of the small and large radius to pndS and pndL,     *
+ *              after computePnd and locateWalls.                             *
+ * -------------------------------------------------------------------------- *
+ * input:  wallModel  *wall        // polygon walls                           *
+ *         fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void addWallDensity(wallModel *wall, fluid *particles, parameters *par);
+
+/******************************************************************************
+ * Function:    addWallSource                                                 *
+ * -------------------------------------------------------------------------- *
+ * description: adds the mirrored wall pressure term to the right-hand side   *
+ *              of the pressure Poisson equation of assemblePressurePoisson.  *
+ * -------------------------------------------------------------------------- *
+ * input:  wallModel   *wall        // polygon walls                          *
+ *         fluid       *particles   // fluid particles                        *
+ *         parameters  *par         // simulation parameters                  *
+ *         surfaceList *surf        // free-surface and interior lists        *
+ *         vector1D    *b           // right-hand side, one per interior      *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void addWallSource(wallModel *wall, fluid *particles, parameters *par,
+    surfaceList *surf, vector1D *b);
+
+/******************************************************************************
+ * Function:    computeWallPressure                                           *
+ * -------------------------------------------------------------------------- *
+ * description: computePressure with the walls: the equation of state in the  *
+ *              explicit mode (pndS already holds the wall), the assembly,    *
+ *              addWallSource and the solve in the implicit mode.             *
+ * -------------------------------------------------------------------------- *
+ * input:  wallModel    *wall        // polygon walls                         *
+ *         fluid        *particles   // fluid particles                       *
+ *         parameters   *par         // simulation parameters                 *
+ *         surfaceList  *surf        // free-surface and interior lists       *
+ *         solverConfig *cfg         // pressure solver                       *
+ * -------------------------------------------------------------------------- *
+ * output: integer                   // solver iterations, 0 if explicit      *
+ ******************************************************************************/
+integer computeWallPressure(wallModel *wall, fluid *particles,
+    parameters *par, surfaceList *surf, solverConfig *cfg);
+
+/******************************************************************************
+ * Function:    correctWallVelocity                                           *
+ * -------------------------------------------------------------------------- *
+ * description: adds the wall part of the pressure gradient to the velocity   *
+ *              and position, after correctVelocity and with the same         *
+ *              minimum neighbour pressure. It keeps the particles off the    *
+ *              walls. Every particle below par->np is moved: with a type     *
+ *              layout, it is given the fluid-only np, start[PARTICLE_WALL].  *
+ * -------------------------------------------------------------------------- *
+ * input:  wallModel  *wall        // polygon walls                           *
+ *         fluid      *particles   // fluid particles                         *
+ *         parameters *par         // simulation parameters                   *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void correctWallVelocity(wallModel *wall, fluid *particles, parameters *par);
+
+#endif
@@ -0,0 +1,199 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                                WEIGHT.C                                    *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * LIBRARIES:                                                                 *
+ ******************************************************************************/
+
+#include "weight.h"
+#include "cmps_include.h"
+
+#include <float.h>  /*smallest normal float*/
+#include <stdio.h>  /*input and output variable manipulation*/
+#include <stdlib.h> /*address and memory manipulation*/
+
+/******************************************************************************
+ * AUXILIARY FUNCTIONS                                                        *
+ ******************************************************************************/
+
+#if CMPS_X86_INSTR_SET >= CMPS_X86_AVX_VERSION
+/* 1/sqrt(q): float estimate, then y = y (1.5 - 0.5 q y^2) in double */
+static inline __m256d rsqrtNewton(const __m256d q)
+{
+    const __m256d y = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(q)));
+    const __m256d h = _mm256_mul_pd(_mm256_set1_pd(0.5), q);
+
+    return _mm256_mul_pd(y, _mm256_sub_pd(_mm256_set1_pd(1.5),
+        _mm256_mul_pd(h, _mm256_mul_pd(y, y))));
+}
+
+/* weights by four pairs with the reciprocal square root: the pairs done */
+static integer weightRsqrt(const weightFunction *wf, const real *q, real *w,
+    const integer n)
+{
+    integer k = 0;
+
+    const __m256d vre  = _mm256_set1_pd(wf->re);
+    const __m256d vre2 = _mm256_set1_pd(wf->re2);
+    const __m256d vmin = _mm256_set1_pd((real) FLT_MIN);
+    const __m256d one  = _mm256_set1_pd(1.0);
+    const __m256d two  = _mm256_set1_pd(2.0);
+
+    for (; k + 4 <= n; k += 4)
+    {
+        const __m256d vq   = _mm256_loadu_pd(q + k);
+        const __m256d y    = rsqrtNewton(vq);
+        const __m256d tiny = _mm256_cmp_pd(vq, vmin, _CMP_LT_OQ);
+
+        __m256d mask = _mm256_cmp_pd(vq, vre2, _CMP_LT_OQ);
+        __m256d v;
+
+        if (wf->kernel == WEIGHT_SPLINE)
+        {
+            /*s = 2 r / re with r = q / sqrt(q), and r = 0 below FLT_MIN
+              where the float rsqrt is infinite: the spline is 1 there*/
+            const __m256d r  = _mm256_andnot_pd(tiny, _mm256_mul_pd(vq, y));
+            const __m256d s  = _mm256_div_pd(_mm256_mul_pd(two, r), vre);
+            const __m256d s2 = _mm256_mul_pd(s, s);
+            const __m256d t  = _mm256_sub_pd(two, s);
+            const __m256d in = _mm256_add_pd(_mm256_sub_pd(one,
+                _mm256_mul_pd(_mm256_set1_pd(1.5), s2)),
+                _mm256_mul_pd(_mm256_set1_pd(0.75), _mm256_mul_pd(s2, s)));
+            const __m256d out = _mm256_mul_pd(_mm256_set1_pd(0.25),
+                _mm256_mul_pd(t, _mm256_mul_pd(t, t)));
+
+            v = _mm256_blendv_pd(out, in, _mm256_cmp_pd(s, one, _CMP_LT_OQ));
+        }
+        else
+        {
+            /*the standard kernel is singular at r = 0: zero there*/
+            mask = _mm256_andnot_pd(tiny, mask);
+            v    = _mm256_sub_pd(_mm256_mul_pd(vre, y), one);
+        }
+
+        _mm256_storeu_pd(w + k, _mm256_and_pd(mask, v));
+    }
+
+    return k;
+}
+#endif
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+weightFunction *makeWeightFunction(const weightKernel kernel,
+    const weightMethod method, const real re, const integer nbins)
+{
+    register integer k;
+
+    if (re <= 0.0)
+    {
+        printf ("ERROR: the effective radius must be positive\n");
+        exit (EXIT_FAILURE);
+    }
+
+    if (method == WEIGHT_TABLE && nbins < 2)
+    {
+        printf ("ERROR: the weight table needs at least two intervals\n");
+        exit (EXIT_FAILURE);
+    }
+
+    weightFunction *self = (weightFunction *) malloc(sizeof(weightFunction));
+
+    if (self == NULL)
+    {
+        printf ("ERROR: no free space in RAM to allocate the object\n");
+        exit (EXIT_FAILURE);
+    }
+
+    self->kernel = kernel;
+    self->method = method;
+    self->re     = re;
+    self->re2    = re * re;
+    self->nbins  = (method == WEIGHT_TABLE) ? nbins : 0;
+    self->scale  = (method == WEIGHT_TABLE) ? nbins / self->re2 : 0.0;
+    self->table  = NULL;
+
+    if (method == WEIGHT_TABLE)
+    {
+        self->table = (real *) malloc((nbins + 1) * sizeof(real));
+
+        if (self->table == NULL)
+        {
+            printf ("ERROR: no free space in RAM to allocate the table\n");
+            exit (EXIT_FAILURE);
+        }
+
+        for (k = 0; k <= nbins; k++)
+        {
+            self->table[k] = weightKernelSq(kernel, k * self->re2 / nbins, re);
+        }
+    }
+
+    return self;
+}
+
+void freeWeightFunction(weightFunction *self)
+{
+    free(self->table);
+    free(self);
+}
+
+/******************************************************************************
+ * BATCH EVALUATION                                                           *
+ ******************************************************************************/
+
+void weightBatch(const weightFunction *wf, const real *q, real *w,
+    const integer n)
+{
+    register integer k = 0;
+
+#if CMPS_X86_INSTR_SET >= CMPS_X86_AVX_VERSION
+    if (wf->method == WEIGHT_RSQRT && wf->kernel != WEIGHT_POLYNOMIAL)
+    {
+        k = weightRsqrt(wf, q, w, n);
+    }
+#endif
+
+    for (; k < n; k++)
+    {
+        w[k] = weightSq(wf, q[k]);
+    }
+}
+
+real weightSum(const weightFunction *wf, const real *q, const integer n)
+{
+    register integer k;
+
+    real w[WEIGHT_BLOCK];
+    real sum = 0.0;
+
+    for (k = 0; k < n; k += WEIGHT_BLOCK)
+    {
+        register integer m;
+
+        const integer len = (n - k < WEIGHT_BLOCK) ? n - k : WEIGHT_BLOCK;
+
+        weightBatch(wf, q + k, w, len);
+
+        for (m = 0; m < len; m++)
+        {
+            sum += w[m];
+        }
+    }
+
+    return sum;
+}
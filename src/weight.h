@@ -0,0 +1,265 @@
+/******************************************************************************
+ *                   MPS - MOVING PARTICLES SEMI-IMPLICIT                     *
+ *                                WEIGHT.H                                    *
+ ******************************************************************************
+ * Author: Almério José Venâncio Pains Soares Pamplona                        *
+ * E-mail: almeriopamplona@gmail.com                                          *
+ ******************************************************************************
+ * Creation date    : 19.10.2026                                              *
+ * Modification date: 19.10.2026                                              *
+ ******************************************************************************
+ * Copyright (c) Almério José Venâncio Pains Soares Pamplona                  *
+ *                                                                            *
+ * Distributed under the terms of the Apache 2 License.                       *
+ *                                                                            *
+ * The full license is in the file LICENSE, distributed with this software.   *
+ ******************************************************************************
+ * Description:                                                               *
+ *                                                                            *
+ * MPS weight functions evaluated from the squared distance q = r^2, zero     *
+ * outside 0 < r < re:                                                        *
+ *                                                                            *
+ *   WEIGHT_STANDARD     re/r - 1                                             *
+ *   WEIGHT_POLYNOMIAL   (1 - r^2/re^2)^3, which needs no square root         *
+ *   WEIGHT_SPLINE       cubic B-spline of s = 2r/re, 1 at r = 0:             *
+ *                       1 - 1.5 s^2 + 0.75 s^3 (s < 1), 0.25 (2 - s)^3       *
+ *                                                                            *
+ * and three ways to evaluate them:                                           *
+ *                                                                            *
+ *   WEIGHT_EXACT   closed form: a sqrt and a division per pair for the       *
+ *                  standard and spline kernels, a few products otherwise.    *
+ *   WEIGHT_TABLE   linear interpolation in q over nbins intervals of         *
+ *                  [0, re^2]: one product, one conversion and two loads,     *
+ *                  the same cost for every kernel. With 4096 intervals the   *
+ *                  error is about 5e-6 relative past r = 0.2 re. The         *
+ *                  standard kernel is singular at r = 0: its first interval  *
+ *                  is evaluated exactly, and the next ones lose accuracy     *
+ *                  (4e-2 at r = 0.02 re), where particles never are.         *
+ *   WEIGHT_RSQRT   batches only: the float reciprocal square root of the     *
+ *                  hardware (12 bits) refined by one Newton step in double,  *
+ *                  about 2e-7 relative on 1/r, four pairs per instruction    *
+ *                  with AVX. Without AVX it falls back to WEIGHT_EXACT.      *
+ *                                                                            *
+ * These errors are far below the discretisation error of the MPS operators,  *
+ * but they shift n0: the initial density must be computed with the same      *
+ * function. The table costs 8 (nbins + 1) bytes and stays in L1/L2 for the   *
+ * default size.                                                              *
+ *                                                                            *
+ * Two paths use the kernels. The MPS operators (pressure, prediction,        *
+ * correction, heat, small matrices and walls) always sum the scalar weight() *
+ * of the standard kernel from r on the cached distances, normalised by n0S,  *
+ * n0L and lambda. The pnd path, searchNeighboursWeight, feeds the squared    *
+ * distances of the search to weightSum; as the operators compare its pnd     *
+ * with n0S and n0L, it and computeInitialDensityWeight accept only           *
+ * WEIGHT_STANDARD, with any method. The polynomial and spline kernels are    *
+ * for weightBatch and weightSum on their own, with their lattice density     *
+ * from latticeDensity of neighbours.h: they never replace n0S, n0L or        *
+ * lambda.                                                                    *
+ *                                                                            *
+ ******************************************************************************/
+
+#ifndef __WEIGHT_H__
+#define __WEIGHT_H__
+
+#include "structures.h"
+
+#include <math.h>   /*mathematical functions*/
+
+/******************************************************************************
+ * TYPE DEFINITIONS                                                           *
+ ******************************************************************************/
+
+#define WEIGHT_BINS  4096  // default number of table intervals
+#define WEIGHT_BLOCK 128   // pairs per batch of weightSum
+
+typedef enum weightKernel
+{
+    WEIGHT_STANDARD   = 0,   /* re/r - 1                                      */
+    WEIGHT_POLYNOMIAL = 1,   /* (1 - r^2/re^2)^3                              */
+    WEIGHT_SPLINE     = 2    /* cubic B-spline of 2r/re                       */
+
+} weightKernel;
+
+typedef enum weightMethod
+{
+    WEIGHT_EXACT = 0,   /* closed form                                        */
+    WEIGHT_TABLE = 1,   /* linear interpolation in r^2                        */
+    WEIGHT_RSQRT = 2    /* hardware rsqrt and one Newton step in batches      */
+
+} weightMethod;
+
+typedef struct weightFunction
+{
+    weightKernel  kernel;   /* weight function                                */
+    weightMethod  method;   /* evaluation method                              */
+    real          re;       /* effective radius                               */
+    real          re2;      /* squared effective radius                       */
+    real          scale;    /* nbins / re^2                                   */
+    integer       nbins;    /* table intervals, 0 without table               */
+    real         *table;    /* weights at q = k re^2 / nbins, nbins + 1       */
+
+} weightFunction;
+
+/******************************************************************************
+ * SCALAR EVALUATION                                                          *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    weight                                                        *
+ * -------------------------------------------------------------------------- *
+ * description: MPS weight function w(r) = re/r - 1 for 0 < r < re, and zero  *
+ *              otherwise.                                                    *
+ * -------------------------------------------------------------------------- *
+ * input:  const real r    // distance between two particles                  *
+ *         const real re   // effective radius                                *
+ * -------------------------------------------------------------------------- *
+ * output: real            // weight                                          *
+ ******************************************************************************/
+static inline real weight(const real r, const real re)
+{
+    return (r > 0.0 && r < re) ? re / r - 1.0 : 0.0;
+}
+
+/******************************************************************************
+ * Function:    weightKernelSq                                                *
+ * -------------------------------------------------------------------------- *
+ * description: closed form of a kernel at the squared distance q.            *
+ * -------------------------------------------------------------------------- *
+ * input:  const weightKernel kernel   // weight function                     *
+ *         const real         q        // squared distance                    *
+ *         const real         re       // effective radius                    *
+ * -------------------------------------------------------------------------- *
+ * output: real                        // weight                              *
+ ******************************************************************************/
+static inline real weightKernelSq(const weightKernel kernel, const real q,
+    const real re)
+{
+    if (q <= 0.0 && kernel == WEIGHT_STANDARD)
+    {
+        return 0.0;
+    }
+
+    if (q >= re * re)
+    {
+        return 0.0;
+    }
+
+    if (kernel == WEIGHT_POLYNOMIAL)
+    {
+        const real t = 1.0 - q / (re * re);
+
+        return t * t * t;
+    }
+
+    const real r = sqrt(q);
+
+    if (kernel == WEIGHT_SPLINE)
+    {
+        const real s = 2.0 * r / re;
+
+        return (s < 1.0) ? 1.0 - 1.5 * s * s + 0.75 * s * s * s
+                         : 0.25 * (2.0 - s) * (2.0 - s) * (2.0 - s);
+    }
+
+    return re / r - 1.0;
+}
+
+/******************************************************************************
+ * Function:    weightSq                                                      *
+ * -------------------------------------------------------------------------- *
+ * description: weight at the squared distance q with the method of wf; the   *
+ *              scalar WEIGHT_RSQRT is the closed form.                       *
+ * -------------------------------------------------------------------------- *
+ * input:  const weightFunction *wf   // weight function                      *
+ *         const real            q    // squared distance                     *
+ * -------------------------------------------------------------------------- *
+ * output: real                       // weight                               *
+ ******************************************************************************/
+static inline real weightSq(const weightFunction *wf, const real q)
+{
+    if (wf->method != WEIGHT_TABLE || q >= wf->re2)
+    {
+        return weightKernelSq(wf->kernel, q, wf->re);
+    }
+
+    const real    x = q * wf->scale;
+
+    /*q just below re^2 can round x up to nbins: use the last interval*/
+    const integer k = ((integer) x < wf->nbins) ? (integer) x : wf->nbins - 1;
+
+    /*the singular first interval of the standard kernel*/
+    if (k == 0 && wf->kernel == WEIGHT_STANDARD)
+    {
+        return weightKernelSq(wf->kernel, q, wf->re);
+    }
+
+    const real t = x - (real) k;
+
+    return wf->table[k] + t * (wf->table[k + 1] - wf->table[k]);
+}
+
+/******************************************************************************
+ * CONSTRUCTORS AND DESTRUCTORS                                               *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    makeWeightFunction                                            *
+ * -------------------------------------------------------------------------- *
+ * description: creates a weight function of radius re; the table of nbins    *
+ *              intervals is only built for WEIGHT_TABLE.                     *
+ * -------------------------------------------------------------------------- *
+ * input:  const weightKernel kernel   // weight function                     *
+ *         const weightMethod method   // evaluation method                   *
+ *         const real         re       // effective radius                    *
+ *         const integer      nbins    // intervals, e.g. WEIGHT_BINS         *
+ * -------------------------------------------------------------------------- *
+ * output: weightFunction *self                                               *
+ ******************************************************************************/
+weightFunction *makeWeightFunction(const weightKernel kernel,
+    const weightMethod method, const real re, const integer nbins);
+
+/******************************************************************************
+ * Function:    freeWeightFunction                                            *
+ * -------------------------------------------------------------------------- *
+ * description: deallocates the table and the object.                         *
+ * -------------------------------------------------------------------------- *
+ * input:  weightFunction *self   // weight function                          *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void freeWeightFunction(weightFunction *self);
+
+/******************************************************************************
+ * BATCH EVALUATION                                                           *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Function:    weightBatch                                                   *
+ * -------------------------------------------------------------------------- *
+ * description: w[k] = weight at the squared distance q[k], for k < n.        *
+ * -------------------------------------------------------------------------- *
+ * input:  const weightFunction *wf   // weight function                      *
+ *         const real           *q    // squared distances                    *
+ *         real                 *w    // weights                              *
+ *         const integer         n    // number of pairs                      *
+ * -------------------------------------------------------------------------- *
+ * output: void                                                               *
+ ******************************************************************************/
+void weightBatch(const weightFunction *wf, const real *q, real *w,
+    const integer n);
+
+/******************************************************************************
+ * Function:    weightSum                                                     *
+ * -------------------------------------------------------------------------- *
+ * description: sum of the weights at the squared distances q[k], k < n,      *
+ *              e.g. the particle number density of one particle.             *
+ * -------------------------------------------------------------------------- *
+ * input:  const weightFunction *wf   // weight function                      *
+ *         const real           *q    // squared distances                    *
+ *         const integer         n    // number of pairs                      *
+ * -------------------------------------------------------------------------- *
+ * output: real                       // sum of the weights                   *
+ ******************************************************************************/
+real weightSum(const weightFunction *wf, const real *q, const integer n);
+
+#endif